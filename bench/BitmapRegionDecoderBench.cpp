@@ -9,6 +9,7 @@
 #include "CodecBenchPriv.h"
 #include "SkBitmap.h"
 #include "SkOSFile.h"
+#include "SkThreadUtils.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
         SkColorType colorType, uint32_t sampleSize, const SkIRect& subset)
@@ -45,3 +46,57 @@ void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
         SkAssertResult(fBRD->decodeRegion(&bm, nullptr, fSubset, fSampleSize, fColorType, false));
     }
 }
+
+BitmapRegionDecoderThreadsBench::BitmapRegionDecoderThreadsBench(const char* baseName,
+        sk_sp<SkData> encoded, SkColorType colorType, int threads)
+    : fBRD(nullptr)
+    , fData(std::move(encoded))
+    , fColorType(colorType)
+    , fThreads(threads)
+{
+    fName.printf("BRD_%s_%s_tiles_%dthreads", baseName, color_type_to_str(colorType), threads);
+}
+
+const char* BitmapRegionDecoderThreadsBench::onGetName() {
+    return fName.c_str();
+}
+
+bool BitmapRegionDecoderThreadsBench::isSuitableFor(Backend backend) {
+    return kNonRendering_Backend == backend;
+}
+
+void BitmapRegionDecoderThreadsBench::onDelayedSetup() {
+    fBRD.reset(SkBitmapRegionDecoder::Create(fData, SkBitmapRegionDecoder::kAndroidCodec_Strategy));
+
+    const int kTileSize = 512;
+    for (int y = 0; y < fBRD->height(); y += kTileSize) {
+        for (int x = 0; x < fBRD->width(); x += kTileSize) {
+            fTiles.push(SkIRect::MakeXYWH(x, y, kTileSize, kTileSize));
+        }
+    }
+}
+
+void BitmapRegionDecoderThreadsBench::DecodeTiles(void* ctx) {
+    auto bench = (BitmapRegionDecoderThreadsBench*)ctx;
+    for (int i = bench->fNextTile.fetch_add(1); i < bench->fTiles.count();
+             i = bench->fNextTile.fetch_add(1)) {
+        SkBitmap bm;
+        SkAssertResult(bench->fBRD->decodeRegion(&bm, nullptr, bench->fTiles[i], 1,
+                                                 bench->fColorType, false));
+    }
+}
+
+void BitmapRegionDecoderThreadsBench::onDraw(int n, SkCanvas* canvas) {
+    for (int i = 0; i < n; i++) {
+        fNextTile.store(0);
+        SkAutoTArray<SkAutoTDelete<SkThread>> threads(fThreads - 1);
+        for (int t = 0; t < fThreads - 1; t++) {
+            threads[t].reset(new SkThread(DecodeTiles, this));
+            threads[t]->start();
+        }
+        DecodeTiles(this);
+        for (int t = 0; t < fThreads - 1; t++) {
+            threads[t]->join();
+        }
+    }
+}
@@ -9,11 +9,13 @@
 #define BitmapRegionDecoderBench_DEFINED
 
 #include "Benchmark.h"
+#include "SkAtomics.h"
 #include "SkBitmapRegionDecoder.h"
 #include "SkData.h"
 #include "SkImageInfo.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 /**
  *  Benchmark Android's BitmapRegionDecoder for a particular colorType, sampleSize, and subset.
@@ -42,4 +44,32 @@ private:
     const SkIRect                                  fSubset;
     typedef Benchmark INHERITED;
 };
+
+/**
+ *  Benchmark decoding every 512x512 tile of an image with one shared BitmapRegionDecoder, split
+ *  across a given number of threads, to see how region decoding scales.
+ */
+class BitmapRegionDecoderThreadsBench : public Benchmark {
+public:
+    BitmapRegionDecoderThreadsBench(const char* basename, sk_sp<SkData> encoded,
+                                    SkColorType colorType, int threads);
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(int n, SkCanvas* canvas) override;
+    void onDelayedSetup() override;
+
+private:
+    static void DecodeTiles(void* bench);
+
+    SkString                                       fName;
+    SkAutoTDelete<SkBitmapRegionDecoder>           fBRD;
+    sk_sp<SkData>                                  fData;
+    const SkColorType                              fColorType;
+    const int                                      fThreads;
+    SkTDArray<SkIRect>                             fTiles;
+    SkAtomic<int>                                  fNextTile;
+    typedef Benchmark INHERITED;
+};
 #endif // BitmapRegionDecoderBench_DEFINED
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Measures the time from serialized bytes to the end of a picture's first playback, loading it
+// either with SkPicture::MakeFromData() or in place with SkPicture::MakeFromDataInPlace().
+// Playback goes to a canvas without pixels so that rasterization doesn't hide the load cost.
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+
+template <bool kInPlace>
+class PictureLoadBench : public Benchmark {
+public:
+    PictureLoadBench() {
+        fName.printf("picture_load_%s", kInPlace ? "in_place" : "copy");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kSize, kSize));
+
+        SkPaint paints[8];
+        for (int i = 0; i < 8; i++) {
+            paints[i].setAntiAlias(SkToBool(i & 1));
+            paints[i].setColor(0xFF000000 | (i * 0x1F3D5B));
+            paints[i].setStyle(i & 2 ? SkPaint::kStroke_Style : SkPaint::kFill_Style);
+            paints[i].setStrokeWidth(SkIntToScalar(i));
+            paints[i].setTextSize(SkIntToScalar(10 + i));
+        }
+
+        SkPath paths[16];
+        for (int i = 0; i < 16; i++) {
+            paths[i].moveTo(0, 0);
+            for (int j = 1; j <= 8; j++) {
+                paths[i].quadTo(SkIntToScalar(j * 7), SkIntToScalar((i + j) % 13 * 5),
+                                SkIntToScalar(j * 11), SkIntToScalar((i * j) % 17 * 3));
+            }
+            paths[i].close();
+        }
+
+        for (int i = 0; i < 2000; i++) {
+            SkScalar x = SkIntToScalar(i * 37 % kSize),
+                     y = SkIntToScalar(i * 53 % kSize);
+            const SkPaint& paint = paints[i % 8];
+            switch (i % 4) {
+                case 0:
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, 20, 10), paint);
+                    break;
+                case 1:
+                    canvas->save();
+                    canvas->translate(x, y);
+                    canvas->drawPath(paths[i % 16], paint);
+                    canvas->restore();
+                    break;
+                case 2:
+                    canvas->drawText("picture", 7, x, y, paint);
+                    break;
+                case 3:
+                    canvas->save();
+                    canvas->clipRect(SkRect::MakeXYWH(x, y, 50, 50));
+                    canvas->drawOval(SkRect::MakeXYWH(x, y, 60, 40), paint);
+                    canvas->restore();
+                    break;
+            }
+        }
+
+        fData = recorder.finishRecordingAsPicture()->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas canvas(kSize, kSize);
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> picture = kInPlace ? SkPicture::MakeFromDataInPlace(fData)
+                                                : SkPicture::MakeFromData(fData.get());
+            picture->playback(&canvas);
+        }
+    }
+
+private:
+    static const int kSize = 1024;
+
+    SkString      fName;
+    sk_sp<SkData> fData;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PictureLoadBench<false>;)
+DEF_BENCH(return new PictureLoadBench<true>;)
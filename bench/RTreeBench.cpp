@@ -16,6 +16,8 @@ static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
 static const int GRID_WIDTH = 100;
+static const int NUM_LARGE_RECTS = 100000;
+static const int NUM_TILES = 16;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
@@ -95,6 +97,63 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Time how long it takes to query a large R-Tree for every tile of a grid, either one tile at a
+// time or with all of them in one batchSearch().
+class RTreeTileQueryBench : public Benchmark {
+public:
+    RTreeTileQueryBench(const char* name, MakeRectProc proc, bool batch)
+        : fProc(proc), fBatch(batch) {
+        fName.printf("rtree_%s_tile_query_%s", name, batch ? "batch" : "each");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkAutoTMalloc<SkRect> rects(NUM_LARGE_RECTS);
+        for (int i = 0; i < NUM_LARGE_RECTS; ++i) {
+            rects[i] = fProc(rand, i, NUM_LARGE_RECTS);
+        }
+        fTree.insert(rects.get(), NUM_LARGE_RECTS);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        const int tilesPerRow = 4;
+        const SkScalar tileSize = GENERATE_EXTENTS / (2 * tilesPerRow);
+        for (int i = 0; i < loops; ++i) {
+            // A grid of tiles covering a quarter of the extents, at a random offset.
+            const SkScalar x = rand.nextRangeF(0, GENERATE_EXTENTS/2),
+                           y = rand.nextRangeF(0, GENERATE_EXTENTS/2);
+            SkRect tiles[NUM_TILES];
+            for (int t = 0; t < NUM_TILES; ++t) {
+                tiles[t] = SkRect::MakeXYWH(x + (t % tilesPerRow) * tileSize,
+                                            y + (t / tilesPerRow) * tileSize,
+                                            tileSize, tileSize);
+            }
+            SkTDArray<int> hits[NUM_TILES];
+            if (fBatch) {
+                fTree.batchSearch(tiles, NUM_TILES, hits);
+            } else {
+                for (int t = 0; t < NUM_TILES; ++t) {
+                    fTree.search(tiles[t], &hits[t]);
+                }
+            }
+        }
+    }
+private:
+    SkRTree fTree;
+    MakeRectProc fProc;
+    bool fBatch;
+    SkString fName;
+    typedef Benchmark INHERITED;
+};
+
 static inline SkRect make_XYordered_rects(SkRandom& rand, int index, int numRects) {
     SkRect out;
     out.fLeft   = SkIntToScalar(index % GRID_WIDTH);
@@ -136,3 +195,8 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeTileQueryBench("XY", &make_XYordered_rects, false));
+DEF_BENCH(return new RTreeTileQueryBench("XY", &make_XYordered_rects, true));
+DEF_BENCH(return new RTreeTileQueryBench("random", &make_random_rects, false));
+DEF_BENCH(return new RTreeTileQueryBench("random", &make_random_rects, true));
@@ -10,6 +10,8 @@
 #include "SkLiteDL.h"
 #include "SkLiteRecorder.h"
 #include "SkPictureRecorder.h"
+#include "SkRecordDraw.h"
+#include "SkRecordOpts.h"
 
 PictureCentricBench::PictureCentricBench(const char* name, const SkPicture* pic) : fName(name) {
     // Flatten the source picture in case it's trivially nested (useless for timing).
@@ -69,6 +71,35 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+RecordOptsBench::RecordOptsBench(const char* name, const SkPicture* pic, bool optimize)
+    : INHERITED(name, pic)
+    , fRecord(new SkRecord)
+{
+    fName.prepend(optimize ? "record_opts_" : "record_noopts_");
+
+    SkRecorder recorder(fRecord.get(), fSrc->cullRect());
+    fSrc->playback(&recorder);
+    fDrawables = recorder.detachDrawableList();
+
+    if (optimize) {
+        SkRecordOptimize2(fRecord.get());
+    }
+}
+
+bool RecordOptsBench::isSuitableFor(Backend backend) {
+    return backend != kNonRendering_Backend;
+}
+
+void RecordOptsBench::onDraw(int loops, SkCanvas* canvas) {
+    SkDrawable* const* drawables = fDrawables ? fDrawables->begin() : nullptr;
+    const int drawableCount = fDrawables ? fDrawables->count() : 0;
+    while (loops --> 0) {
+        SkRecordDraw(*fRecord, canvas, nullptr, drawables, drawableCount, nullptr, nullptr);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 #include "SkPipe.h"
 #include "SkStream.h"
 
@@ -11,6 +11,8 @@
 #include "Benchmark.h"
 #include "SkPicture.h"
 #include "SkLiteDL.h"
+#include "SkRecord.h"
+#include "SkRecorder.h"
 
 class PictureCentricBench : public Benchmark {
 public:
@@ -53,4 +55,24 @@ private:
     typedef PictureCentricBench INHERITED;
 };
 
+// Plays back an SkRecord of the picture, optionally run through SkRecordOptimize2() first, to
+// compare playback time with and without the experimental optimizations.
+class RecordOptsBench : public PictureCentricBench {
+public:
+    RecordOptsBench(const char* name, const SkPicture*, bool optimize);
+
+    // How many commands are left to play back.
+    int opCount() const { return fRecord->count(); }
+
+protected:
+    bool isSuitableFor(Backend) override;
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    sk_sp<SkRecord>                 fRecord;
+    std::unique_ptr<SkDrawableList> fDrawables;
+
+    typedef PictureCentricBench INHERITED;
+};
+
 #endif//RecordingBench_DEFINED
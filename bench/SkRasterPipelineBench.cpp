@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkOpts.h"
+#include "SkPM4f.h"
 #include "SkRasterPipeline.h"
 
 static const int N = 1023;
@@ -22,15 +23,17 @@ static uint8_t mask[N];  // 8-bit linear
 //   - src = srcover(dst, src)
 //   - store src back as srgb/f16
 
-template <bool kF16>
+template <bool kF16, bool kFused>
 class SkRasterPipelineBench : public Benchmark {
 public:
-    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
-    const char* onGetName() override {
-        return kF16 ? "SkRasterPipeline_f16"
-                    : "SkRasterPipeline_srgb";
+    SkRasterPipelineBench() {
+        fName.printf("SkRasterPipeline_%s%s", kF16   ? "f16" : "srgb",
+                                              kFused ? ""    : "_unfused");
     }
 
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
     void onDraw(int loops, SkCanvas*) override {
         void* mask_ctx = mask;
         void*  src_ctx = src;
@@ -44,6 +47,38 @@ public:
         p.append(SkRasterPipeline::srcover);
         p.append(kF16 ? SkRasterPipeline::store_f16
                       : SkRasterPipeline::store_srgb, &dst_ctx);
+        auto compiled = kFused ? p.compile() : p.compileUnfused();
+
+        while (loops --> 0) {
+            compiled(0, N);
+        }
+    }
+
+private:
+    SkString fName;
+};
+DEF_BENCH( return (new SkRasterPipelineBench<true,  true>); )
+DEF_BENCH( return (new SkRasterPipelineBench<false, true>); )
+DEF_BENCH( return (new SkRasterPipelineBench<true,  false>); )
+DEF_BENCH( return (new SkRasterPipelineBench<false, false>); )
+
+// The same pipeline on legacy 8888, which runs in low precision.
+class SkRasterPipelineLowpBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkRasterPipeline_8888_lowp"; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        void* mask_ctx = mask;
+        void*  src_ctx = src;
+        void*  dst_ctx = dst;
+
+        SkRasterPipeline p;
+        p.append(SkRasterPipeline::load_s_8888, &src_ctx);
+        p.append(SkRasterPipeline::scale_u8, &mask_ctx);
+        p.append(SkRasterPipeline::load_d_8888, &dst_ctx);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::store_8888, &dst_ctx);
         auto compiled = p.compile();
 
         while (loops --> 0) {
@@ -51,5 +86,120 @@ public:
         }
     }
 };
-DEF_BENCH( return new SkRasterPipelineBench<true>; )
-DEF_BENCH( return new SkRasterPipelineBench<false>; )
+DEF_BENCH( return new SkRasterPipelineLowpBench; )
+
+// The shortest pipelines, what SkRasterPipelineBlitter uses to blitH() a solid srcover color,
+// are where fusing stages matters most.
+template <bool kFused>
+class SkRasterPipelineSolidBench : public Benchmark {
+public:
+    SkRasterPipelineSolidBench() {
+        fName.printf("SkRasterPipeline_solid_srgb%s", kFused ? "" : "_unfused");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPM4f color = SkPM4f::From4f(Sk4f(0.5f, 0.25f, 0.0f, 0.5f));
+        void* dst_ctx = src;
+
+        SkRasterPipeline p;
+        p.append(SkRasterPipeline::constant_color, &color);
+        p.append(SkRasterPipeline::load_d_srgb, &dst_ctx);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::store_srgb, &dst_ctx);
+        auto compiled = kFused ? p.compile() : p.compileUnfused();
+
+        while (loops --> 0) {
+            compiled(0, N);
+        }
+    }
+
+private:
+    SkString fName;
+};
+DEF_BENCH( return new SkRasterPipelineSolidBench<true>; )
+DEF_BENCH( return new SkRasterPipelineSolidBench<false>; )
+
+// Measures each stock stage on its own, sandwiched between loading sRGB src and dst and storing
+// sRGB.  Compare against SkRasterPipeline_stage_baseline, the sandwich alone, for per-stage cost.
+class SkRasterPipelineStageBench : public Benchmark {
+public:
+    SkRasterPipelineStageBench(const char* name, int stage) : fStage(stage) {
+        fName.printf("SkRasterPipeline_stage_%s", name);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPM4f color    = SkPM4f::From4f(Sk4f(0.5f, 0.25f, 0.0f, 0.5f));
+        float  coverage = 0.5f;
+        void*  src_ctx  = src;
+        void*  dst_ctx  = dst;
+        void*  mask_ctx = mask;
+        int    y        = 0;
+
+        // Shader stages read r,g as coordinates; sRGB src puts those in [0,1].
+        const float matrix[20] = { 2,0,0,0, 0,2,0,0, 0,0,1,0, 0,0,0,1, 0,0,0,0 };
+        SkRasterPipeline::ImageCtx image = {
+            dst, N, N, 1, SkRasterPipeline::kClamp_TileMode, SkRasterPipeline::kRepeat_TileMode,
+        };
+        const float ts[] = { 0, 0.5f },
+                    fs[] = { 1,0,0,0, 0,1,0,0 },
+                    bs[] = { 0,0,0,1, 0,0,0,1 };
+        SkRasterPipeline::GradientCtx        gradient = { 2, ts, fs, bs };
+        SkRasterPipeline::TwoStopGradientCtx twoStops = { {1,0,0,0}, {0,0,0,1} };
+        SkRasterPipeline::TwoPointConicalCtx conical  = { 0,0,0.1f, 1,0,0.5f, false };
+
+        SkRasterPipeline p;
+        p.append(SkRasterPipeline::load_s_srgb, &src_ctx);
+        p.append(SkRasterPipeline::load_d_srgb, &dst_ctx);
+        if (fStage >= 0) {
+            using SkRP = SkRasterPipeline;
+            auto stage = (SkRP::StockStage)fStage;
+            switch (stage) {
+                case SkRP::constant_color:      p.append(stage, &color);    break;
+                case SkRP::lerp_constant_float:
+                case SkRP::scale_1_float:
+                case SkRP::clamp_x:  case SkRP::clamp_y:
+                case SkRP::repeat_x: case SkRP::repeat_y:
+                case SkRP::mirror_x: case SkRP::mirror_y:
+                                                p.append(stage, &coverage); break;
+                case SkRP::scale_u8:
+                case SkRP::lerp_u8:             p.append(stage, &mask_ctx); break;
+                case SkRP::seed_shader:         p.append(stage, &y);        break;
+                case SkRP::matrix_4x5:
+                case SkRP::matrix_2x3:
+                case SkRP::matrix_perspective:  p.append(stage, matrix);    break;
+                case SkRP::gather_8888:   case SkRP::gather_srgb:
+                case SkRP::gather_565:    case SkRP::gather_f16:
+                case SkRP::bilinear_8888: case SkRP::bilinear_srgb:
+                case SkRP::bilinear_565:  case SkRP::bilinear_f16:
+                case SkRP::bicubic_8888:  case SkRP::bicubic_srgb:
+                case SkRP::bicubic_565:   case SkRP::bicubic_f16:
+                                                p.append(stage, &image);    break;
+                case SkRP::gradient:            p.append(stage, &gradient); break;
+                case SkRP::gradient_2stops:     p.append(stage, &twoStops); break;
+                case SkRP::xy_to_2pt_conical:   p.append(stage, &conical);  break;
+                default:                        p.append(stage, &dst_ctx);  break;
+            }
+        }
+        p.append(SkRasterPipeline::store_srgb, &dst_ctx);
+        auto compiled = p.compileUnfused();
+
+        while (loops --> 0) {
+            compiled(0, N);
+        }
+    }
+
+private:
+    SkString fName;
+    int      fStage;
+};
+DEF_BENCH( return new SkRasterPipelineStageBench("baseline", -1); )
+#define M(stage) \
+    DEF_BENCH( return new SkRasterPipelineStageBench(#stage, SkRasterPipeline::stage); )
+    SK_RASTER_PIPELINE_STAGES(M)
+#undef M
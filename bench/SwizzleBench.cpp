@@ -26,6 +26,56 @@ private:
     SkOpts::Swizzle_8888 fFn;
 };
 
+class IndexSwizzleBench : public Benchmark {
+public:
+    IndexSwizzleBench() {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkOpts::index_to_8888"; }
+    void onDraw(int loops, SkCanvas*) override {
+        static const int K = 1023;
+        uint32_t dst[K], table[256];
+        uint8_t src[K];
+        for (int i = 0; i < K; i++) {
+            src[i] = (i * 37) & 0xFF;  // Scattered, so we don't just hit one cache line.
+        }
+        for (int i = 0; i < 256; i++) {
+            table[i] = i * 0x01010101;
+        }
+        while (loops --> 0) {
+            SkOpts::index_to_8888(dst, src, K, table);
+        }
+    }
+};
+
+class MaskSwizzleBench : public Benchmark {
+public:
+    MaskSwizzleBench(const char* name, SkOpts::Swizzle_masked fn, const uint32_t masks[4])
+        : fName(name), fFn(fn) {
+        memcpy(fMasks, masks, sizeof(fMasks));
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName; }
+    void onDraw(int loops, SkCanvas*) override {
+        static const int K = 1023;
+        uint32_t dst[K], src[K];  // Big enough for either 16- or 32-bit pixels.
+        for (int i = 0; i < K; i++) {
+            src[i] = i * 0x9E3779B9;  // Mix of bits, so every channel and alpha varies.
+        }
+        while (loops --> 0) {
+            fFn(dst, src, K, fMasks);
+        }
+    }
+private:
+    const char* fName;
+    SkOpts::Swizzle_masked fFn;
+    uint32_t fMasks[4];
+};
+
+static const uint32_t k1555[] = { 0x7C00, 0x03E0, 0x001F, 0x8000 };
+static const uint32_t k8888[] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 };
+
 
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_rgbA", SkOpts::RGBA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_bgrA", SkOpts::RGBA_to_bgrA));
@@ -37,3 +87,11 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+
+DEF_BENCH(return new IndexSwizzleBench);
+DEF_BENCH(return new MaskSwizzleBench("SkOpts::mask16_to_RGB1", SkOpts::mask16_to_RGB1, k1555));
+DEF_BENCH(return new MaskSwizzleBench("SkOpts::mask16_to_RGBA", SkOpts::mask16_to_RGBA, k1555));
+DEF_BENCH(return new MaskSwizzleBench("SkOpts::mask16_to_rgbA", SkOpts::mask16_to_rgbA, k1555));
+DEF_BENCH(return new MaskSwizzleBench("SkOpts::mask32_to_RGB1", SkOpts::mask32_to_RGB1, k8888));
+DEF_BENCH(return new MaskSwizzleBench("SkOpts::mask32_to_RGBA", SkOpts::mask32_to_RGBA, k8888));
+DEF_BENCH(return new MaskSwizzleBench("SkOpts::mask32_to_rgbA", SkOpts::mask32_to_rgbA, k8888));
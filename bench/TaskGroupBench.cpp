@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkAtomics.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+
+// Measures SkTaskGroup throughput for many tiny tasks, the kind of fan-out we do for tiles and
+// decodes.  These use whatever thread pool nanobench sets up, so to see how throughput scales
+// with core count, run with different --threads (e.g. --threads 1, 2, 4, ... 32).
+
+static void tiny_task(SkAtomic<int>* counter) {
+    counter->fetch_add(1, sk_memory_order_relaxed);
+}
+
+class TaskGroupBench : public Benchmark {
+public:
+    enum Mode {
+        kAdd_Mode,      // N calls to add() from the bench thread.
+        kBatch_Mode,    // One call to batch(N).
+        kNested_Mode,   // sqrt(N) tasks that each batch() sqrt(N) more and wait() for them.
+    };
+
+    TaskGroupBench(Mode mode, int tasks) : fMode(mode), fTasks(tasks) {
+        static const char* kNames[] = { "add", "batch", "nested" };
+        fName.printf("taskgroup_%s_%d", kNames[mode], tasks);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkAtomic<int> counter(0);
+        for (int loop = 0; loop < loops; loop++) {
+            SkTaskGroup tg;
+            switch (fMode) {
+                case kAdd_Mode:
+                    for (int i = 0; i < fTasks; i++) {
+                        tg.add([&] { tiny_task(&counter); });
+                    }
+                    break;
+                case kBatch_Mode:
+                    tg.batch(fTasks, [&](int) { tiny_task(&counter); });
+                    break;
+                case kNested_Mode: {
+                    int outer = 1;
+                    while (outer * outer < fTasks) { outer++; }
+                    tg.batch(outer, [&](int) {
+                        SkTaskGroup inner;
+                        inner.batch(fTasks / outer, [&](int) { tiny_task(&counter); });
+                        inner.wait();
+                    });
+                } break;
+            }
+            tg.wait();
+        }
+    }
+
+private:
+    Mode     fMode;
+    int      fTasks;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kAdd_Mode,     1000); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kAdd_Mode,    10000); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kBatch_Mode,   1000); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kBatch_Mode,  10000); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kNested_Mode,  1024); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kNested_Mode, 16384); )
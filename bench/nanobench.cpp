@@ -35,6 +35,7 @@
 #include "SkForceLinking.h"
 #include "SkGraphics.h"
 #include "SkLeanWindows.h"
+#include "SkMaskCache.h"
 #include "SkOSFile.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
@@ -113,6 +114,7 @@ DEFINE_string(zoom, "1.0,0", "Comma-separated zoomMax,zoomPeriodMs factors for a
                              "function that ping-pongs between 1.0 and zoomMax.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 DEFINE_bool(lite, false, "Use SkLiteRecorder in recording benchmarks?");
+DEFINE_bool(recordOpts, false, "Compare SKP playback with and without SkRecordOptimize2?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
 DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
@@ -584,6 +586,7 @@ public:
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
                       , fCurrentPiping(0)
+                      , fCurrentRecordOpts(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentSVG(0)
@@ -591,6 +594,8 @@ public:
                       , fCurrentCodec(0)
                       , fCurrentAndroidCodec(0)
                       , fCurrentBRDImage(0)
+                      , fCurrentBRDThreadsImage(0)
+                      , fCurrentBRDThreads(0)
                       , fCurrentColorImage(0)
                       , fCurrentColorType(0)
                       , fCurrentAlphaType(0)
@@ -743,6 +748,23 @@ public:
             return new PipingBench(name.c_str(), pic.get());
         }
 
+        // Add all .skps as RecordOptsBenches, unoptimized then optimized.
+        while (FLAGS_recordOpts && fCurrentRecordOpts < 2 * fSKPs.count()) {
+            const bool optimize = fCurrentRecordOpts % 2;
+            const SkString& path = fSKPs[fCurrentRecordOpts++ / 2];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            RecordOptsBench* bench = new RecordOptsBench(name.c_str(), pic.get(), optimize);
+            fSourceType = "skp";
+            fBenchType  = "record_opts";
+            fSKPBytes = static_cast<double>(SkPictureUtils::ApproximateBytesUsed(pic.get()));
+            fSKPOps   = bench->opCount();
+            return bench;
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -889,8 +911,9 @@ public:
             fCurrentColorType = 0;
         }
 
-        // Run AndroidCodecBenches
-        const int sampleSizes[] = { 2, 4, 8 };
+        // Run AndroidCodecBenches.  Besides the power of two scales, time a few that make
+        // typical thumbnails, which JPEG can't do in the DCT domain alone.
+        const int sampleSizes[] = { 2, 3, 4, 5, 8, 12 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
             fSourceType = "image";
             fBenchType = "skandroidcodec";
@@ -1005,6 +1028,36 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Decode every tile of each image through one BRD on more and more threads, to see
+        // how well region decoding scales.
+        const int brdThreadCounts[] = { 1, 2, 4, 8 };
+        for (; fCurrentBRDThreadsImage < fImages.count(); fCurrentBRDThreadsImage++) {
+            fSourceType = "image";
+            fBenchType = "BRD_threads";
+
+            const SkString& path = fImages[fCurrentBRDThreadsImage];
+            if (SkCommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+
+            while (fCurrentBRDThreads < (int) SK_ARRAY_COUNT(brdThreadCounts)) {
+                const int threads = brdThreadCounts[fCurrentBRDThreads++];
+
+                sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+                int width = 0;
+                int height = 0;
+                if (!valid_brd_bench(encoded, kN32_SkColorType, 1, minOutputSize,
+                                     &width, &height)) {
+                    break;
+                }
+
+                SkString basename = SkOSPath::Basename(path.c_str());
+                return new BitmapRegionDecoderThreadsBench(basename.c_str(), std::move(encoded),
+                                                           kN32_SkColorType, threads);
+            }
+            fCurrentBRDThreads = 0;
+        }
+
         while (fCurrentColorImage < fColorImages.count()) {
             fSourceType = "colorimage";
             fBenchType = "skcolorcodec";
@@ -1074,6 +1127,7 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
     int fCurrentPiping;
+    int fCurrentRecordOpts;
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentSVG;
@@ -1081,6 +1135,8 @@ private:
     int fCurrentCodec;
     int fCurrentAndroidCodec;
     int fCurrentBRDImage;
+    int fCurrentBRDThreadsImage;
+    int fCurrentBRDThreads;
     int fCurrentColorImage;
     int fCurrentColorType;
     int fCurrentAlphaType;
@@ -1200,6 +1256,12 @@ int nanobench_main() {
     if (FLAGS_analyticAA) {
         gSkUseAnalyticAA = true;
     }
+    if (FLAGS_parallelScan) {
+        gSkUseParallelScanConversion = true;
+    }
+    if (FLAGS_pathMaskCache) {
+        gSkUsePathMaskCache = true;
+    }
 
     int runs = 0;
     BenchmarkStream benchStream;
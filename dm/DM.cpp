@@ -17,11 +17,13 @@
 #include "SkColorSpace.h"
 #include "SkCommonFlags.h"
 #include "SkCommonFlagsConfig.h"
+#include "SkCoreBlitters.h"
 #include "SkData.h"
 #include "SkFontMgr.h"
 #include "SkGraphics.h"
 #include "SkHalf.h"
 #include "SkLeanWindows.h"
+#include "SkMaskCache.h"
 #include "SkMD5.h"
 #include "SkMutex.h"
 #include "SkOSFile.h"
@@ -76,6 +78,8 @@ DEFINE_int32(shard,  0, "Which shard do I run?");
 
 DEFINE_string(mskps, "", "Directory to read mskps from, or a single mskp file.");
 
+DEFINE_bool(forceRasterPipeline, false, "Use SkRasterPipeline blitters for legacy 8888 too.");
+
 using namespace DM;
 using sk_gpu_test::GrContextFactory;
 using sk_gpu_test::GLTestContext;
@@ -876,6 +880,7 @@ static Sink* create_sink(const SkCommandLineConfig* config) {
         SINK("8888", RasterSink, kN32_SkColorType);
         SINK("srgb", RasterSink, kN32_SkColorType, srgbColorSpace);
         SINK("f16",  RasterSink, kRGBA_F16_SkColorType, srgbLinearColorSpace);
+        SINK("threaded", ThreadedSink, kN32_SkColorType);
         SINK("pdf",  PDFSink);
         SINK("skp",  SKPSink);
         SINK("pipe", PipeSink);
@@ -1304,6 +1309,15 @@ int dm_main() {
     if (FLAGS_analyticAA) {
         gSkUseAnalyticAA = true;
     }
+    if (FLAGS_parallelScan) {
+        gSkUseParallelScanConversion = true;
+    }
+    if (FLAGS_pathMaskCache) {
+        gSkUsePathMaskCache = true;
+    }
+    if (FLAGS_forceRasterPipeline) {
+        gSkForceRasterPipelineBlitter = true;
+    }
 
     if (FLAGS_verbose) {
         gVLog = stderr;
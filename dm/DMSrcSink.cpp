@@ -1458,6 +1458,34 @@ Error RasterSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) con
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+ThreadedSink::ThreadedSink(SkColorType colorType, sk_sp<SkColorSpace> colorSpace)
+    : RasterSink(colorType, std::move(colorSpace)) {}
+
+Error ThreadedSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString*) const {
+    const SkISize size = src.size();
+    // If there's an appropriate alpha type for this color type, use it, otherwise use premul.
+    SkAlphaType alphaType = kPremul_SkAlphaType;
+    (void)SkColorTypeValidateAlphaType(fColorType, alphaType, &alphaType);
+
+    const SkImageInfo info = SkImageInfo::Make(size.width(), size.height(),
+                                               fColorType, alphaType, fColorSpace);
+    auto surface = SkSurface::MakeRasterThreaded(info);
+    if (!surface) {
+        return "Could not create threaded raster surface.";
+    }
+    Error err = src.draw(surface->getCanvas());
+    if (!err.isEmpty()) {
+        return err;
+    }
+    dst->allocPixels(info);
+    if (!surface->readPixels(info, dst->getPixels(), dst->rowBytes(), 0, 0)) {
+        return "Could not read pixels back from threaded raster surface.";
+    }
+    return "";
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
 // Handy for front-patching a Src.  Do whatever up-front work you need, then call draw_to_canvas(),
 // passing the Sink draw() arguments, a size, and a function draws into an SkCanvas.
 // Several examples below.
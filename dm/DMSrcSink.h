@@ -360,11 +360,19 @@ public:
     Error draw(const Src&, SkBitmap*, SkWStream*, SkString*) const override;
     const char* fileExtension() const override { return "png"; }
     SinkFlags flags() const override { return SinkFlags{ SinkFlags::kRaster, SinkFlags::kDirect }; }
-private:
+protected:
     SkColorType         fColorType;
     sk_sp<SkColorSpace> fColorSpace;
 };
 
+// Draws through SkSurface::MakeRasterThreaded(); should match RasterSink exactly.
+class ThreadedSink : public RasterSink {
+public:
+    explicit ThreadedSink(SkColorType, sk_sp<SkColorSpace> = nullptr);
+
+    Error draw(const Src&, SkBitmap*, SkWStream*, SkString*) const override;
+};
+
 class SKPSink : public Sink {
 public:
     SKPSink();
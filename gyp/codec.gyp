@@ -36,10 +36,12 @@
         '../src/codec/SkBmpRLECodec.cpp',
         '../src/codec/SkBmpStandardCodec.cpp',
         '../src/codec/SkCodec.cpp',
+        '../src/codec/SkCodecFrameCache.cpp',
         '../src/codec/SkGifCodec.cpp',
         '../src/codec/SkIcoCodec.cpp',
         '../src/codec/SkJpegCodec.cpp',
         '../src/codec/SkJpegDecoderMgr.cpp',
+        '../src/codec/SkJpegRestartIndex.cpp',
         '../src/codec/SkJpegUtility.cpp',
         '../src/codec/SkMaskSwizzler.cpp',
         '../src/codec/SkMasks.cpp',
@@ -28,6 +28,8 @@ public:
      * @param data     Refs the data while this object exists, unrefs on destruction
      * @param strategy Strategy used for scaling and subsetting
      * @return         Tries to create an SkBitmapRegionDecoder, returns NULL on failure
+     *
+     * Regions requested from several threads at once are decoded concurrently.
      */
     static SkBitmapRegionDecoder* Create(sk_sp<SkData>, Strategy strategy);
 
@@ -35,6 +37,9 @@ public:
      * @param stream   Takes ownership of the stream
      * @param strategy Strategy used for scaling and subsetting
      * @return         Tries to create an SkBitmapRegionDecoder, returns NULL on failure
+     *
+     * decodeRegion() may be called from several threads at once, but each call waits for
+     * the last to finish reading the stream.
      */
     static SkBitmapRegionDecoder* Create(
             SkStreamRewindable* stream, Strategy strategy);
@@ -56,6 +61,7 @@ public:
      * @param requireUnpremul If the image is not opaque, we will use this to determine the
      *                        alpha type to use.
      *
+     * This is safe to call from several threads at once.
      */
     virtual bool decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
                               const SkIRect& desiredSubset, int sampleSize,
@@ -81,6 +87,10 @@ protected:
     {}
 
 private:
+    // data, if not null, holds the same bytes as stream.
+    static SkBitmapRegionDecoder* Create(SkStreamRewindable* stream, sk_sp<SkData> data,
+                                         Strategy strategy);
+
     const int fWidth;
     const int fHeight;
 };
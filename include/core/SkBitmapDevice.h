@@ -159,6 +159,7 @@ private:
     friend class SkDeviceFilteredPaint;
 
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice;
 
     // used to change the backend's pixels (and possibly config/rowbytes)
     // but cannot change the width/height, so there should be no change to
@@ -29,20 +29,22 @@ public:
         kBGRA_8888_ColorFormat,
         kRGBA_F16_ColorFormat,
         kRGBA_F32_ColorFormat,
+        kRGB_888_ColorFormat,
     };
 
     /**
      *  Apply the color conversion to a |src| buffer, storing the output in the |dst| buffer.
      *
      *  F16 and F32 are only supported as dst color formats, and only when the dst color space
-     *  is linear.  This function will return false in unsupported cases.
+     *  is linear.  RGB_888 (three bytes per pixel, always opaque) is only supported as a src
+     *  color format.  This function will return false in unsupported cases.
      *
      *  @param dst            Stored in the format described by |dstColorFormat|
      *  @param src            Stored in the format described by |srcColorFormat|
      *  @param len            Number of pixels in the buffers
      *  @param dstColorFormat Describes color format of |dst|
      *  @param srcColorFormat Describes color format of |src|
-     *                        Must be kRGBA_8888 or kBGRA_8888
+     *                        Must be kRGBA_8888, kBGRA_8888, or kRGB_888
      *  @param alphaType      Describes alpha properties of the |dst| (and |src|)
      *                        kUnpremul preserves input alpha values
      *                        kPremul   performs a premultiplication and also preserves alpha values
@@ -23,6 +23,7 @@ class SkMatrix;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
+struct SkDevPathSource;
 struct SkDrawProcs;
 struct SkRect;
 class SkRRect;
@@ -122,6 +123,7 @@ public:
     static SkScalar ComputeResScaleForStroking(const SkMatrix& );
 private:
     void    drawDevMask(const SkMask& mask, const SkPaint&) const;
+    bool    drawCachedPathMask(const SkPath&, const SkPaint&, const SkMatrix&) const;
     void    drawBitmapAsMask(const SkBitmap&, const SkPaint&) const;
 
     void    drawPath(const SkPath&, const SkPaint&, const SkMatrix* preMatrix,
@@ -130,7 +132,8 @@ private:
 
     void drawLine(const SkPoint[2], const SkPaint&) const;
     void drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
-                     SkBlitter* customBlitter, bool doFill) const;
+                     SkBlitter* customBlitter, bool doFill,
+                     const SkDevPathSource* source = nullptr) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -153,6 +156,11 @@ public:
     const SkClipStack* fClipStack;  // optional, may be null
     SkBaseDevice*   fDevice;        // optional, may be null
 
+    // Optional, may be null.  If set, only pixels inside fDstClip are written.  Unlike clipping
+    // fRC, this leaves scan conversion untouched, so those pixels are exactly what they would be
+    // without it.
+    const SkIRect*  fDstClip;
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
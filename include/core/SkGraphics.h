@@ -113,6 +113,13 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Return how many times the raster backend has looked up the edges of a filled path in the
+     *  resource cache and found them (hit) or had to build them (miss).
+     */
+    static int GetEdgeCacheHitCount();
+    static int GetEdgeCacheMissCount();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -31,6 +31,14 @@ public:
      */
     virtual sk_sp<SkImage> makeFromData(SkData*, const SkIRect* subset);
     virtual sk_sp<SkImage> makeFromMemory(const void* data, size_t length, const SkIRect* subset);
+
+    /**
+     *  Return true if makeFromData() and makeFromMemory() may be called from several threads at
+     *  once.  SkPicture then makes its images in parallel (when SkTaskGroup is enabled).
+     *
+     *  The default implementation returns false, so the images are made one at a time.
+     */
+    virtual bool isThreadSafe() const { return false; }
 };
 
 #endif
@@ -19,6 +19,7 @@ class SkCanvas;
 class SkData;
 class SkImage;
 class SkImageDeserializer;
+class SkMemoryStream;
 class SkPath;
 class SkPictureData;
 class SkPixelSerializer;
@@ -79,6 +80,20 @@ public:
                                          SkImageDeserializer* = nullptr);
     static sk_sp<SkPicture> MakeFromData(const SkData* data, SkImageDeserializer* = nullptr);
 
+    /**
+     *  Like MakeFromData(), but rather than copying the picture's ops out of data, the returned
+     *  picture keeps a ref on data and plays them back from where they lie.  This pairs well
+     *  with SkData::MakeFromFileName(), which maps the file instead of reading it.
+     *
+     *  Nested pictures are not parsed until they are first played back, so those that playback
+     *  culls away are never loaded at all.  That needs the default image-deserializer: if one is
+     *  passed, nested pictures are loaded up front, since the returned picture can't keep it.
+     *
+     *  Pictures serialized before this was possible are copied as MakeFromData() would.
+     */
+    static sk_sp<SkPicture> MakeFromDataInPlace(sk_sp<SkData> data,
+                                                SkImageDeserializer* = nullptr);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -115,6 +130,13 @@ public:
     */
     virtual void playback(SkCanvas*, AbortCallback* = NULL) const = 0;
 
+    /** Like playback(), but skips the draws that SkPictureRecorder's kOcclusionCulling_RecordFlag
+        found hidden under later opaque draws.  Only call this with a canvas that draws with the
+        paints it is given: one that rewrites them (e.g. SkPaintFilterCanvas) could make those
+        later draws translucent.  Nested pictures are played back in full.
+    */
+    void playbackSkippingOccludedOps(SkCanvas*, AbortCallback* = NULL) const;
+
     /** Return a cull rect for this picture.
         Ops recorded into this picture that attempt to draw outside the cull might not be drawn.
      */
@@ -199,10 +221,14 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkFlatPicture;
+    friend class SkLazyPicture;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet* typefaces) const;
     static sk_sp<SkPicture> MakeFromStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*);
+    static sk_sp<SkPicture> MakeInPlace(SkMemoryStream*, SkImageDeserializer*,
+                                        SkTypefacePlayback*);
     friend class SkPictureData;
 
     virtual int numSlowPaths() const = 0;
@@ -225,10 +251,13 @@ private:
     // V48: Read and write extended SkTextBlobs.
     // V49: Gradients serialized as SkColor4f + SkColorSpace
     // V50: SkXfermode -> SkBlendMode
+    // V51: Keep every section 4-byte aligned, so pictures can be played back in place
+    // V52: Prefix each sub-picture with its size and a summary, so it can be loaded lazily
+    // V53: Serialize the BBH of pictures recorded with one
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 50;
+    static const uint32_t CURRENT_PICTURE_VERSION = 53;
 
     static_assert(MIN_PICTURE_VERSION <= 41,
                   "Remove kFontFileName and related code from SkFontDescriptor.cpp.");
@@ -251,7 +280,8 @@ private:
                                         SkReadBuffer* buffer);
 
     SkPictInfo createHeader() const;
-    SkPictureData* backport() const;
+    // If withBBH, also index the ops by their bounds, if we were recorded with a BBH.
+    SkPictureData* backport(bool withBBH = false) const;
 
     mutable uint32_t fUniqueID;
 };
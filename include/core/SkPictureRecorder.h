@@ -9,6 +9,7 @@
 #define SkPictureRecorder_DEFINED
 
 #include "../private/SkMiniRecorder.h"
+#include "../private/SkTemplates.h"
 #include "SkBBHFactory.h"
 #include "SkPicture.h"
 #include "SkRefCnt.h"
@@ -35,6 +36,14 @@ public:
         // If you call drawPicture() or drawDrawable() on the recording canvas, this flag forces
         // that object to playback its contents immediately rather than reffing the object.
         kPlaybackDrawPicture_RecordFlag     = 1 << 0,
+        // Find the draws that are completely covered by later opaque draws, so that
+        // SkPicture::playbackSkippingOccludedOps() can skip them.  This makes finishing the
+        // recording slower.
+        kOcclusionCulling_RecordFlag        = 1 << 1,
+        // Compare each picture finished with this flag against the last one, reusing its
+        // bounding box hierarchy if no op's bounds moved, or the whole recording if nothing
+        // changed at all.  See getDamageRect().  This makes finishing the recording slower.
+        kIncremental_RecordFlag             = 1 << 2,
     };
 
     enum FinishFlags {
@@ -99,6 +108,15 @@ public:
      */
     sk_sp<SkDrawable> finishRecordingAsDrawable(uint32_t endFlags = 0);
 
+    /**
+     *  After finishRecordingAsPicture() with kIncremental_RecordFlag, returns the area of the
+     *  cull rect whose drawing may differ from the previous picture finished that way, or the
+     *  whole cull rect if there was none or it was recorded with a different cull rect.  An
+     *  empty rect means the two pictures draw the same.  Callers can redraw just this area,
+     *  provided the previous picture's pixels are still around.
+     */
+    SkRect getDamageRect() const { return fDamageRect; }
+
 #ifdef SK_SUPPORT_LEGACY_PICTURE_PTR
     SkPicture* SK_WARN_UNUSED_RESULT endRecordingAsPicture() {
         return this->finishRecordingAsPicture().release();
@@ -124,6 +142,10 @@ private:
     friend class SkPictureRecorderReplayTester; // for unit testing
     void partialReplay(SkCanvas* canvas) const;
 
+    // Compare fRecord against the last incremental recording, set fDamageRect, and reuse what we
+    // can from that recording.  Returns true if fBBH already holds these bounds.
+    bool diffAgainstPrevious(const SkRect bounds[]);
+
     bool                   fActivelyRecording;
     uint32_t               fFlags;
     SkRect                 fCullRect;
@@ -132,6 +154,13 @@ private:
     sk_sp<SkRecord>        fRecord;
     SkMiniRecorder         fMiniRecorder;
 
+    // What we keep of the last recording finished as a picture with kIncremental_RecordFlag.
+    sk_sp<SkRecord>        fPrevRecord;
+    SkAutoTMalloc<SkRect>  fPrevBounds;
+    sk_sp<SkBBoxHierarchy> fPrevBBH;
+    SkRect                 fPrevCullRect;
+    SkRect                 fDamageRect;
+
     typedef SkNoncopyable INHERITED;
 };
 
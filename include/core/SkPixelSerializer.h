@@ -34,6 +34,14 @@ public:
      */
     SkData* encode(const SkPixmap& pixmap) { return this->onEncode(pixmap); }
 
+    /**
+     *  Return true if useEncodedData() and encode() may be called from several threads at once.
+     *  SkPicture::serialize() then encodes its images in parallel (when SkTaskGroup is enabled).
+     *
+     *  The default implementation returns false, so the images are encoded one at a time.
+     */
+    virtual bool isThreadSafe() const { return false; }
+
 protected:
     /**
      *  Return true if you want to serialize the encoded data, false if you want
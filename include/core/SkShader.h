@@ -16,11 +16,13 @@
 #include "SkPaint.h"
 #include "../gpu/GrColor.h"
 
+class SkArenaAlloc;
 class SkColorFilter;
 class SkColorSpace;
 class SkImage;
 class SkPath;
 class SkPicture;
+class SkRasterPipeline;
 class SkXfermode;
 class GrContext;
 class GrFragmentProcessor;
@@ -229,6 +231,19 @@ public:
      */
     size_t contextSize(const ContextRec&) const;
 
+    /**
+     *  Instead of a Context, append stages to the pipeline that compute this shader's
+     *  premultiplied color, starting from device-space pixel centers in r,g (seed_shader).
+     *  Any stage contexts are allocated from alloc, which must outlive the pipeline.
+     *  ctm and localM play the same roles as in ContextRec.
+     *
+     *  Returns false if this shader can't be drawn with SkRasterPipeline; the pipeline may have
+     *  had some stages appended anyway, so callers should discard it and use a Context.
+     */
+    bool appendStages(SkRasterPipeline*, SkColorSpace* dstColorSpace, SkArenaAlloc*,
+                      const SkMatrix& ctm, const SkPaint&,
+                      const SkMatrix* localM = nullptr) const;
+
 #ifdef SK_SUPPORT_LEGACY_SHADER_ISABITMAP
     /**
      *  Returns true if this shader is just a bitmap, and if not null, returns the bitmap,
@@ -495,6 +510,14 @@ protected:
     void flatten(SkWriteBuffer&) const override;
 
     bool computeTotalInverse(const ContextRec&, SkMatrix* totalInverse) const;
+    bool computeTotalInverse(const SkMatrix& ctm, const SkMatrix* localM,
+                             SkMatrix* totalInverse) const;
+
+    /**
+     *  Override this to support appendStages().  Base class impl returns false.
+     */
+    virtual bool onAppendStages(SkRasterPipeline*, SkColorSpace* dstColorSpace, SkArenaAlloc*,
+                                const SkMatrix& ctm, const SkPaint&, const SkMatrix* localM) const;
 
     /**
      *  Your subclass must also override contextSize() if it overrides onCreateContext().
@@ -69,6 +69,15 @@ public:
         return MakeRaster(info, 0, props);
     }
 
+    /**
+     *  Like MakeRaster(), but drawing into the surface's canvas is deferred: draws are binned
+     *  into tiles and rasterized in parallel (on SkTaskGroup threads, if enabled) when the pixels
+     *  are needed, e.g. by makeImageSnapshot(), readPixels(), or SkCanvas::flush().  The pixels
+     *  are identical to those MakeRaster() would produce.
+     */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo&,
+                                               const SkSurfaceProps* = nullptr);
+
     /**
      *  Helper version of NewRaster. It creates a SkImageInfo with the
      *  specified width and height, and populates the rest of info to match
@@ -139,6 +139,14 @@ public:
     void setPixelSerializer(sk_sp<SkPixelSerializer>);
     SkPixelSerializer* getPixelSerializer() const { return fPixelSerializer.get(); }
 
+    /**
+     *  Encode these images in parallel ahead of time, so that writeImage() can just write out
+     *  the results.  The bytes written are the same either way.  Call this after
+     *  setPixelSerializer(): a pixel-serializer that isn't thread-safe is left for writeImage()
+     *  to call one image at a time.
+     */
+    void encodeImages(const SkImage* const images[], int count);
+
 private:
     const uint32_t fFlags;
     SkFactorySet* fFactorySet;
@@ -150,6 +158,9 @@ private:
 
     // Only used if we do not have an fFactorySet
     SkTHashMap<SkString, uint32_t> fFlattenableDict;
+
+    // Results of encodeImages(), by image unique ID.  Values may be null if encoding failed.
+    SkTHashMap<uint32_t, sk_sp<SkData>> fEncodedImages;
 };
 
 #endif // SkWriteBuffer_DEFINED
@@ -42,6 +42,7 @@ private:
     };
 
     State fState;
+    SkPaint fPaint;  // The paint of the op in fBuffer, if any.
 
     template <size_t A, size_t B>
     struct Max { static const size_t val = A > B ? A : B; };
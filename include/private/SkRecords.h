@@ -138,6 +138,20 @@ private:
 
 #undef ACT_AS_PTR
 
+// A paint interned in the SkRecord (see SkRecord::internPaint()), shared with every other op there
+// that draws with an equal paint.  Like PODArray, it acts as a pointer but owns nothing.
+class SharedPaint {
+public:
+    SharedPaint() {}
+    SharedPaint(const SkPaint* ptr) : fPtr(ptr) { SkASSERT(fPtr); }
+    // Default copy and assign.
+
+    operator const SkPaint*() const { return fPtr; }
+    const SkPaint* operator->() const { return fPtr; }
+private:
+    const SkPaint* fPtr;
+};
+
 // SkPath::getBounds() isn't thread safe unless we precache the bounds in a singlethreaded context.
 // SkPath::cheapComputeDirection() is similar.
 // Recording is a convenient time to cache these, or we can delay it to between record and playback.
@@ -215,15 +229,15 @@ RECORD(ClipRegion, 0,
         SkRegion region;
         SkCanvas::ClipOp op);
 
-// While not strictly required, if you have an SkPaint, it's fastest to put it first.
+// While not strictly required, if you have a paint, it's fastest to put it first.
 RECORD(DrawArc, kDraw_Tag|kHasPaint_Tag,
-       SkPaint paint;
+       SharedPaint paint;
        SkRect oval;
        SkScalar startAngle;
        SkScalar sweepAngle;
        unsigned useCenter);
 RECORD(DrawDRRect, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkRRect outer;
         SkRRect inner);
 RECORD(DrawDrawable, kDraw_Tag,
@@ -258,12 +272,12 @@ RECORD(DrawImageNine, kDraw_Tag|kHasImage_Tag|kHasPaint_Tag,
         SkIRect center;
         SkRect dst);
 RECORD(DrawOval, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkRect oval);
 RECORD(DrawPaint, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint);
+        SharedPaint paint);
 RECORD(DrawPath, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PreCachedPath path);
 RECORD(DrawPicture, kDraw_Tag|kHasPaint_Tag,
         Optional<SkPaint> paint;
@@ -275,55 +289,55 @@ RECORD(DrawShadowedPicture, kDraw_Tag|kHasPaint_Tag,
         TypedMatrix matrix;
         const SkShadowParams& params);
 RECORD(DrawPoints, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkCanvas::PointMode mode;
         unsigned count;
         SkPoint* pts);
 RECORD(DrawPosText, kDraw_Tag|kHasText_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PODArray<char> text;
         size_t byteLength;
         PODArray<SkPoint> pos);
 RECORD(DrawPosTextH, kDraw_Tag|kHasText_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PODArray<char> text;
         unsigned byteLength;
         SkScalar y;
         PODArray<SkScalar> xpos);
 RECORD(DrawRRect, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkRRect rrect);
 RECORD(DrawRect, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkRect rect);
 RECORD(DrawRegion, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkRegion region);
 RECORD(DrawText, kDraw_Tag|kHasText_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PODArray<char> text;
         size_t byteLength;
         SkScalar x;
         SkScalar y);
 RECORD(DrawTextBlob, kDraw_Tag|kHasText_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         sk_sp<const SkTextBlob> blob;
         SkScalar x;
         SkScalar y);
 RECORD(DrawTextOnPath, kDraw_Tag|kHasText_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PODArray<char> text;
         size_t byteLength;
         PreCachedPath path;
         TypedMatrix matrix);
 RECORD(DrawTextRSXform, kDraw_Tag|kHasText_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PODArray<char> text;
         size_t byteLength;
         PODArray<SkRSXform> xforms;
         Optional<SkRect> cull);
 RECORD(DrawPatch, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         PODArray<SkPoint> cubics;
         PODArray<SkColor> colors;
         PODArray<SkPoint> texCoords;
@@ -338,7 +352,7 @@ RECORD(DrawAtlas, kDraw_Tag|kHasImage_Tag|kHasPaint_Tag,
         SkXfermode::Mode mode;
         Optional<SkRect> cull);
 RECORD(DrawVertices, kDraw_Tag|kHasPaint_Tag,
-        SkPaint paint;
+        SharedPaint paint;
         SkCanvas::VertexMode vmode;
         int vertexCount;
         PODArray<SkPoint> vertices;
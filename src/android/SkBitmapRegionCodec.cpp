@@ -11,14 +11,68 @@
 #include "SkCodecPriv.h"
 #include "SkPixelRef.h"
 
-SkBitmapRegionCodec::SkBitmapRegionCodec(SkAndroidCodec* codec)
+SkBitmapRegionCodec::SkBitmapRegionCodec(SkAndroidCodec* codec, sk_sp<SkData> data)
     : INHERITED(codec->getInfo().width(), codec->getInfo().height())
     , fCodec(codec)
+    , fData(std::move(data))
+    , fCodecBusy(false)
 {}
 
+SkBitmapRegionCodec::~SkBitmapRegionCodec() {
+    fIdleCodecs.deleteAll();
+}
+
+SkAndroidCodec* SkBitmapRegionCodec::acquireCodec() {
+    SkASSERT(fData);
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (!fCodecBusy) {
+            fCodecBusy = true;
+            return fCodec.get();
+        }
+        if (!fIdleCodecs.isEmpty()) {
+            SkAndroidCodec* codec;
+            fIdleCodecs.pop(&codec);
+            return codec;
+        }
+    }
+    // Every codec is busy, so make another.  This reads the header again, but that's cheap next
+    // to decoding a region, and we only pay for it once per concurrent decode.
+    return SkAndroidCodec::NewFromData(fData);
+}
+
+void SkBitmapRegionCodec::releaseCodec(SkAndroidCodec* codec) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (codec == fCodec.get()) {
+        fCodecBusy = false;
+    } else {
+        fIdleCodecs.push(codec);
+    }
+}
+
 bool SkBitmapRegionCodec::decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
         const SkIRect& desiredSubset, int sampleSize, SkColorType prefColorType,
         bool requireUnpremul) {
+    if (!fData) {
+        SkAutoMutexAcquire lock(fMutex);
+        return this->decodeRegion(fCodec.get(), bitmap, allocator, desiredSubset, sampleSize,
+                                  prefColorType, requireUnpremul);
+    }
+
+    SkAndroidCodec* codec = this->acquireCodec();
+    if (!codec) {
+        SkCodecPrintf("Error: Could not create codec.\n");
+        return false;
+    }
+    bool success = this->decodeRegion(codec, bitmap, allocator, desiredSubset, sampleSize,
+                                      prefColorType, requireUnpremul);
+    this->releaseCodec(codec);
+    return success;
+}
+
+bool SkBitmapRegionCodec::decodeRegion(SkAndroidCodec* codec, SkBitmap* bitmap,
+        SkBRDAllocator* allocator, const SkIRect& desiredSubset, int sampleSize,
+        SkColorType prefColorType, bool requireUnpremul) {
 
     // Fix the input sampleSize if necessary.
     if (sampleSize < 1) {
@@ -37,21 +91,21 @@ bool SkBitmapRegionCodec::decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocat
     int outX;
     int outY;
     SkIRect subset = desiredSubset;
-    SubsetType type = adjust_subset_rect(fCodec->getInfo().dimensions(), &subset, &outX, &outY);
+    SubsetType type = adjust_subset_rect(codec->getInfo().dimensions(), &subset, &outX, &outY);
     if (SubsetType::kOutside_SubsetType == type) {
         return false;
     }
 
     // Ask the codec for a scaled subset
-    if (!fCodec->getSupportedSubset(&subset)) {
+    if (!codec->getSupportedSubset(&subset)) {
         SkCodecPrintf("Error: Could not get subset.\n");
         return false;
     }
-    SkISize scaledSize = fCodec->getSampledSubsetDimensions(sampleSize, subset);
+    SkISize scaledSize = codec->getSampledSubsetDimensions(sampleSize, subset);
 
     // Create the image info for the decode
-    SkColorType dstColorType = fCodec->computeOutputColorType(prefColorType);
-    SkAlphaType dstAlphaType = fCodec->computeOutputAlphaType(requireUnpremul);
+    SkColorType dstColorType = codec->computeOutputColorType(prefColorType);
+    SkAlphaType dstAlphaType = codec->computeOutputAlphaType(requireUnpremul);
 
     // Enable legacy behavior to avoid any gamma correction.  Android's assets are
     // adjusted to expect a non-gamma correct premultiply.
@@ -119,7 +173,7 @@ bool SkBitmapRegionCodec::decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocat
     options.fZeroInitialized = zeroInit;
     void* dst = bitmap->getAddr(scaledOutX, scaledOutY);
 
-    SkCodec::Result result = fCodec->getAndroidPixels(decodeInfo, dst, bitmap->rowBytes(),
+    SkCodec::Result result = codec->getAndroidPixels(decodeInfo, dst, bitmap->rowBytes(),
             &options);
     if (SkCodec::kSuccess != result && SkCodec::kIncompleteInput != result) {
         SkCodecPrintf("Error: Could not get pixels.\n");
@@ -8,17 +8,26 @@
 #include "SkBitmap.h"
 #include "SkBitmapRegionDecoder.h"
 #include "SkAndroidCodec.h"
+#include "SkData.h"
+#include "SkMutex.h"
+#include "SkTDArray.h"
 
 /*
  * This class implements SkBitmapRegionDecoder using an SkAndroidCodec.
+ *
+ * A codec can only decode one region at a time.  When we have the encoded data, regions
+ * requested on several threads at once are decoded by separate codecs made from that data,
+ * which are kept around for later requests.  Otherwise requests take turns.
  */
 class SkBitmapRegionCodec : public SkBitmapRegionDecoder {
 public:
 
     /*
      * Takes ownership of pointer to codec
+     * @param data The codec's encoded data, or nullptr if only the codec's stream has it.
      */
-    SkBitmapRegionCodec(SkAndroidCodec* codec);
+    SkBitmapRegionCodec(SkAndroidCodec* codec, sk_sp<SkData> data = nullptr);
+    ~SkBitmapRegionCodec() override;
 
     bool decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
                       const SkIRect& desiredSubset, int sampleSize,
@@ -30,7 +39,22 @@ public:
 
 private:
 
+    bool decodeRegion(SkAndroidCodec*, SkBitmap* bitmap, SkBRDAllocator* allocator,
+                      const SkIRect& desiredSubset, int sampleSize,
+                      SkColorType colorType, bool requireUnpremul);
+
+    // Returns a codec no other thread is decoding with, or nullptr if we failed to make one.
+    // Requires fData.
+    SkAndroidCodec* acquireCodec();
+    void releaseCodec(SkAndroidCodec*);
+
+    // Answers queries about the image, and decodes whenever it's not busy.
     SkAutoTDelete<SkAndroidCodec> fCodec;
+    sk_sp<SkData>                 fData;
+
+    SkMutex                       fMutex;
+    bool                          fCodecBusy;   // Guarded by fMutex.
+    SkTDArray<SkAndroidCodec*>    fIdleCodecs;  // Guarded by fMutex.  We own these.
 
     typedef SkBitmapRegionDecoder INHERITED;
 
@@ -13,12 +13,17 @@
 
 SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
         sk_sp<SkData> data, Strategy strategy) {
-    return SkBitmapRegionDecoder::Create(new SkMemoryStream(data),
-            strategy);
+    SkMemoryStream* stream = new SkMemoryStream(data);
+    return Create(stream, std::move(data), strategy);
 }
 
 SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
         SkStreamRewindable* stream, Strategy strategy) {
+    return Create(stream, nullptr, strategy);
+}
+
+SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
+        SkStreamRewindable* stream, sk_sp<SkData> data, Strategy strategy) {
     SkAutoTDelete<SkStreamRewindable> streamDeleter(stream);
     switch (strategy) {
         case kAndroidCodec_Strategy: {
@@ -39,7 +44,7 @@ SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
                     return nullptr;
             }
 
-            return new SkBitmapRegionCodec(codec.release());
+            return new SkBitmapRegionCodec(codec.release(), std::move(data));
         }
         default:
             SkASSERT(false);
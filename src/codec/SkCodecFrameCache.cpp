@@ -0,0 +1,198 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodecFrameCache.h"
+#include "SkCodecPriv.h"
+
+SkCodecFrameCache::SkCodecFrameCache(SkCodec* codec, const SkImageInfo& dstInfo, int maxFrames)
+    : fCodec(codec)
+    , fInfo(dstInfo)
+    , fMaxFrames(SkTMax(maxFrames, 2))
+    , fFrameInfos(codec->getFrameInfo())
+    , fPrefetch(true)
+    , fUseCounter(0)
+    , fPrefetching(-1)
+    , fHitCount(0)
+    , fMissCount(0)
+    , fPrefetchCount(0)
+{
+    SkASSERT(dstInfo.dimensions() == codec->getInfo().dimensions());
+    SkASSERT(dstInfo.colorType() != kIndex_8_SkColorType);
+    if (fFrameInfos.empty()) {
+        // getFrameInfo() is empty for single-frame images.
+        fFrameInfos.push_back({ SkCodec::kNone, 0 });
+    }
+}
+
+SkCodecFrameCache::~SkCodecFrameCache() {
+    // A prefetch may still be using the codec and the cache.
+    fPrefetchTasks.wait();
+    fEntries.deleteAll();
+}
+
+SkCodecFrameCache::Entry* SkCodecFrameCache::find(int index) {
+    for (Entry* entry : fEntries) {
+        if (entry->fIndex == index) {
+            entry->fLastUse = ++fUseCounter;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+void SkCodecFrameCache::add(int index, const SkBitmap& bitmap) {
+    SkASSERT(!this->find(index));
+    if (fEntries.count() == fMaxFrames) {
+        // Evict the least recently used frame.  Since a frame is only ever decoded from a frame
+        // that was just used, this keeps the base of the next frame in a chain.
+        int victim = 0;
+        for (int i = 1; i < fEntries.count(); i++) {
+            if (fEntries[i]->fLastUse < fEntries[victim]->fLastUse) {
+                victim = i;
+            }
+        }
+        delete fEntries[victim];
+        fEntries.removeShuffle(victim);
+    }
+    fEntries.push(new Entry{ index, ++fUseCounter, bitmap });
+}
+
+SkCodec::Result SkCodecFrameCache::decode(int index, SkBitmap* dst) {
+    // Walk back through the required frames to the nearest one that is cached, or else to an
+    // independent frame.  chain ends up holding the frames to decode, latest first.
+    SkTDArray<int> chain;
+    SkBitmap prior;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (Entry* entry = this->find(index)) {
+            // Decoded by a prefetch while we waited for the codec.
+            *dst = entry->fBitmap;
+            return SkCodec::kSuccess;
+        }
+        for (int i = index; ; ) {
+            chain.push(i);
+            const size_t required = fFrameInfos[i].fRequiredFrame;
+            if (SkCodec::kNone == required) {
+                break;
+            }
+            SkASSERT(required < (size_t) i);
+            if (Entry* entry = this->find(SkToInt(required))) {
+                prior = entry->fBitmap;
+                break;
+            }
+            i = SkToInt(required);
+        }
+    }
+
+    // Decode forward from there, caching each frame so that the next can be blended onto it.
+    while (!chain.isEmpty()) {
+        int frame;
+        chain.pop(&frame);
+
+        SkBitmap bitmap;
+        if (!bitmap.tryAllocPixels(fInfo)) {
+            SkCodecPrintf("Error: Could not allocate frame %d.\n", frame);
+            return SkCodec::kInvalidParameters;
+        }
+        SkCodec::Options opts;
+        opts.fFrameIndex = frame;
+        opts.fHasPriorFrame = false;
+        if (!prior.isNull()) {
+            SkAssertResult(prior.readPixels(fInfo, bitmap.getPixels(), bitmap.rowBytes(), 0, 0));
+            opts.fHasPriorFrame = true;
+        }
+
+        const SkCodec::Result result = fCodec->getPixels(fInfo, bitmap.getPixels(),
+                                                         bitmap.rowBytes(), &opts, nullptr,
+                                                         nullptr);
+        bitmap.setImmutable();
+        if (SkCodec::kSuccess != result) {
+            if (SkCodec::kIncompleteInput == result && chain.isEmpty()) {
+                // The rest of the requested frame has been filled, so it can still be shown.
+                *dst = bitmap;
+            } else {
+                SkCodecPrintf("Error: Could not decode frame %d.\n", frame);
+            }
+            return result;
+        }
+
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            this->add(frame, bitmap);
+        }
+        prior = bitmap;
+    }
+
+    *dst = prior;
+    return SkCodec::kSuccess;
+}
+
+SkCodec::Result SkCodecFrameCache::getFrame(int index, SkBitmap* dst) {
+    if (index < 0 || index >= this->frameCount()) {
+        return SkCodec::kInvalidParameters;
+    }
+
+    SkCodec::Result result = SkCodec::kSuccess;
+    bool hit, prefetching;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry* entry = this->find(index);
+        if (entry) {
+            *dst = entry->fBitmap;
+        }
+        hit = entry != nullptr;
+        prefetching = fPrefetching == index;
+    }
+    if (!hit) {
+        // A prefetch of this frame that's still queued will be done sooner than we could decode
+        // it ourselves.  One that's already running holds fCodecMutex until it's done.
+        if (prefetching) {
+            fPrefetchTasks.wait();
+        }
+
+        SkAutoMutexAcquire lock(fCodecMutex);
+        {
+            SkAutoMutexAcquire cacheLock(fMutex);
+            hit = this->find(index) != nullptr;
+        }
+        result = this->decode(index, dst);
+    }
+    (hit ? fHitCount : fMissCount).fetch_add(1, std::memory_order_relaxed);
+    if (SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result) {
+        dst->lockPixels();
+    }
+
+    if (fPrefetch && this->frameCount() > 1) {
+        this->prefetch((index + 1) % this->frameCount());
+    }
+    return result;
+}
+
+void SkCodecFrameCache::prefetch(int index) {
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fPrefetching == index || this->find(index)) {
+            return;
+        }
+        fPrefetching = index;
+    }
+    fPrefetchTasks.add([this, index] {
+        SkAutoMutexAcquire lock(fCodecMutex);
+        bool cached;
+        {
+            SkAutoMutexAcquire cacheLock(fMutex);
+            fPrefetching = -1;
+            cached = this->find(index) != nullptr;
+        }
+        if (!cached) {
+            SkBitmap unused;
+            if (SkCodec::kSuccess == this->decode(index, &unused)) {
+                fPrefetchCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+}
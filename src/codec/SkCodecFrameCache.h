@@ -0,0 +1,113 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecFrameCache_DEFINED
+#define SkCodecFrameCache_DEFINED
+
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkMutex.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+ *  Plays back the frames of a multi-frame SkCodec while keeping a bounded set
+ *  of decoded frames around.
+ *
+ *  A frame that depends on a prior frame is decoded by blending it onto the
+ *  nearest cached frame in its chain of required frames, rather than decoding
+ *  the whole chain back to an independent frame. After each request, the frame
+ *  that follows is decoded ahead of time on an SkTaskGroup thread, so that
+ *  sequential playback costs at most one frame decode per frame.
+ *
+ *  getFrame() may be called from any thread, but only one client should use a
+ *  given SkCodecFrameCache.
+ */
+class SkCodecFrameCache : SkNoncopyable {
+public:
+    /**
+     *  Takes ownership of the codec. Frames are decoded to dstInfo, which must
+     *  match the codec's dimensions and must not be kIndex_8.
+     *
+     *  At most maxFrames decoded frames are kept; at least two are always
+     *  kept, so that a frame's required frame stays cached while the frame is
+     *  decoded from it.
+     */
+    SkCodecFrameCache(SkCodec*, const SkImageInfo& dstInfo, int maxFrames = 4);
+    ~SkCodecFrameCache();
+
+    /**
+     *  Number of frames in the image. A single-frame image has one frame.
+     */
+    int frameCount() const { return SkToInt(fFrameInfos.size()); }
+
+    const SkCodec::FrameInfo& frameInfo(int index) const { return fFrameInfos[index]; }
+
+    /**
+     *  Decode (or find in the cache) frame index and point dst at it.
+     *
+     *  On kSuccess and kIncompleteInput, dst is set to an immutable bitmap
+     *  with its pixels locked, which may share its pixels with the cache.
+     *  Only complete frames are cached.
+     */
+    SkCodec::Result getFrame(int index, SkBitmap* dst);
+
+    /**
+     *  Decode the frame after each frame requested by getFrame() ahead of
+     *  time. On by default. Without an SkTaskGroup::Enabler, prefetches run
+     *  inline at the end of getFrame().
+     */
+    void setPrefetch(bool prefetch) { fPrefetch = prefetch; }
+
+    // Calls to getFrame() which found their frame already decoded, and those which did not.
+    // Frames decoded only to serve as the base of a requested frame are not counted.
+    int hitCount() const { return fHitCount.load(std::memory_order_relaxed); }
+    int missCount() const { return fMissCount.load(std::memory_order_relaxed); }
+
+    // Frames decoded by the prefetcher before they were requested.
+    int prefetchCount() const { return fPrefetchCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        int      fIndex;
+        uint32_t fLastUse;
+        SkBitmap fBitmap;
+    };
+
+    // These must be called with fMutex held.
+    Entry* find(int index);
+    void add(int index, const SkBitmap&);
+
+    // This must be called with fCodecMutex held.
+    SkCodec::Result decode(int index, SkBitmap* dst);
+
+    void prefetch(int index);
+
+    SkAutoTDelete<SkCodec>          fCodec;
+    const SkImageInfo               fInfo;
+    const int                       fMaxFrames;
+    std::vector<SkCodec::FrameInfo> fFrameInfos;
+    bool                            fPrefetch;
+
+    SkMutex                         fCodecMutex;    // Held while decoding.
+    SkMutex                         fMutex;         // Always taken after fCodecMutex.
+    SkTDArray<Entry*>               fEntries;       // Guarded by fMutex.  We own these.
+    uint32_t                        fUseCounter;    // Guarded by fMutex.
+    int                             fPrefetching;   // Guarded by fMutex.  -1 if none is queued.
+
+    std::atomic<int>                fHitCount;
+    std::atomic<int>                fMissCount;
+    std::atomic<int>                fPrefetchCount;
+
+    SkTaskGroup                     fPrefetchTasks;
+};
+
+#endif // SkCodecFrameCache_DEFINED
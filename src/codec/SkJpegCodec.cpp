@@ -12,9 +12,12 @@
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
+#include <atomic>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "SkJpegUtility.h"
@@ -267,6 +270,7 @@ SkJpegCodec::SkJpegCodec(int width, int height, const SkEncodedInfo& info, SkStr
         sk_sp<SkData> iccData)
     : INHERITED(width, height, info, stream, std::move(colorSpace), origin)
     , fDecoderMgr(decoderMgr)
+    , fTriedRestartIndex(false)
     , fReadyState(decoderMgr->dinfo()->global_state)
     , fSwizzleSrcRow(nullptr)
     , fColorXformSrcRow(nullptr)
@@ -342,6 +346,7 @@ bool SkJpegCodec::onRewind() {
     }
     SkASSERT(nullptr != decoderMgr);
     fDecoderMgr.reset(decoderMgr);
+    fStripeStream.reset(nullptr);
 
     fSwizzler.reset(nullptr);
     fSwizzleSrcRow = nullptr;
@@ -420,7 +425,10 @@ bool SkJpegCodec::setOutputColorSpace(const SkImageInfo& dstInfo) {
             if (isCMYK) {
                 fDecoderMgr->dinfo()->out_color_space = JCS_CMYK;
             } else {
-                fDecoderMgr->dinfo()->out_color_space = JCS_EXT_RGBA;
+                // We can't xform in place to F16, so we'll decode into fColorXformSrcRow.  The
+                // xform reads packed RGB just as well, so there's no need for libjpeg-turbo to
+                // write out an alpha channel.
+                fDecoderMgr->dinfo()->out_color_space = JCS_RGB;
             }
             return true;
         default:
@@ -504,6 +512,11 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
         dstWidth = fSwizzler->swizzleWidth();
     }
 
+    // Without a swizzler, we color xform straight from the rows that libjpeg-turbo decodes.
+    const SkColorSpaceXform::ColorFormat xformSrcFormat =
+            (!fSwizzler && JCS_RGB == fDecoderMgr->dinfo()->out_color_space) ?
+            SkColorSpaceXform::kRGB_888_ColorFormat : SkColorSpaceXform::kRGBA_8888_ColorFormat;
+
     for (int y = 0; y < count; y++) {
         uint32_t lines = jpeg_read_scanlines(fDecoderMgr->dinfo(), &decodeDst, 1);
         size_t srcRowBytes = get_row_bytes(fDecoderMgr->dinfo());
@@ -518,8 +531,7 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
 
         if (this->colorXform()) {
             SkAssertResult(this->colorXform()->apply(select_xform_format(dstInfo.colorType()), dst,
-                    SkColorSpaceXform::kRGBA_8888_ColorFormat, swizzleDst, dstWidth,
-                    kOpaque_SkAlphaType));
+                    xformSrcFormat, swizzleDst, dstWidth, kOpaque_SkAlphaType));
             dst = SkTAddOffset<void>(dst, rowBytes);
         }
 
@@ -542,6 +554,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (this->decodeStripes(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -596,7 +612,7 @@ void SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     size_t xformBytes = 0;
     if (kRGBA_F16_SkColorType == dstInfo.colorType()) {
         SkASSERT(this->colorXform());
-        xformBytes = dstWidth * sizeof(uint32_t);
+        xformBytes = fSwizzler ? dstWidth * sizeof(uint32_t) : get_row_bytes(fDecoderMgr->dinfo());
     }
 
     size_t totalBytes = swizzleBytes + xformBytes;
@@ -725,6 +741,22 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
 }
 
 bool SkJpegCodec::onSkipScanlines(int count) {
+    // If we're skipping past whole stripes, start again from the stripe before the first row we
+    // want.  jpeg_skip_scanlines() takes care of the rest, reading that stripe just as it would
+    // have if we hadn't jumped ahead, so that chroma upsampling sees the same rows.
+    if (const SkJpegRestartIndex* index = this->restartIndex()) {
+        const jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+        const int stripeHeight = index->stripeHeight() * dinfo->scale_num / dinfo->scale_denom;
+        const int target = this->currScanline() + count;
+        const int stripe = target / stripeHeight - 1;
+        if (stripe > 0 && stripe * stripeHeight > this->currScanline()) {
+            if (!this->restartAtStripe(stripe)) {
+                return false;
+            }
+            count = target - stripe * stripeHeight;
+        }
+    }
+
     // Set the jump location for libjpeg errors
     if (setjmp(fDecoderMgr->getJmpBuf())) {
         return fDecoderMgr->returnFalse("onSkipScanlines");
@@ -733,6 +765,141 @@ bool SkJpegCodec::onSkipScanlines(int count) {
     return (uint32_t) count == jpeg_skip_scanlines(fDecoderMgr->dinfo(), count);
 }
 
+const SkJpegRestartIndex* SkJpegCodec::restartIndex() {
+    if (!fTriedRestartIndex) {
+        fTriedRestartIndex = true;
+        if (const void* encoded = this->stream()->getMemoryBase()) {
+            fRestartIndex.reset(SkJpegRestartIndex::Make(encoded, this->stream()->getLength()));
+        }
+    }
+    return fRestartIndex.get();
+}
+
+sk_sp<SkData> SkJpegCodec::getRestartIndex() {
+    const SkJpegRestartIndex* index = this->restartIndex();
+    return index ? index->serialize() : nullptr;
+}
+
+bool SkJpegCodec::setRestartIndex(const SkData& serialized) {
+    const void* encoded = this->stream()->getMemoryBase();
+    if (!encoded) {
+        return false;
+    }
+    SkJpegRestartIndex* index = SkJpegRestartIndex::MakeFromData(serialized, encoded,
+                                                                 this->stream()->getLength());
+    if (!index) {
+        return false;
+    }
+    fRestartIndex.reset(index);
+    fTriedRestartIndex = true;
+    return true;
+}
+
+bool SkJpegCodec::decodeStripes(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                const Options& options) {
+    const SkJpegRestartIndex* index = this->restartIndex();
+    if (!index) {
+        return false;
+    }
+
+    // Each task parses the header again and decodes a stripe it throws away, so make sure it
+    // has enough rows of its own to be worth that.
+    const int kMinRowsPerTask = 512;
+    const int stripesPerTask = SkTMax(1, kMinRowsPerTask / index->stripeHeight());
+    const int tasks = (index->stripeCount() + stripesPerTask - 1) / stripesPerTask;
+    if (tasks < 2) {
+        return false;
+    }
+
+    const unsigned int scaleNum   = fDecoderMgr->dinfo()->scale_num,
+                       scaleDenom = fDecoderMgr->dinfo()->scale_denom;
+    const int stripeHeight = index->stripeHeight() * scaleNum / scaleDenom;
+    const void* encoded = this->stream()->getMemoryBase();
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup().batch(tasks, [&](int task) {
+        const int first = task * stripesPerTask,
+                  count = SkTMin(stripesPerTask, index->stripeCount() - first);
+
+        // Decode a stripe more on either side, so that chroma upsampling at our edges sees the
+        // rows it would when decoding the whole image.
+        const int top    = SkTMax(first - 1, 0),
+                  bottom = SkTMin(first + count + 1, index->stripeCount());
+        sk_sp<SkData> stripes = index->makeStripes(encoded, top, bottom - top);
+        SkAutoTDelete<SkCodec> codec(NewFromStream(new SkMemoryStream(std::move(stripes))));
+        if (!codec) {
+            failed = true;
+            return;
+        }
+
+        // libjpeg-turbo rounds scaled dimensions up.
+        const int height = codec->getInfo().height();
+        const SkImageInfo stripeInfo =
+                dstInfo.makeWH(dstInfo.width(), (height * scaleNum + scaleDenom - 1) / scaleDenom);
+        if (kSuccess != codec->startScanlineDecode(stripeInfo, &options, nullptr, nullptr)) {
+            failed = true;
+            return;
+        }
+
+        SkAutoTMalloc<uint8_t> discard(stripeInfo.minRowBytes());
+        for (int y = 0; y < (first - top) * stripeHeight; y++) {
+            if (1 != codec->getScanlines(discard.get(), 1, 0)) {
+                failed = true;
+                return;
+            }
+        }
+
+        const int dstY = first * stripeHeight;
+        const int rows = SkTMin(count * stripeHeight, dstInfo.height() - dstY);
+        if (rows != codec->getScanlines(SkTAddOffset<void>(dst, dstY * rowBytes), rows,
+                                        rowBytes)) {
+            failed = true;
+        }
+    });
+    return !failed;
+}
+
+bool SkJpegCodec::restartAtStripe(int stripe) {
+    const SkJpegRestartIndex* index = this->restartIndex();
+    SkASSERT(index && 0 < stripe && stripe < index->stripeCount());
+
+    sk_sp<SkData> stripes = index->makeStripes(this->stream()->getMemoryBase(), stripe,
+                                               index->stripeCount() - stripe);
+    SkAutoTDelete<SkStream> stream(new SkMemoryStream(std::move(stripes)));
+    JpegDecoderMgr* decoderMgr = nullptr;
+    if (!ReadHeader(stream.get(), nullptr, &decoderMgr)) {
+        return false;
+    }
+    SkAutoTDelete<JpegDecoderMgr> mgr(decoderMgr);
+
+    if (setjmp(mgr->getJmpBuf())) {
+        return mgr->returnFalse("restartAtStripe");
+    }
+
+    // Decode just as we were.
+    const jpeg_decompress_struct* oldInfo = fDecoderMgr->dinfo();
+    jpeg_decompress_struct* dinfo = mgr->dinfo();
+    dinfo->out_color_space = oldInfo->out_color_space;
+    dinfo->dither_mode     = oldInfo->dither_mode;
+    dinfo->scale_num       = oldInfo->scale_num;
+    dinfo->scale_denom     = oldInfo->scale_denom;
+    if (!jpeg_start_decompress(dinfo)) {
+        return mgr->returnFalse("restartAtStripe");
+    }
+    if (const SkIRect* subset = this->options().fSubset) {
+        uint32_t startX = subset->x();
+        uint32_t width = subset->width();
+        jpeg_crop_scanline(dinfo, &startX, &width);
+    }
+    if (dinfo->output_width != oldInfo->output_width) {
+        return mgr->returnFalse("restartAtStripe");
+    }
+
+    fDecoderMgr.reset(mgr.release());
+    fStripeStream.reset(stream.release());
+    return true;
+}
+
 static bool is_yuv_supported(jpeg_decompress_struct* dinfo) {
     // Scaling is not supported in raw data mode.
     SkASSERT(dinfo->scale_num == dinfo->scale_denom);
@@ -12,6 +12,7 @@
 #include "SkColorSpace.h"
 #include "SkColorSpaceXform.h"
 #include "SkImageInfo.h"
+#include "SkJpegRestartIndex.h"
 #include "SkSwizzler.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
@@ -34,6 +35,19 @@ public:
      */
     static SkCodec* NewFromStream(SkStream*);
 
+    /*
+     * Returns the image's restart marker index, serialized so that it can be stored alongside
+     * the encoded data and handed to setRestartIndex() by a later codec.  Returns nullptr if
+     * the image can't be indexed (see SkJpegRestartIndex), or our stream isn't in memory.
+     */
+    sk_sp<SkData> getRestartIndex();
+
+    /*
+     * Use an index from getRestartIndex() for the same encoded data, instead of scanning the
+     * data for one.  Returns false, and scans later as usual, if the index doesn't fit.
+     */
+    bool setRestartIndex(const SkData& index);
+
 protected:
 
     /*
@@ -119,8 +133,24 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    /*
+     * Random access and parallel decoding, for images with a restart marker index.
+     */
+    // Returns nullptr if our stream has no memory base or the image can't be indexed.
+    const SkJpegRestartIndex* restartIndex();
+    // Decodes the whole image a few stripes at a time on SkTaskGroup.  Returns false if the
+    // image is too small to be worth it, or if any stripe failed, leaving the dst incomplete.
+    bool decodeStripes(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&);
+    // Replaces fDecoderMgr, mid scanline decode, with one that starts at the given stripe.
+    bool restartAtStripe(int stripe);
+
+    // Holds the stripes fDecoderMgr is reading after restartAtStripe().
+    SkAutoTDelete<SkStream>            fStripeStream;
     SkAutoTDelete<JpegDecoderMgr>      fDecoderMgr;
 
+    SkAutoTDelete<SkJpegRestartIndex>  fRestartIndex;
+    bool                               fTriedRestartIndex;
+
     // We will save the state of the decompress struct after reading the header.
     // This allows us to safely call onGetScaledDimensions() at any time.
     const int                          fReadyState;
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkJpegRestartIndex.h"
+#include "SkTemplates.h"
+
+// Marker codes, from the JPEG spec (ITU T.81, table B.1).
+static const uint8_t kSOF0 = 0xC0,   // Baseline.
+                     kSOF1 = 0xC1,   // Extended sequential, Huffman coded.
+                     kDHT  = 0xC4,
+                     kDAC  = 0xCC,
+                     kRST0 = 0xD0,
+                     kRST7 = 0xD7,
+                     kSOI  = 0xD8,
+                     kEOI  = 0xD9,
+                     kSOS  = 0xDA,
+                     kDRI  = 0xDD,
+                     kTEM  = 0x01;
+
+static uint32_t get_be16(const uint8_t* data) {
+    return (data[0] << 8) | data[1];
+}
+
+static bool is_rst(uint8_t marker) {
+    return kRST0 <= marker && marker <= kRST7;
+}
+
+SkJpegRestartIndex* SkJpegRestartIndex::Make(const void* encoded, size_t size) {
+    const uint8_t* data = (const uint8_t*) encoded;
+    if (size < 4 || size > SK_MaxU32 || 0xFF != data[0] || kSOI != data[1]) {
+        return nullptr;
+    }
+
+    // Walk the segments up to the start of the scan.
+    size_t pos = 2;
+    size_t heightOffset = 0;
+    int width = 0, height = 0, components = 0, maxH = 0, maxV = 0;
+    uint32_t restartInterval = 0;
+    for (;;) {
+        if (pos >= size || 0xFF != data[pos]) {
+            return nullptr;
+        }
+        while (pos < size && 0xFF == data[pos]) {
+            pos++;
+        }
+        if (pos + 3 > size) {
+            return nullptr;
+        }
+        const uint8_t marker = data[pos++];
+        if (is_rst(marker) || kSOI == marker || kEOI == marker || kTEM == marker) {
+            // None of these belong before the first scan.
+            return nullptr;
+        }
+        const size_t length = get_be16(data + pos);
+        if (length < 2 || pos + length > size) {
+            return nullptr;
+        }
+
+        if (kSOF0 == marker || kSOF1 == marker) {
+            if (length < 8 || 8 != data[pos + 2]) {
+                return nullptr;
+            }
+            heightOffset = pos + 3;
+            height = get_be16(data + pos + 3);
+            width  = get_be16(data + pos + 5);
+            components = data[pos + 7];
+            if (0 == height || 0 == width || 0 == components || length < 8u + 3 * components) {
+                return nullptr;
+            }
+            for (int i = 0; i < components; i++) {
+                const uint8_t sampling = data[pos + 8 + 3 * i + 1];
+                maxH = SkTMax(maxH, sampling >> 4);
+                maxV = SkTMax(maxV, sampling & 0xF);
+            }
+        } else if ((marker & 0xF0) == 0xC0 && kDHT != marker && kDAC != marker) {
+            // Progressive, lossless, hierarchical, or arithmetic coded.
+            return nullptr;
+        } else if (kDRI == marker) {
+            if (length < 4) {
+                return nullptr;
+            }
+            restartInterval = get_be16(data + pos + 2);
+        } else if (kSOS == marker) {
+            // We need a single scan holding every component, which must be the only one.
+            if (0 == heightOffset || data[pos + 2] != components) {
+                return nullptr;
+            }
+            pos += length;
+            break;
+        }
+        pos += length;
+    }
+
+    // A non-interleaved scan of one component codes one block per MCU.
+    if (1 == components) {
+        maxH = maxV = 1;
+    }
+    if (0 == restartInterval || maxH < 1 || maxH > 4 || maxV < 1 || maxV > 4) {
+        return nullptr;
+    }
+    const uint32_t mcuWidth  = 8 * maxH,
+                   mcuHeight = 8 * maxV,
+                   mcusPerRow = (width + mcuWidth - 1) / mcuWidth,
+                   mcuRows    = (height + mcuHeight - 1) / mcuHeight;
+    if (0 != restartInterval % mcusPerRow) {
+        return nullptr;
+    }
+    const uint32_t rowsPerInterval = restartInterval / mcusPerRow;
+    const uint32_t intervals = (mcuRows + rowsPerInterval - 1) / rowsPerInterval;
+
+    SkAutoTDelete<SkJpegRestartIndex> index(new SkJpegRestartIndex);
+    index->fEncodedSize  = SkToU32(size);
+    index->fHeaderSize   = SkToU32(pos);
+    index->fHeightOffset = SkToU32(heightOffset);
+    index->fHeight       = height;
+    index->fStripeHeight = rowsPerInterval * mcuHeight;
+
+    // Scan the entropy coded data for markers.  0xFF bytes in the data itself are followed by
+    // a stuffed zero, and markers may be preceded by any number of 0xFF fill bytes.
+    *index->fStarts.append() = SkToU32(pos);
+    for (;;) {
+        const uint8_t* ff = (const uint8_t*) memchr(data + pos, 0xFF, size - pos);
+        if (!ff) {
+            // Truncated.
+            return nullptr;
+        }
+        const size_t markerStart = ff - data;
+        pos = markerStart;
+        while (pos < size && 0xFF == data[pos]) {
+            pos++;
+        }
+        if (pos >= size) {
+            return nullptr;
+        }
+        const uint8_t marker = data[pos++];
+        if (0 == marker) {
+            continue;
+        }
+        if (is_rst(marker) || kEOI == marker) {
+            *index->fEnds.append() = SkToU32(markerStart);
+            if (kEOI == marker) {
+                break;
+            }
+            *index->fStarts.append() = SkToU32(pos);
+            continue;
+        }
+        // DNL, another scan, or something else we don't expect.
+        return nullptr;
+    }
+
+    if (SkToU32(index->fStarts.count()) != intervals) {
+        return nullptr;
+    }
+    return index.release();
+}
+
+namespace {
+    // Layout of a serialized index.  It's followed by the interval starts, then their ends.
+    struct SerializedHeader {
+        uint32_t fMagic;
+        uint32_t fVersion;
+        uint32_t fEncodedSize;
+        uint32_t fHeaderSize;
+        uint32_t fHeightOffset;
+        uint32_t fStripeHeight;
+        uint32_t fCount;
+    };
+    static const uint32_t kMagic   = SkSetFourByteTag('s', 'k', 'j', 'r');
+    static const uint32_t kVersion = 1;
+}
+
+sk_sp<SkData> SkJpegRestartIndex::serialize() const {
+    const size_t arrayBytes = fStarts.count() * sizeof(uint32_t);
+    sk_sp<SkData> data = SkData::MakeUninitialized(sizeof(SerializedHeader) + 2 * arrayBytes);
+
+    SerializedHeader header = {
+        kMagic, kVersion, fEncodedSize, fHeaderSize, fHeightOffset,
+        SkToU32(fStripeHeight), SkToU32(fStarts.count()),
+    };
+    char* dst = (char*) data->writable_data();
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + sizeof(header), fStarts.begin(), arrayBytes);
+    memcpy(dst + sizeof(header) + arrayBytes, fEnds.begin(), arrayBytes);
+    return data;
+}
+
+SkJpegRestartIndex* SkJpegRestartIndex::MakeFromData(const SkData& serialized,
+                                                     const void* encoded, size_t size) {
+    SerializedHeader header;
+    if (serialized.size() < sizeof(header)) {
+        return nullptr;
+    }
+    memcpy(&header, serialized.data(), sizeof(header));
+    if (kMagic != header.fMagic || kVersion != header.fVersion || size != header.fEncodedSize ||
+        0 == header.fCount || header.fCount > size ||
+        serialized.size() != sizeof(header) + 2 * header.fCount * sizeof(uint32_t)) {
+        return nullptr;
+    }
+
+    SkAutoTDelete<SkJpegRestartIndex> index(new SkJpegRestartIndex);
+    index->fEncodedSize  = header.fEncodedSize;
+    index->fHeaderSize   = header.fHeaderSize;
+    index->fHeightOffset = header.fHeightOffset;
+    index->fStripeHeight = SkTMin<uint32_t>(header.fStripeHeight, 0xFFFF);
+    const uint32_t* arrays = SkTAddOffset<const uint32_t>(serialized.data(), sizeof(header));
+    index->fStarts.append(header.fCount, arrays);
+    index->fEnds  .append(header.fCount, arrays + header.fCount);
+
+    const uint8_t* data = (const uint8_t*) encoded;
+    if (index->fHeightOffset + 2 > index->fHeaderSize || index->fHeaderSize > size) {
+        return nullptr;
+    }
+    index->fHeight = get_be16(data + index->fHeightOffset);
+    if (!index->validate(data, size)) {
+        return nullptr;
+    }
+    return index.release();
+}
+
+bool SkJpegRestartIndex::validate(const uint8_t* data, size_t size) const {
+    if (fStripeHeight <= 0 || 0 != fStripeHeight % 8 ||
+        fStarts.count() != (fHeight + fStripeHeight - 1) / fStripeHeight ||
+        fStarts[0] != fHeaderSize) {
+        return false;
+    }
+    for (int i = 0; i < fStarts.count(); i++) {
+        // Each interval must end in a marker before the next begins.
+        const uint32_t next = (i + 1 < fStarts.count()) ? fStarts[i + 1] : SkToU32(size);
+        if (fStarts[i] > fEnds[i] || fEnds[i] >= next || next - fEnds[i] < 2 ||
+            0xFF != data[fEnds[i]]) {
+            return false;
+        }
+        if (i > 0 && !is_rst(data[fStarts[i] - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+sk_sp<SkData> SkJpegRestartIndex::makeStripes(const void* encoded, int first, int count) const {
+    SkASSERT(0 <= first && 0 < count && first + count <= fStarts.count());
+    const uint8_t* data = (const uint8_t*) encoded;
+
+    size_t size = fHeaderSize + 2 * count;
+    for (int i = first; i < first + count; i++) {
+        size += fEnds[i] - fStarts[i];
+    }
+    sk_sp<SkData> stripes = SkData::MakeUninitialized(size);
+    uint8_t* dst = (uint8_t*) stripes->writable_data();
+
+    // The header is unchanged but for the height of the image.
+    memcpy(dst, data, fHeaderSize);
+    const int height = SkTMin(count * fStripeHeight, fHeight - first * fStripeHeight);
+    dst[fHeightOffset + 0] = height >> 8;
+    dst[fHeightOffset + 1] = height & 0xFF;
+    dst += fHeaderSize;
+
+    // Restart markers count up from RST0 from the start of each scan, so renumber them.
+    for (int i = first; i < first + count; i++) {
+        if (i > first) {
+            *dst++ = 0xFF;
+            *dst++ = kRST0 + ((i - first - 1) & 7);
+        }
+        memcpy(dst, data + fStarts[i], fEnds[i] - fStarts[i]);
+        dst += fEnds[i] - fStarts[i];
+    }
+    *dst++ = 0xFF;
+    *dst++ = kEOI;
+    SkASSERT(dst == stripes->bytes() + size);
+    return stripes;
+}
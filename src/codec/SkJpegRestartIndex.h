@@ -0,0 +1,75 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegRestartIndex_DEFINED
+#define SkJpegRestartIndex_DEFINED
+
+#include "SkData.h"
+#include "SkTDArray.h"
+
+/*
+ * Records where each restart interval of a baseline jpeg's entropy coded data begins and ends.
+ *
+ * Decoding state (the DC predictions) is reset at every restart marker, so when each interval
+ * covers a whole number of MCU rows, the image can be cut into horizontal stripes that decode
+ * independently of one another.  Images without restart markers, or with intervals that end
+ * mid-row, can't be indexed.
+ */
+class SkJpegRestartIndex : SkNoncopyable {
+public:
+    /*
+     * Scans the encoded image for restart markers.  Returns nullptr unless it is a
+     * single-scan, Huffman coded jpeg that can be cut into stripes.
+     */
+    static SkJpegRestartIndex* Make(const void* encoded, size_t size);
+
+    /*
+     * Reads an index written by serialize() for the same encoded image.  Returns nullptr if
+     * it doesn't describe this image.
+     */
+    static SkJpegRestartIndex* MakeFromData(const SkData& index, const void* encoded,
+                                            size_t size);
+
+    /*
+     * Returns the index in a form that can be stored alongside the encoded image, and read back
+     * with MakeFromData() without scanning the image again.
+     */
+    sk_sp<SkData> serialize() const;
+
+    int stripeCount() const { return fStarts.count(); }
+
+    /*
+     * Rows per stripe at full size.  The last stripe may be shorter.  This is always a multiple
+     * of eight, so libjpeg-turbo's DCT scaling maps it to a whole number of rows.
+     */
+    int stripeHeight() const { return fStripeHeight; }
+
+    /*
+     * Returns a standalone jpeg of stripes [first, first + count) of the encoded image.
+     *
+     * Smooth chroma upsampling looks at the rows above and below, which the returned image
+     * doesn't have, so its first and last MCU rows may differ slightly from the same rows
+     * decoded as part of the whole image.  Callers wanting exact results should include a
+     * stripe on each side and throw its rows away.
+     */
+    sk_sp<SkData> makeStripes(const void* encoded, int first, int count) const;
+
+private:
+    SkJpegRestartIndex() {}
+
+    bool validate(const uint8_t* encoded, size_t size) const;
+
+    uint32_t            fEncodedSize;
+    uint32_t            fHeaderSize;     // Up to the end of the SOS segment.
+    uint32_t            fHeightOffset;   // Of the image height in the SOF segment.
+    int                 fHeight;
+    int                 fStripeHeight;
+    SkTDArray<uint32_t> fStarts;         // Where each interval's entropy coded data begins,
+    SkTDArray<uint32_t> fEnds;           // and where the marker ending it does.
+};
+
+#endif
@@ -379,6 +379,56 @@ static void swizzle_mask32_to_565(
     }
 }
 
+/*
+ *
+ * Choose an SkOpts swizzle for unsampled rows of 16 or 32 bit pixels to 8888, if there is one,
+ * and order the masks it will use to match the dst
+ *
+ */
+static SkOpts::Swizzle_masked choose_fast_proc(const SkImageInfo& dstInfo,
+        const SkImageInfo& srcInfo, const SkMasks* masks, uint32_t bitsPerPixel,
+        uint32_t fastMasks[4]) {
+    if (16 != bitsPerPixel && 32 != bitsPerPixel) {
+        return nullptr;
+    }
+
+    switch (dstInfo.colorType()) {
+        case kRGBA_8888_SkColorType:
+            fastMasks[0] = masks->getRedMask();
+            fastMasks[2] = masks->getBlueMask();
+            break;
+        case kBGRA_8888_SkColorType:
+            fastMasks[0] = masks->getBlueMask();
+            fastMasks[2] = masks->getRedMask();
+            break;
+        default:
+            return nullptr;
+    }
+    fastMasks[1] = masks->getGreenMask();
+    fastMasks[3] = masks->getAlphaMask();
+    for (int i = 0; i < 4; i++) {
+        // SkMasks treats the holes in a discontinuous mask as part of it.  Leave those rare
+        // masks to the row procs.
+        const uint32_t mask = fastMasks[i];
+        if ((mask + (mask & (0 - mask))) & mask) {
+            return nullptr;
+        }
+    }
+
+    const bool is16 = 16 == bitsPerPixel;
+    if (kOpaque_SkAlphaType == srcInfo.alphaType()) {
+        return is16 ? SkOpts::mask16_to_RGB1 : SkOpts::mask32_to_RGB1;
+    }
+    switch (dstInfo.alphaType()) {
+        case kUnpremul_SkAlphaType:
+            return is16 ? SkOpts::mask16_to_RGBA : SkOpts::mask32_to_RGBA;
+        case kPremul_SkAlphaType:
+            return is16 ? SkOpts::mask16_to_rgbA : SkOpts::mask32_to_rgbA;
+        default:
+            return nullptr;
+    }
+}
+
 /*
  *
  * Create a new mask swizzler
@@ -526,7 +576,12 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
         srcWidth = options.fSubset->width();
     }
 
-    return new SkMaskSwizzler(masks, proc, srcOffset, srcWidth);
+    uint32_t fastMasks[4];
+    SkOpts::Swizzle_masked fastProc = choose_fast_proc(dstInfo, srcInfo, masks, bitsPerPixel,
+                                                       fastMasks);
+
+    return new SkMaskSwizzler(masks, proc, fastProc, fastMasks, bitsPerPixel / 8, srcOffset,
+                              srcWidth);
 }
 
 /*
@@ -534,15 +589,23 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
  * Constructor for mask swizzler
  *
  */
-SkMaskSwizzler::SkMaskSwizzler(SkMasks* masks, RowProc proc, int srcOffset, int subsetWidth)
+SkMaskSwizzler::SkMaskSwizzler(SkMasks* masks, RowProc proc, SkOpts::Swizzle_masked fastProc,
+                               const uint32_t fastMasks[4], int srcBPP, int srcOffset,
+                               int subsetWidth)
     : fMasks(masks)
     , fRowProc(proc)
+    , fFastProc(fastProc)
+    , fSrcBPP(srcBPP)
     , fSubsetWidth(subsetWidth)
     , fDstWidth(subsetWidth)
     , fSampleX(1)
     , fSrcOffset(srcOffset)
     , fX0(srcOffset)
-{}
+{
+    if (fFastProc) {
+        memcpy(fFastMasks, fastMasks, sizeof(fFastMasks));
+    }
+}
 
 int SkMaskSwizzler::onSetSampleX(int sampleX) {
     // FIXME: Share this function with SkSwizzler?
@@ -564,5 +627,9 @@ int SkMaskSwizzler::onSetSampleX(int sampleX) {
  */
 void SkMaskSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
+    if (fFastProc && 1 == fSampleX) {
+        fFastProc((uint32_t*) dst, src + fX0 * fSrcBPP, fDstWidth, fFastMasks);
+        return;
+    }
     fRowProc(dst, src, fDstWidth, fMasks, fX0, fSampleX);
 }
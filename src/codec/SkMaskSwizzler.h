@@ -8,6 +8,7 @@
 #define SkMaskSwizzler_DEFINED
 
 #include "SkMasks.h"
+#include "SkOpts.h"
 #include "SkSampler.h"
 #include "SkSwizzler.h"
 #include "SkTypes.h"
@@ -53,13 +54,20 @@ private:
     typedef void (*RowProc)(void* dstRow, const uint8_t* srcRow, int width,
             SkMasks* masks, uint32_t startX, uint32_t sampleX);
 
-    SkMaskSwizzler(SkMasks* masks, RowProc proc, int subsetWidth, int srcOffset);
+    SkMaskSwizzler(SkMasks* masks, RowProc proc, SkOpts::Swizzle_masked fastProc,
+                   const uint32_t fastMasks[4], int srcBPP, int srcOffset, int subsetWidth);
 
     int onSetSampleX(int) override;
 
     SkMasks*        fMasks;           // unowned
     const RowProc   fRowProc;
 
+    // Used instead of fRowProc when we are not sampling, if there's an SkOpts swizzle for
+    // this conversion.  fFastMasks are the masks in the order it needs them.
+    const SkOpts::Swizzle_masked fFastProc;
+    uint32_t        fFastMasks[4];
+    const int       fSrcBPP;          // Bytes per pixel, used only with fFastProc.
+
     // FIXME: Can this class share more with SkSwizzler? These variables are all the same.
     const int       fSubsetWidth;     // Width of the subset of source before any sampling.
     int             fDstWidth;        // Width of dst, which may differ with sampling.
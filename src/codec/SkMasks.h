@@ -67,6 +67,22 @@ public:
         return fAlpha.mask;
      }
 
+    /*
+     *
+     * Getters for the color masks, after truncation to 8 bits
+     * These are used by the SkOpts swizzles
+     *
+     */
+     uint32_t getRedMask() const {
+        return fRed.mask;
+     }
+     uint32_t getGreenMask() const {
+        return fGreen.mask;
+     }
+     uint32_t getBlueMask() const {
+        return fBlue.mask;
+     }
+
 private:
 
     /*
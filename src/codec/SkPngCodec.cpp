@@ -435,19 +435,19 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
 }
 
 void SkPngCodec::applyXformRow(void* dst, const void* src) {
-    const SkColorSpaceXform::ColorFormat srcColorFormat = SkColorSpaceXform::kRGBA_8888_ColorFormat;
     switch (fXformMode) {
         case kSwizzleOnly_XformMode:
             fSwizzler->swizzle(dst, (const uint8_t*) src);
             break;
         case kColorOnly_XformMode:
-            SkAssertResult(this->colorXform()->apply(fXformColorFormat, dst, srcColorFormat, src,
-                    fXformWidth, fXformAlphaType));
+            SkAssertResult(this->colorXform()->apply(fXformColorFormat, dst, fXformSrcColorFormat,
+                    src, fXformWidth, fXformAlphaType));
             break;
         case kSwizzleColor_XformMode:
             fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            SkAssertResult(this->colorXform()->apply(fXformColorFormat, dst, srcColorFormat,
-                    fColorXformSrcRow, fXformWidth, fXformAlphaType));
+            SkAssertResult(this->colorXform()->apply(fXformColorFormat, dst,
+                    SkColorSpaceXform::kRGBA_8888_ColorFormat, fColorXformSrcRow, fXformWidth,
+                    fXformAlphaType));
             break;
     }
 }
@@ -1072,11 +1072,13 @@ bool SkPngCodec::initializeXforms(const SkImageInfo& dstInfo, const Options& opt
         return false;
     }
 
-    // If the image is RGBA and we have a color xform, we can skip the swizzler.
+    // If the image is RGB or RGBA and we have a color xform, we can skip the swizzler and xform
+    // straight from the rows libpng gives us.
     // FIXME (msarett):
-    // Support more input types to this->colorXform() (ex: RGB, Gray) and skip the swizzler more often.
-    if (this->colorXform() && SkEncodedInfo::kRGBA_Color == this->getEncodedInfo().color() &&
-        !options.fSubset)
+    // Support more input types to this->colorXform() (ex: Gray) and skip the swizzler more often.
+    const SkEncodedInfo::Color encodedColor = this->getEncodedInfo().color();
+    if (this->colorXform() && !options.fSubset && (SkEncodedInfo::kRGBA_Color == encodedColor ||
+                                                   SkEncodedInfo::kRGB_Color == encodedColor))
     {
         fXformMode = kColorOnly_XformMode;
         return true;
@@ -1099,6 +1101,10 @@ void SkPngCodec::initializeXformParams() {
     switch (fXformMode) {
         case kColorOnly_XformMode:
             fXformColorFormat = select_xform_format(this->dstInfo().colorType());
+            fXformSrcColorFormat =
+                    (SkEncodedInfo::kRGB_Color == this->getEncodedInfo().color()) ?
+                    SkColorSpaceXform::kRGB_888_ColorFormat :
+                    SkColorSpaceXform::kRGBA_8888_ColorFormat;
             fXformAlphaType = select_xform_alpha(this->dstInfo().alphaType(),
                                                  this->getInfo().alphaType());
             fXformWidth = this->dstInfo().width();
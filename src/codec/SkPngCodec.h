@@ -129,6 +129,7 @@ private:
 
     XformMode                      fXformMode;
     SkColorSpaceXform::ColorFormat fXformColorFormat;
+    SkColorSpaceXform::ColorFormat fXformSrcColorFormat;  // Used by kColorOnly.
     SkAlphaType                    fXformAlphaType;
     int                            fXformWidth;
 
@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkBitmapScaler.h"
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
 #include "SkMath.h"
@@ -83,6 +85,12 @@ SkCodec::Result SkSampledCodec::onGetAndroidPixels(const SkImageInfo& info, void
                     options.fColorPtr, options.fColorCount);
         }
 
+        // JPEGs can do most of the requested scale in the DCT domain, and resample the rest.
+        const SkCodec::Result result = this->dctScaledDecode(info, pixels, rowBytes, options);
+        if (SkCodec::kUnimplemented != result) {
+            return result;
+        }
+
         // If the native codec does not support the requested scale, scale by sampling.
         return this->sampledDecode(info, pixels, rowBytes, options);
     }
@@ -347,3 +355,48 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             return SkCodec::kUnimplemented;
     }
 }
+
+SkCodec::Result SkSampledCodec::dctScaledDecode(const SkImageInfo& info, void* pixels,
+        size_t rowBytes, const AndroidOptions& options) {
+    // SkBitmapScaler only resamples N32.
+    if (this->codec()->getEncodedFormat() != kJPEG_SkEncodedFormat ||
+            kN32_SkColorType != info.colorType() || options.fSampleSize <= 1 ||
+            info.dimensions() != this->getSampledDimensions(options.fSampleSize)) {
+        return SkCodec::kUnimplemented;
+    }
+
+    // libjpeg-turbo scales by n/8.  Find the smallest of those scales that still leaves us
+    // something to resample from.
+    SkISize nativeSize = this->codec()->getInfo().dimensions();
+    for (int num = 1; num < 8; num++) {
+        const SkISize size = this->codec()->getScaledDimensions(num / 8.0f);
+        if (size.width() >= info.width() && size.height() >= info.height()) {
+            nativeSize = size;
+            break;
+        }
+    }
+    SkASSERT(nativeSize != info.dimensions());
+
+    // If we can't afford the intermediate image, sampling does without one.
+    SkBitmap native;
+    if (!native.tryAllocPixels(info.makeWH(nativeSize.width(), nativeSize.height()))) {
+        return SkCodec::kUnimplemented;
+    }
+
+    // An incomplete image has been filled in by the codec, so it's still worth resampling.
+    const SkCodec::Result result = this->codec()->getPixels(native.info(), native.getPixels(),
+                                                            native.rowBytes());
+    if (SkCodec::kSuccess != result && SkCodec::kIncompleteInput != result) {
+        return result;
+    }
+
+    // The DCT scaling has already filtered most of the detail we're dropping, so the rest
+    // needs only a triangle filter.
+    SkPixmap src;
+    SkAssertResult(native.peekPixels(&src));
+    if (!SkBitmapScaler::Resize(SkPixmap(info, pixels, rowBytes), src,
+                                SkBitmapScaler::RESIZE_TRIANGLE)) {
+        return SkCodec::kInvalidParameters;
+    }
+    return result;
+}
@@ -55,6 +55,18 @@ private:
     SkCodec::Result sampledDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options);
 
+    /**
+     *  This fulfills the same contract as onGetAndroidPixels(), for JPEGs.
+     *
+     *  Rather than decoding every row at the closest scale libjpeg-turbo supports and
+     *  dropping pixels, we let libjpeg-turbo scale in the DCT domain to the smallest size
+     *  that is no smaller than info, and then resample that to info's dimensions.
+     *
+     *  Returns kUnimplemented if the decode should be done by sampledDecode() instead.
+     */
+    SkCodec::Result dctScaledDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
+            const AndroidOptions& options);
+
     typedef SkAndroidCodec INHERITED;
 };
 #endif // SkSampledCodec_DEFINED
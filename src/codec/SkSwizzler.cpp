@@ -124,6 +124,37 @@ static void swizzle_bit_to_n32(
     }
 }
 
+// Unpacks the indices of 1, 2 or 4 bit pixels a chunk at a time, and looks each chunk up in
+// ctable at once.
+static void unpack_and_lookup_small_index(
+        uint32_t* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src, int dstWidth,
+        int bpp, int offset, const SkPMColor ctable[]) {
+    const uint8_t mask = (1 << bpp) - 1;
+    uint8_t indices[256];
+    while (dstWidth > 0) {
+        const int count = SkTMin(dstWidth, (int) SK_ARRAY_COUNT(indices));
+        for (int x = 0; x < count; x++) {
+            indices[x] = (src[offset >> 3] >> (8 - bpp - (offset & 7))) & mask;
+            offset += bpp;
+        }
+        SkOpts::index_to_8888(dst, indices, count, ctable);
+        dst += count;
+        dstWidth -= count;
+    }
+}
+
+static void fast_swizzle_bit_to_n32(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
+        int bpp, int deltaSrc, int offset, const SkPMColor* /*ctable*/) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    static const SkPMColor kBlackWhite[] = { SK_ColorBLACK, SK_ColorWHITE };
+    unpack_and_lookup_small_index((uint32_t*) dstRow, src, dstWidth, bpp, offset, kBlackWhite);
+}
+
 #define RGB565_BLACK 0
 #define RGB565_WHITE 0xFFFF
 
@@ -215,6 +246,17 @@ static void swizzle_small_index_to_n32(
     }
 }
 
+static void fast_swizzle_small_index_to_n32(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
+        int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    unpack_and_lookup_small_index((uint32_t*) dstRow, src, dstWidth, bpp, offset, ctable);
+}
+
 // kIndex
 
 static void swizzle_index_to_n32(
@@ -230,6 +272,17 @@ static void swizzle_index_to_n32(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
+        int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index_to_8888((uint32_t*) dstRow, src + offset, dstWidth, ctable);
+}
+
 static void swizzle_index_to_n32_skipZ(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
         int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -690,6 +743,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                             case kRGBA_8888_SkColorType:
                             case kBGRA_8888_SkColorType:
                                 proc = &swizzle_bit_to_n32;
+                                fastProc = &fast_swizzle_bit_to_n32;
                                 break;
                             case kIndex_8_SkColorType:
                                 proc = &swizzle_bit_to_index;
@@ -767,6 +821,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                             case kRGBA_8888_SkColorType:
                             case kBGRA_8888_SkColorType:
                                 proc = &swizzle_small_index_to_n32;
+                                fastProc = &fast_swizzle_small_index_to_n32;
                                 break;
                             case kRGB_565_SkColorType:
                                 proc = &swizzle_small_index_to_565;
@@ -786,6 +841,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                                     proc = &swizzle_index_to_n32_skipZ;
                                 } else {
                                     proc = &swizzle_index_to_n32;
+                                    fastProc = &fast_swizzle_index_to_n32;
                                 }
                                 break;
                             case kRGB_565_SkColorType:
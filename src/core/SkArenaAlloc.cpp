@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+
+SkArenaAlloc::SkArenaAlloc(char* storage, size_t size, size_t minBlockSize)
+    : fStorage(storage)
+    , fStorageSize(size)
+    , fMinBlockSize(SkTMax<size_t>(minBlockSize, 64))
+    , fCursor(storage)
+    , fEnd(storage + size) {}
+
+void SkArenaAlloc::reset() {
+    for (Footer* footer = fDtors; footer; footer = footer->fPrev) {
+        footer->fDestroy(footer->fObj);
+    }
+    fDtors = nullptr;
+
+    while (fBlocks) {
+        Block* prev = fBlocks->fPrev;
+        sk_free(fBlocks);
+        fBlocks = prev;
+    }
+    fHeapBytes = 0;
+
+    fCursor = fStorage;
+    fEnd    = fStorage + fStorageSize;
+}
+
+void SkArenaAlloc::makeSpace(size_t size, size_t alignment) {
+    // Grow geometrically so long runs of small allocations don't hit malloc too often.
+    size_t blockSize = SkTMax(fMinBlockSize, fHeapBytes / 2);
+    blockSize = SkTMax(blockSize, sizeof(Block) + size + alignment);
+
+    auto block = (Block*)sk_malloc_throw(blockSize);
+    block->fPrev = fBlocks;
+    fBlocks = block;
+    fHeapBytes += blockSize;
+
+    fCursor = (char*)(block + 1);
+    fEnd    = (char*)block + blockSize;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkArenaAlloc_DEFINED
+#define SkArenaAlloc_DEFINED
+
+#include "SkTypes.h"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ *  SkArenaAlloc hands out memory from a list of blocks, and frees it all at once when it is
+ *  destroyed or reset().  Objects created with make() have their destructors called then too,
+ *  in reverse order of creation.  Objects that are trivially destructible cost nothing extra.
+ *
+ *  It can optionally start out using caller-provided storage (see SkSTArenaAlloc) before
+ *  going to the heap.
+ */
+class SkArenaAlloc : SkNoncopyable {
+public:
+    // Heap blocks will be at least minBlockSize bytes.
+    explicit SkArenaAlloc(size_t minBlockSize = 1024) : SkArenaAlloc(nullptr, 0, minBlockSize) {}
+    SkArenaAlloc(char* storage, size_t size, size_t minBlockSize = 1024);
+
+    ~SkArenaAlloc() { this->reset(); }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        if (std::is_trivially_destructible<T>::value) {
+            return new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+        // Allocate the destructor record first, so a throwing constructor can't leave it dangling.
+        auto footer = (Footer*)this->allocate(sizeof(Footer), alignof(Footer));
+        T* obj = new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        footer->fDestroy = [](void* ptr) { ((T*)ptr)->~T(); };
+        footer->fObj     = obj;
+        footer->fPrev    = fDtors;
+        fDtors = footer;
+        return obj;
+    }
+
+    // Allocates count default-initialized Ts.  T must be trivially destructible.
+    template <typename T>
+    T* makeArrayDefault(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "makeArrayDefault needs POD.");
+        T* array = (T*)this->allocate(sizeof(T) * count, alignof(T));
+        for (size_t i = 0; i < count; i++) {
+            new (&array[i]) T;
+        }
+        return array;
+    }
+
+    // Destroys everything made so far and returns memory to the state just after construction.
+    void reset();
+
+    // Approximate number of bytes we've allocated from the heap.
+    size_t approxBytesAllocated() const { return fHeapBytes; }
+
+private:
+    struct Footer {
+        void (*fDestroy)(void*);
+        void*   fObj;
+        Footer* fPrev;
+    };
+    struct Block {
+        Block* fPrev;
+    };
+
+    char* allocate(size_t size, size_t alignment) {
+        uintptr_t mask = alignment - 1;
+        char* ptr = (char*)(((uintptr_t)fCursor + mask) & ~mask);
+        if (!fCursor || ptr > fEnd || size > (size_t)(fEnd - ptr)) {
+            this->makeSpace(size, alignment);
+            ptr = (char*)(((uintptr_t)fCursor + mask) & ~mask);
+        }
+        fCursor = ptr + size;
+        return ptr;
+    }
+
+    void makeSpace(size_t size, size_t alignment);
+
+    char* const  fStorage;
+    const size_t fStorageSize;
+    const size_t fMinBlockSize;
+
+    char*   fCursor;
+    char*   fEnd;
+    Block*  fBlocks    = nullptr;
+    Footer* fDtors     = nullptr;
+    size_t  fHeapBytes = 0;
+};
+
+// SkArenaAlloc with kSize bytes of inline storage used before touching the heap.
+template <size_t kSize>
+class SkSTArenaAlloc : public SkArenaAlloc {
+public:
+    explicit SkSTArenaAlloc(size_t minBlockSize = 1024)
+        : SkArenaAlloc(fInline, kSize, minBlockSize) {}
+
+private:
+    char fInline[kSize];
+};
+
+#endif//SkArenaAlloc_DEFINED
@@ -31,6 +31,15 @@ public:
      */
     virtual void search(const SkRect& query, SkTDArray<int>* results) const = 0;
 
+    /**
+     * Like search(), but for N queries at once, populating results[i] for queries[i].
+     */
+    virtual void batchSearch(const SkRect queries[], int N, SkTDArray<int> results[]) const {
+        for (int i = 0; i < N; i++) {
+            this->search(queries[i], &results[i]);
+        }
+    }
+
     virtual size_t bytesUsed() const = 0;
 
     // Get the root bound.
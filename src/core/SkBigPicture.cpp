@@ -16,15 +16,22 @@ SkBigPicture::SkBigPicture(const SkRect& cull,
                            SkRecord* record,
                            SnapshotArray* drawablePicts,
                            SkBBoxHierarchy* bbh,
-                           size_t approxBytesUsedBySubPictures)
+                           size_t approxBytesUsedBySubPictures,
+                           SkTDArray<int>* occludedOps)
     : fCullRect(cull)
     , fApproxBytesUsedBySubPictures(approxBytesUsedBySubPictures)
     , fRecord(record)               // Take ownership of caller's ref.
     , fDrawablePicts(drawablePicts) // Take ownership.
     , fBBH(bbh)                     // Take ownership of caller's ref.
+    , fOccludedOps(occludedOps)     // Take ownership.
 {}
 
 void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    this->playback(canvas, callback, false);
+}
+
+void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback,
+                            bool skipOccludedOps) const {
     SkASSERT(canvas);
 
     // If the query contains the whole picture, don't bother with the BBH.
@@ -38,7 +45,8 @@ void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
                  nullptr,
                  this->drawableCount(),
                  useBBH ? fBBH.get() : nullptr,
-                 callback);
+                 callback,
+                 skipOccludedOps ? fOccludedOps.get() : nullptr);
 }
 
 void SkBigPicture::partialPlayback(SkCanvas* canvas,
@@ -67,6 +75,7 @@ int    SkBigPicture::approximateOpCount()   const { return fRecord->count(); }
 size_t SkBigPicture::approximateBytesUsed() const {
     size_t bytes = sizeof(*this) + fRecord->bytesUsed() + fApproxBytesUsedBySubPictures;
     if (fBBH) { bytes += fBBH->bytesUsed(); }
+    if (fOccludedOps) { bytes += sizeof(*fOccludedOps) + fOccludedOps->bytes(); }
     return bytes;
 }
 
@@ -11,6 +11,7 @@
 #include "SkOnce.h"
 #include "SkPicture.h"
 #include "SkRect.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 
 class SkBBoxHierarchy;
@@ -37,7 +38,8 @@ public:
                  SkRecord*,            // We take ownership of the caller's ref.
                  SnapshotArray*,       // We take exclusive ownership.
                  SkBBoxHierarchy*,     // We take ownership of the caller's ref.
-                 size_t approxBytesUsedBySubPictures);
+                 size_t approxBytesUsedBySubPictures,
+                 SkTDArray<int>* occludedOps = nullptr);  // We take exclusive ownership.
 
 
 // SkPicture overrides
@@ -48,6 +50,8 @@ public:
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
 
+// Used by SkPicture::playbackSkippingOccludedOps()
+    void playback(SkCanvas*, AbortCallback*, bool skipOccludedOps) const;
 // Used by GrLayerHoister
     void partialPlayback(SkCanvas*,
                          int start,
@@ -56,6 +60,9 @@ public:
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH; }
     const SkRecord*     record() const { return fRecord; }
+// Used by SkPicture::backport()
+    int drawableCount() const;
+    SkPicture const* const* drawablePicts() const;
 
 private:
     struct Analysis {
@@ -69,8 +76,6 @@ private:
 
     int numSlowPaths() const override;
     const Analysis& analysis() const;
-    int drawableCount() const;
-    SkPicture const* const* drawablePicts() const;
 
     const SkRect                          fCullRect;
     const size_t                          fApproxBytesUsedBySubPictures;
@@ -79,6 +84,7 @@ private:
     SkAutoTUnref<const SkRecord>          fRecord;
     SkAutoTDelete<const SnapshotArray>    fDrawablePicts;
     SkAutoTUnref<const SkBBoxHierarchy>   fBBH;
+    SkAutoTDelete<const SkTDArray<int>>   fOccludedOps;  // From SkRecordComputeOccludedOps().
 };
 
 #endif//SkBigPicture_DEFINED
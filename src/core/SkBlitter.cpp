@@ -64,6 +64,30 @@ void SkBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     }
 }
 
+void SkBlitter::blitSpans(const Span spans[], int count) {
+    // blitAntiH() wants a run and alpha slot for every pixel, which clipping blitters may split.
+    const int kMaxRun = 64;
+    int16_t runs[kMaxRun + 1];
+    SkAlpha aa[kMaxRun];
+
+    for (int i = 0; i < count; i++) {
+        const Span& span = spans[i];
+        if (span.fAlpha == 0xFF) {
+            this->blitH(span.fX, span.fY, span.fWidth);
+            continue;
+        }
+        for (int x = span.fX, left = span.fWidth; left > 0; ) {
+            int n = SkTMin(left, kMaxRun);
+            runs[0] = SkToS16(n);
+            runs[n] = 0;
+            aa[0]   = span.fAlpha;
+            this->blitAntiH(x, span.fY, aa, runs);
+            x    += n;
+            left -= n;
+        }
+    }
+}
+
 void SkBlitter::blitRect(int x, int y, int width, int height) {
     SkASSERT(width > 0);
     while (--height >= 0) {
@@ -258,6 +282,8 @@ void SkNullBlitter::blitAntiH(int x, int y, const SkAlpha antialias[],
 
 void SkNullBlitter::blitV(int x, int y, int height, SkAlpha alpha) {}
 
+void SkNullBlitter::blitSpans(const Span spans[], int count) {}
+
 void SkNullBlitter::blitRect(int x, int y, int width, int height) {}
 
 void SkNullBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {}
@@ -373,6 +399,32 @@ void SkRectClipBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     }
 }
 
+void SkRectClipBlitter::blitSpans(const Span spans[], int count) {
+    // Clip into a local batch, so fBlitter still sees one call per batch.
+    const int kMaxSpans = 64;
+    Span clipped[kMaxSpans];
+    int n = 0;
+
+    for (int i = 0; i < count; i++) {
+        const Span& span = spans[i];
+        if (!y_in_rect(span.fY, fClipRect)) {
+            continue;
+        }
+        int left  = SkTMax(span.fX, fClipRect.fLeft),
+            right = SkTMin(span.fX + span.fWidth, fClipRect.fRight);
+        if (left < right) {
+            clipped[n++] = { left, span.fY, right - left, span.fAlpha };
+            if (n == kMaxSpans) {
+                fBlitter->blitSpans(clipped, n);
+                n = 0;
+            }
+        }
+    }
+    if (n > 0) {
+        fBlitter->blitSpans(clipped, n);
+    }
+}
+
 void SkRectClipBlitter::blitRect(int left, int y, int width, int height) {
     SkIRect    r;
 
@@ -423,8 +475,33 @@ void SkRectClipBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     }
 }
 
+// Pairs that are wholly inside go to fBlitter's own blitAntiH2() / blitAntiV2(), which need not
+// blend exactly like their one pixel at a time fallbacks.
+void SkRectClipBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (!y_in_rect(y, fClipRect)) {
+        return;
+    }
+    if (x_in_rect(x, fClipRect) && x_in_rect(x + 1, fClipRect)) {
+        fBlitter->blitAntiH2(x, y, a0, a1);
+    } else {
+        this->SkBlitter::blitAntiH2(x, y, a0, a1);
+    }
+}
+
+void SkRectClipBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (!x_in_rect(x, fClipRect)) {
+        return;
+    }
+    if (y_in_rect(y, fClipRect) && y_in_rect(y + 1, fClipRect)) {
+        fBlitter->blitAntiV2(x, y, a0, a1);
+    } else {
+        this->SkBlitter::blitAntiV2(x, y, a0, a1);
+    }
+}
+
 const SkPixmap* SkRectClipBlitter::justAnOpaqueColor(uint32_t* value) {
-    return fBlitter->justAnOpaqueColor(value);
+    // Callers would write straight to the returned pixels, ignoring fClipRect.
+    return nullptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -858,7 +935,7 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
         p->setColor(0);
     }
 
-    if (SkBlitter* blitter = SkCreateRasterPipelineBlitter(device, *paint, allocator)) {
+    if (SkBlitter* blitter = SkCreateRasterPipelineBlitter(device, *paint, matrix, allocator)) {
         return blitter;
     }
 
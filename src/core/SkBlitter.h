@@ -50,6 +50,17 @@ public:
     /// Blit a vertical run of pixels with a constant alpha value.
     virtual void blitV(int x, int y, int height, SkAlpha alpha);
 
+    /// A horizontal run of width pixels, all with coverage alpha.
+    struct Span {
+        int     fX, fY, fWidth;
+        SkAlpha fAlpha;
+    };
+
+    /// Blit count spans, in order.  This lets callers that produce many small runs pay for one
+    /// virtual call per batch instead of one per run.  The default calls blitH() for opaque
+    /// spans and blitAntiH() for the rest.
+    virtual void blitSpans(const Span spans[], int count);
+
     /// Blit a solid rectangle one or more pixels wide.
     virtual void blitRect(int x, int y, int width, int height);
 
@@ -166,6 +177,7 @@ public:
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitSpans(const Span[], int count) override;
     void blitRect(int x, int y, int width, int height) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
@@ -187,10 +199,13 @@ public:
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitSpans(const Span[], int count) override;
     void blitRect(int x, int y, int width, int height) override;
     virtual void blitAntiRect(int x, int y, int width, int height,
                      SkAlpha leftAlpha, SkAlpha rightAlpha) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
 
     int requestRowsPreserved() const override {
@@ -8,6 +8,7 @@
 
 #include "SkCoreBlitters.h"
 #include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkShader.h"
 #include "SkXfermode.h"
 
@@ -23,6 +24,20 @@ const SkPixmap* SkA8_Blitter::justAnOpaqueColor(uint32_t* value) {
     return nullptr;
 }
 
+// device[i] = sa + device[i]*scale/256, four pixels at a time.
+static void blend_row(uint8_t* device, int count, unsigned sa, unsigned scale) {
+    Sk4h vsa(sa), vscale(scale);
+    while (count >= 4) {
+        Sk4h d = SkNx_cast<uint16_t>(Sk4b::Load(device));
+        SkNx_cast<uint8_t>(vsa + ((d * vscale) >> 8)).store(device);
+        device += 4;
+        count  -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        device[i] = SkToU8(sa + SkAlphaMul(device[i], scale));
+    }
+}
+
 void SkA8_Blitter::blitH(int x, int y, int width) {
     SkASSERT(x >= 0 && y >= 0 &&
              (unsigned)(x + width) <= (unsigned)fDevice.width());
@@ -36,12 +51,7 @@ void SkA8_Blitter::blitH(int x, int y, int width) {
     if (fSrcA == 255) {
         memset(device, 0xFF, width);
     } else {
-        unsigned scale = 256 - SkAlpha255To256(fSrcA);
-        unsigned srcA = fSrcA;
-
-        for (int i = 0; i < width; i++) {
-            device[i] = SkToU8(srcA + SkAlphaMul(device[i], scale));
-        }
+        blend_row(device, width, fSrcA, 256 - SkAlpha255To256(fSrcA));
     }
 }
 
@@ -66,11 +76,7 @@ void SkA8_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
             memset(device, 0xFF, count);
         } else {
             unsigned sa = SkAlphaMul(srcA, SkAlpha255To256(aa));
-            unsigned scale = 256 - sa;
-
-            for (int i = 0; i < count; i++) {
-                device[i] = SkToU8(sa + SkAlphaMul(device[i], scale));
-            }
+            blend_row(device, count, sa, 256 - sa);
         }
         runs += count;
         antialias += count;
@@ -195,6 +201,29 @@ void SkA8_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
     }
 }
 
+void SkA8_Blitter::blitSpans(const Span spans[], int count) {
+    if (fSrcA == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Span& span = spans[i];
+        uint8_t* device = fDevice.writable_addr8(span.fX, span.fY);
+
+        // Match blitH() for opaque spans and blitAntiH() for the rest.
+        if (span.fAlpha == 255) {
+            if (fSrcA == 255) {
+                memset(device, 0xFF, span.fWidth);
+            } else {
+                blend_row(device, span.fWidth, fSrcA, 256 - SkAlpha255To256(fSrcA));
+            }
+        } else if (span.fAlpha) {
+            unsigned sa = SkAlphaMul(fSrcA, SkAlpha255To256(span.fAlpha));
+            blend_row(device, span.fWidth, sa, 256 - sa);
+        }
+    }
+}
+
 void SkA8_Blitter::blitRect(int x, int y, int width, int height) {
     SkASSERT(x >= 0 && y >= 0 &&
              (unsigned)(x + width) <= (unsigned)fDevice.width() &&
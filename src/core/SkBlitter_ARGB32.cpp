@@ -105,6 +105,23 @@ void SkARGB32_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
     }
 }
 
+void SkARGB32_Blitter::blitSpans(const Span spans[], int count) {
+    if (fSrcA == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Span& span = spans[i];
+        uint32_t* device = fDevice.writable_addr32(span.fX, span.fY);
+        if ((fSrcA & span.fAlpha) == 255) {
+            sk_memset32(device, fPMColor, span.fWidth);
+        } else if (span.fAlpha) {
+            uint32_t sc = SkAlphaMulQ(fPMColor, SkAlpha255To256(span.fAlpha));
+            SkBlitRow::Color32(device, device, span.fWidth, sc);
+        }
+    }
+}
+
 void SkARGB32_Blitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     uint32_t* device = fDevice.writable_addr32(x, y);
     SkDEBUGCODE((void)fDevice.writable_addr32(x + 1, y);)
@@ -82,6 +82,36 @@ public:
         }
     }
 
+    void blitSpans(const Span spans[], int count) override {
+        // Partial spans go through fProc1 in chunks with a uniform coverage buffer,
+        // rather than one pixel at a time as in blitAntiH().
+        const int kChunk = 64;
+        SkAlpha coverage[kChunk];
+        int     coverageAlpha = -1;
+
+        for (int i = 0; i < count; ++i) {
+            const Span& span = spans[i];
+            typename State::DstType* device = State::WritableAddr(fDevice, span.fX, span.fY);
+            if (span.fAlpha == 255) {
+                fState.fProc1(fState.fXfer, device, &fState.fPM4f, span.fWidth, nullptr);
+                continue;
+            }
+            if (span.fAlpha == 0) {
+                continue;
+            }
+            if (coverageAlpha != span.fAlpha) {
+                memset(coverage, span.fAlpha, sizeof(coverage));
+                coverageAlpha = span.fAlpha;
+            }
+            for (int left = span.fWidth; left > 0; ) {
+                int n = SkTMin(left, kChunk);
+                fState.fProc1(fState.fXfer, device, &fState.fPM4f, n, coverage);
+                device += n;
+                left   -= n;
+            }
+        }
+    }
+
     void blitLCDMask(const SkMask& mask, const SkIRect& clip) {
         auto proc = fState.getLCDProc(SkXfermode::kSrcIsSingle_LCDFlag);
 
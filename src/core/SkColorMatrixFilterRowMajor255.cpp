@@ -9,6 +9,7 @@
 #include "SkColorPriv.h"
 #include "SkNx.h"
 #include "SkPM4fPriv.h"
+#include "SkRasterPipeline.h"
 #include "SkReadBuffer.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
@@ -31,6 +32,10 @@ static void transpose(float dst[20], const float src[20]) {
 
 void SkColorMatrixFilterRowMajor255::initState() {
     transpose(fTranspose, fMatrix);
+    memcpy(fStageMatrix, fTranspose, sizeof(fStageMatrix));
+    for (int i = 16; i < 20; i++) {
+        fStageMatrix[i] *= 1.0f/255;
+    }
 
     const float* array = fMatrix;
 
@@ -151,6 +156,17 @@ void SkColorMatrixFilterRowMajor255::filterSpan4f(const SkPM4f src[], int count,
     filter_span<SkPM4fAdaptor>(fTranspose, src, count, dst);
 }
 
+bool SkColorMatrixFilterRowMajor255::onAppendStages(SkRasterPipeline* p) const {
+    // Same as filter_span(): unpremul, apply the matrix, clamp to [0,1], premul.
+    p->append(SkRasterPipeline::unpremul);
+    p->append(SkRasterPipeline::matrix_4x5, fStageMatrix);
+    p->append(SkRasterPipeline::clamp_0);
+    p->append(SkRasterPipeline::clamp_a);
+    p->append(SkRasterPipeline::premul);
+    p->append(SkRasterPipeline::clamp_1);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkColorMatrixFilterRowMajor255::flatten(SkWriteBuffer& buffer) const {
@@ -34,10 +34,12 @@ public:
 
 protected:
     void flatten(SkWriteBuffer&) const override;
+    bool onAppendStages(SkRasterPipeline*) const override;
 
 private:
     SkScalar        fMatrix[20];
     float           fTranspose[20]; // for Sk4s
+    float           fStageMatrix[20]; // fTranspose with its translate in [0,1], for matrix_4x5
     uint32_t        fFlags;
 
     void initState();
@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
 #include "SkColorShader.h"
 #include "SkColorSpace.h"
+#include "SkPM4fPriv.h"
+#include "SkRasterPipeline.h"
 #include "SkReadBuffer.h"
 #include "SkUtils.h"
 
@@ -32,6 +35,14 @@ SkShader::Context* SkColorShader::onCreateContext(const ContextRec& rec, void* s
     return new (storage) ColorShaderContext(*this, rec);
 }
 
+bool SkColorShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dstColorSpace,
+                                   SkArenaAlloc* alloc, const SkMatrix&, const SkPaint&,
+                                   const SkMatrix*) const {
+    auto color = alloc->make<SkPM4f>(SkColor4f_from_SkColor(fColor, dstColorSpace).premul());
+    p->append(SkRasterPipeline::constant_color, color);
+    return true;
+}
+
 SkColorShader::ColorShaderContext::ColorShaderContext(const SkColorShader& shader,
                                                       const ContextRec& rec)
     : INHERITED(shader, rec)
@@ -150,6 +161,18 @@ SkShader::Context* SkColor4Shader::onCreateContext(const ContextRec& rec, void*
     return new (storage) Color4Context(*this, rec);
 }
 
+bool SkColor4Shader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dstColorSpace,
+                                    SkArenaAlloc* alloc, const SkMatrix&, const SkPaint&,
+                                    const SkMatrix*) const {
+    // Like Color4Context, we use fColor4 as-is when drawing gamma-correctly.
+    auto color = alloc->make<SkPM4f>(dstColorSpace
+                                         ? fColor4.premul()
+                                         : SkColor4f_from_SkColor(fCachedByteColor,
+                                                                  nullptr).premul());
+    p->append(SkRasterPipeline::constant_color, color);
+    return true;
+}
+
 SkColor4Shader::Color4Context::Color4Context(const SkColor4Shader& shader,
                                                       const ContextRec& rec)
 : INHERITED(shader, rec)
@@ -60,6 +60,9 @@ protected:
     void flatten(SkWriteBuffer&) const override;
     Context* onCreateContext(const ContextRec&, void* storage) const override;
     size_t onContextSize(const ContextRec&) const override { return sizeof(ColorShaderContext); }
+    bool onAppendStages(SkRasterPipeline*, SkColorSpace*, SkArenaAlloc*,
+                        const SkMatrix& ctm, const SkPaint&,
+                        const SkMatrix* localM) const override;
     bool onAsLuminanceColor(SkColor* lum) const override {
         *lum = fColor;
         return true;
@@ -113,6 +116,9 @@ protected:
     void flatten(SkWriteBuffer&) const override;
     Context* onCreateContext(const ContextRec&, void* storage) const override;
     size_t onContextSize(const ContextRec&) const override { return sizeof(Color4Context); }
+    bool onAppendStages(SkRasterPipeline*, SkColorSpace*, SkArenaAlloc*,
+                        const SkMatrix& ctm, const SkPaint&,
+                        const SkMatrix* localM) const override;
     bool onAsLuminanceColor(SkColor* lum) const override {
         *lum = fCachedByteColor;
         return true;
@@ -629,6 +629,56 @@ static AI void load_rgba_linear_1(const uint32_t* src,
     a = Sk4f((1.0f / 255.0f) * ((*src >> 24)));
 }
 
+// RGB pixels are packed three bytes apiece, and are always opaque.
+static AI void load_rgb888_from_tables(const uint32_t* vsrc,
+                                       Sk4f& r, Sk4f& g, Sk4f& b, Sk4f& a,
+                                       const float* const srcTables[3]) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+    r = { srcTables[0][src[0]],
+          srcTables[0][src[3]],
+          srcTables[0][src[6]],
+          srcTables[0][src[9]], };
+    g = { srcTables[1][src[1]],
+          srcTables[1][src[4]],
+          srcTables[1][src[7]],
+          srcTables[1][src[10]], };
+    b = { srcTables[2][src[2]],
+          srcTables[2][src[5]],
+          srcTables[2][src[8]],
+          srcTables[2][src[11]], };
+    a = 1.0f;
+}
+
+static AI void load_rgb888_linear(const uint32_t* vsrc,
+                                  Sk4f& r, Sk4f& g, Sk4f& b, Sk4f& a,
+                                  const float* const[3]) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+    r = (1.0f / 255.0f) * Sk4f(src[0], src[3], src[6], src[ 9]);
+    g = (1.0f / 255.0f) * Sk4f(src[1], src[4], src[7], src[10]);
+    b = (1.0f / 255.0f) * Sk4f(src[2], src[5], src[8], src[11]);
+    a = 1.0f;
+}
+
+static AI void load_rgb888_from_tables_1(const uint32_t* vsrc,
+                                         Sk4f& r, Sk4f& g, Sk4f& b, Sk4f& a,
+                                         const float* const srcTables[3]) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+    r = Sk4f(srcTables[0][src[0]]);
+    g = Sk4f(srcTables[1][src[1]]);
+    b = Sk4f(srcTables[2][src[2]]);
+    a = 1.0f;
+}
+
+static AI void load_rgb888_linear_1(const uint32_t* vsrc,
+                                    Sk4f& r, Sk4f& g, Sk4f& b, Sk4f& a,
+                                    const float* const[3]) {
+    const uint8_t* src = (const uint8_t*) vsrc;
+    r = Sk4f((1.0f / 255.0f) * src[0]);
+    g = Sk4f((1.0f / 255.0f) * src[1]);
+    b = Sk4f((1.0f / 255.0f) * src[2]);
+    a = 1.0f;
+}
+
 static AI void transform_gamut(const Sk4f& r, const Sk4f& g, const Sk4f& b, const Sk4f& a,
                                const Sk4f& rXgXbX, const Sk4f& rYgYbY, const Sk4f& rZgZbZ,
                                Sk4f& dr, Sk4f& dg, Sk4f& db, Sk4f& da) {
@@ -901,8 +951,22 @@ enum SrcFormat {
     kRGBA_8888_Table_SrcFormat,
     kBGRA_8888_Linear_SrcFormat,
     kBGRA_8888_Table_SrcFormat,
+    kRGB_888_Linear_SrcFormat,
+    kRGB_888_Table_SrcFormat,
 };
 
+static constexpr bool is_rgb_888(SrcFormat kSrc) {
+    return kRGB_888_Linear_SrcFormat == kSrc || kRGB_888_Table_SrcFormat == kSrc;
+}
+
+// The 8888 stores keep the alpha of the src pixels.  RGB pixels have none to keep, so hand the
+// stores opaque ones instead.
+template <SrcFormat kSrc>
+static AI const uint32_t* src_alpha(const uint8_t* src) {
+    static const uint32_t kOpaque[4] = { 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000 };
+    return is_rgb_888(kSrc) ? kOpaque : (const uint32_t*) src;
+}
+
 enum DstFormat {
     kRGBA_8888_Linear_DstFormat,
     kRGBA_8888_SRGB_DstFormat,
@@ -965,6 +1029,14 @@ static void color_xform_RGBA(void* dst, const void* vsrc, int len,
                 load_1 = load_rgb_from_tables_1<kBGRA_Order>;
             }
             break;
+        case kRGB_888_Linear_SrcFormat:
+            load = load_rgb888_linear;
+            load_1 = load_rgb888_linear_1;
+            break;
+        case kRGB_888_Table_SrcFormat:
+            load = load_rgb888_from_tables;
+            load_1 = load_rgb888_from_tables_1;
+            break;
     }
 
     StoreFn store;
@@ -1025,7 +1097,8 @@ static void color_xform_RGBA(void* dst, const void* vsrc, int len,
             break;
     }
 
-    const uint32_t* src = (const uint32_t*) vsrc;
+    const size_t sizeOfSrcPixel = is_rgb_888(kSrc) ? 3 : 4;
+    const uint8_t* src = (const uint8_t*) vsrc;
     Sk4f rXgXbX, rYgYbY, rZgZbZ, rTgTbT;
     load_matrix(matrix, rXgXbX, rYgYbY, rZgZbZ, rTgTbT);
 
@@ -1033,8 +1106,8 @@ static void color_xform_RGBA(void* dst, const void* vsrc, int len,
         // Naively this would be a loop of load-transform-store, but we found it faster to
         // move the N+1th load ahead of the Nth store.  We don't bother doing this for N<4.
         Sk4f r, g, b, a;
-        load(src, r, g, b, a, srcTables);
-        src += 4;
+        load((const uint32_t*) src, r, g, b, a, srcTables);
+        src += 4 * sizeOfSrcPixel;
         len -= 4;
 
         Sk4f dr, dg, db, da;
@@ -1053,11 +1126,11 @@ static void color_xform_RGBA(void* dst, const void* vsrc, int len,
                 premultiply(dr, dg, db, da);
             }
 
-            load(src, r, g, b, a, srcTables);
+            load((const uint32_t*) src, r, g, b, a, srcTables);
 
-            store(dst, src - 4, dr, dg, db, da, dstTables);
+            store(dst, src_alpha<kSrc>(src - 4 * sizeOfSrcPixel), dr, dg, db, da, dstTables);
             dst = SkTAddOffset<void>(dst, 4 * sizeOfDstPixel);
-            src += 4;
+            src += 4 * sizeOfSrcPixel;
             len -= 4;
         }
 
@@ -1075,13 +1148,13 @@ static void color_xform_RGBA(void* dst, const void* vsrc, int len,
             premultiply(dr, dg, db, da);
         }
 
-        store(dst, src - 4, dr, dg, db, da, dstTables);
+        store(dst, src_alpha<kSrc>(src - 4 * sizeOfSrcPixel), dr, dg, db, da, dstTables);
         dst = SkTAddOffset<void>(dst, 4 * sizeOfDstPixel);
     }
 
     while (len > 0) {
         Sk4f r, g, b, a;
-        load_1(src, r, g, b, a, srcTables);
+        load_1((const uint32_t*) src, r, g, b, a, srcTables);
 
         Sk4f rgba;
         if (kNone_ColorSpaceMatch == kCSM) {
@@ -1095,9 +1168,9 @@ static void color_xform_RGBA(void* dst, const void* vsrc, int len,
             premultiply_1(a, rgba);
         }
 
-        store_1(dst, src, rgba, a, dstTables);
+        store_1(dst, src_alpha<kSrc>(src), rgba, a, dstTables);
 
-        src += 1;
+        src += sizeOfSrcPixel;
         len -= 1;
         dst = SkTAddOffset<void>(dst, sizeOfDstPixel);
     }
@@ -1193,6 +1266,15 @@ static AI bool apply_set_src(void* dst, const void* src, int len, SkAlphaType al
                     return apply_set_alpha<kBGRA_8888_Table_SrcFormat, kDst, kCSM>
                             (dst, src, len, alphaType, srcTables, matrix, dstTables);
             }
+        case SkColorSpaceXform::kRGB_888_ColorFormat:
+            switch (kSrc) {
+                case kLinear_SrcGamma:
+                    return apply_set_alpha<kRGB_888_Linear_SrcFormat, kDst, kCSM>
+                            (dst, src, len, alphaType, nullptr, matrix, dstTables);
+                case kTable_SrcGamma:
+                    return apply_set_alpha<kRGB_888_Table_SrcFormat, kDst, kCSM>
+                            (dst, src, len, alphaType, srcTables, matrix, dstTables);
+            }
         default:
             return false;
     }
@@ -1214,10 +1296,18 @@ bool SkColorSpaceXform_XYZ<kSrc, kDst, kCSM>
             default:
                 switch (dstColorFormat) {
                     case kRGBA_8888_ColorFormat:
-                        memcpy(dst, src, len * sizeof(uint32_t));
+                        if (kRGB_888_ColorFormat == srcColorFormat) {
+                            SkOpts::RGB_to_RGB1((uint32_t*) dst, src, len);
+                        } else {
+                            memcpy(dst, src, len * sizeof(uint32_t));
+                        }
                         return true;
                     case kBGRA_8888_ColorFormat:
-                        SkOpts::RGBA_to_BGRA((uint32_t*) dst, src, len);
+                        if (kRGB_888_ColorFormat == srcColorFormat) {
+                            SkOpts::RGB_to_BGR1((uint32_t*) dst, src, len);
+                        } else {
+                            SkOpts::RGBA_to_BGRA((uint32_t*) dst, src, len);
+                        }
                         return true;
                     case kRGBA_F16_ColorFormat:
                     case kRGBA_F32_ColorFormat:
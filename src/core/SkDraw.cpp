@@ -15,6 +15,7 @@
 #include "SkDeviceLooper.h"
 #include "SkFindAndPlaceGlyph.h"
 #include "SkFixed.h"
+#include "SkMaskCache.h"
 #include "SkMaskFilter.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
@@ -28,6 +29,7 @@
 #include "SkString.h"
 #include "SkStroke.h"
 #include "SkStrokeRec.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTextMapStateProc.h"
 #include "SkTLazy.h"
@@ -46,6 +48,7 @@
 void FixGCC49Arm64Bug(int v) { }
 
 /** Helper for allocating small blitters on the stack.
+ *  If dstClip is not null, the blitter only writes pixels inside it (see SkDraw::fDstClip).
  */
 class SkAutoBlitterChoose : SkNoncopyable {
 public:
@@ -53,23 +56,38 @@ public:
         fBlitter = nullptr;
     }
     SkAutoBlitterChoose(const SkPixmap& dst, const SkMatrix& matrix,
-                        const SkPaint& paint, bool drawCoverage = false) {
-        fBlitter = SkBlitter::Choose(dst, matrix, paint, &fAllocator, drawCoverage);
+                        const SkPaint& paint, bool drawCoverage = false,
+                        const SkIRect* dstClip = nullptr) {
+        fBlitter = nullptr;
+        this->choose(dst, matrix, paint, drawCoverage, dstClip);
+    }
+    SkAutoBlitterChoose(const SkDraw& draw, const SkPaint& paint, bool drawCoverage = false) {
+        fBlitter = nullptr;
+        this->choose(draw, paint, drawCoverage);
     }
 
     SkBlitter*  operator->() { return fBlitter; }
     SkBlitter*  get() const { return fBlitter; }
 
     void choose(const SkPixmap& dst, const SkMatrix& matrix,
-                const SkPaint& paint, bool drawCoverage = false) {
+                const SkPaint& paint, bool drawCoverage = false,
+                const SkIRect* dstClip = nullptr) {
         SkASSERT(!fBlitter);
         fBlitter = SkBlitter::Choose(dst, matrix, paint, &fAllocator, drawCoverage);
+        if (dstClip) {
+            fClipBlitter.init(fBlitter, *dstClip);
+            fBlitter = &fClipBlitter;
+        }
+    }
+    void choose(const SkDraw& draw, const SkPaint& paint, bool drawCoverage = false) {
+        this->choose(draw.fDst, *draw.fMatrix, paint, drawCoverage, draw.fDstClip);
     }
 
 private:
     // Owned by fAllocator, which will handle the delete.
     SkBlitter*          fBlitter;
     SkTBlitterAllocator fAllocator;
+    SkRectClipBlitter   fClipBlitter;
 };
 #define SkAutoBlitterChoose(...) SK_REQUIRE_LOCAL_VAR(SkAutoBlitterChoose)
 
@@ -276,7 +294,10 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
 
             SkRegion::Iterator iter(fRC->bwRgn());
             while (!iter.done()) {
-                CallBitmapXferProc(fDst, iter.rect(), proc, procData);
+                SkIRect rect = iter.rect();
+                if (!fDstClip || rect.intersect(*fDstClip)) {
+                    CallBitmapXferProc(fDst, rect, proc, procData);
+                }
                 iter.next();
             }
             return;
@@ -284,7 +305,7 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
     }
 
     // normal case: use a blitter
-    SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose blitter(*this, paint);
     SkScan::FillIRect(devRect, *fRC, blitter.get());
 }
 
@@ -558,7 +579,7 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
 
     PtProcRec rec;
     if (!forceUseDevice && rec.init(mode, paint, fMatrix, fRC)) {
-        SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+        SkAutoBlitterChoose blitter(*this, paint);
 
         SkPoint             devPts[MAX_DEV_PTS];
         const SkMatrix*     matrix = fMatrix;
@@ -859,7 +880,15 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         SkMatrix localMatrix;
         looper.mapMatrix(&localMatrix, *matrix);
 
-        SkAutoBlitterChoose blitterStorage(looper.getPixmap(), localMatrix, paint);
+        SkIRect localDstClip;
+        if (fDstClip) {
+            SkRect r;
+            looper.mapRect(&r, SkRect::Make(*fDstClip));
+            localDstClip = r.round();
+        }
+
+        SkAutoBlitterChoose blitterStorage(looper.getPixmap(), localMatrix, paint, false,
+                                           fDstClip ? &localDstClip : nullptr);
         const SkRasterClip& clip = looper.getRC();
         SkBlitter*          blitter = blitterStorage.get();
 
@@ -908,7 +937,7 @@ void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     }
     SkAutoMaskFreeImage ami(dstM.fImage);
 
-    SkAutoBlitterChoose blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose blitterChooser(*this, paint);
     SkBlitter* blitter = blitterChooser.get();
 
     SkAAClipBlitterWrapper wrapper;
@@ -986,7 +1015,7 @@ void SkDraw::drawRRect(const SkRRect& rrect, const SkPaint& paint) const {
         // Transform the rrect into device space.
         SkRRect devRRect;
         if (rrect.transform(*fMatrix, &devRRect)) {
-            SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+            SkAutoBlitterChoose blitter(*this, paint);
             if (paint.getMaskFilter()->filterRRect(devRRect, *fMatrix, *fRC, blitter.get())) {
                 return; // filterRRect() called the blitter, so we're done
             }
@@ -1014,8 +1043,44 @@ SkScalar SkDraw::ComputeResScaleForStroking(const SkMatrix& matrix) {
     return 1;
 }
 
+// How many horizontal bands to split a fill of devPath into, or 1 to scan convert it serially.
+// Every band builds all of the path's edges, so only paths with plenty of edges per band and
+// enough rows to share out are worth it.
+static int count_scan_bands(const SkPath& devPath, const SkIRect& bounds) {
+    static const int kMinPointsPerBand = 2048;
+    static const int kMinRowsPerBand   = 32;
+    static const int kMaxBands         = 16;
+
+    if (!gSkUseParallelScanConversion.load() || !SkScan::CanFillPathInBands(devPath)) {
+        return 1;
+    }
+    int bands = SkTMin(devPath.countPoints() / kMinPointsPerBand,
+                       bounds.height() / kMinRowsPerBand);
+    return SkTPin(bands, 1, kMaxBands);
+}
+
+// Scan convert horizontal bands of devPath in parallel, each into its own blitter.
+// Bands cover disjoint rows, so they never touch the same pixels.
+static void fill_path_in_bands(const SkDraw& draw, const SkPath& devPath,
+                               const SkDevPathSource* source, const SkPaint& paint,
+                               bool drawCoverage, const SkIRect& bounds, int bands) {
+    auto proc = paint.isAntiAlias() ? SkScan::AntiFillPathBand : SkScan::FillPathBand;
+    const int rowsPerBand = (bounds.height() + bands - 1) / bands;
+    const int firstTop   = draw.fDstClip ? draw.fDstClip->fTop    : SK_MinS32,
+              lastBottom = draw.fDstClip ? draw.fDstClip->fBottom : SK_MaxS32;
+
+    SkTaskGroup().batch(bands, [&](int i) {
+        int top    = i == 0         ? firstTop   : bounds.fTop + i * rowsPerBand;
+        int bottom = i == bands - 1 ? lastBottom : bounds.fTop + (i + 1) * rowsPerBand;
+
+        SkAutoBlitterChoose blitter(draw, paint, drawCoverage);
+        proc(devPath, *draw.fRC, top, bottom, blitter.get(), source);
+    });
+}
+
 void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
-                         SkBlitter* customBlitter, bool doFill) const {
+                         SkBlitter* customBlitter, bool doFill,
+                         const SkDevPathSource* source) const {
     // Do a conservative quick-reject test, since a looper or other modifier may have moved us
     // out of range.
     if (!devPath.isInverseFillType()) {
@@ -1037,10 +1102,23 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    if (doFill && nullptr == customBlitter && nullptr == paint.getMaskFilter()) {
+        SkIRect bounds;
+        if (bounds.intersect(devPath.getBounds().roundOut(), fRC->getBounds()) &&
+            (!fDstClip || bounds.intersect(*fDstClip))) {
+            int bands = count_scan_bands(devPath, bounds);
+            // With a dst clip, even a single band skips walking the rows outside it.
+            if (bands > 1 || (fDstClip && SkScan::CanFillPathInBands(devPath))) {
+                fill_path_in_bands(*this, devPath, source, paint, drawCoverage, bounds, bands);
+                return;
+            }
+        }
+    }
+
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
-        blitterStorage.choose(fDst, *fMatrix, paint, drawCoverage);
+        blitterStorage.choose(*this, paint, drawCoverage);
         blitter = blitterStorage.get();
     } else {
         blitter = customBlitter;
@@ -1057,10 +1135,11 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
         if (paint.isAntiAlias()) {
-            proc = SkScan::AntiFillPath;
+            SkScan::AntiFillPath(devPath, *fRC, blitter, source);
         } else {
-            proc = SkScan::FillPath;
+            SkScan::FillPath(devPath, *fRC, blitter, source);
         }
+        return;
     } else {    // hairline
         if (paint.isAntiAlias()) {
             switch (paint.getStrokeCap()) {
@@ -1097,6 +1176,91 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     proc(devPath, *fRC, blitter);
 }
 
+static constexpr int kMinEdgeCachePoints = 32;
+
+static bool can_cache_path_mask(const SkPath& path, const SkPaint& paint, const SkMatrix& matrix) {
+    if (!gSkUsePathMaskCache.load() || path.isVolatile() || path.isInverseFillType() ||
+            !paint.isAntiAlias() || paint.getPathEffect() || paint.getRasterizer() ||
+            paint.getMaskFilter() || matrix.hasPerspective()) {
+        return false;
+    }
+    // Hairlines are cheaper to draw than to look up.
+    return paint.getStyle() == SkPaint::kFill_Style || paint.getStrokeWidth() > 0;
+}
+
+// Draw an anti-aliased fill or stroke of path from a coverage mask in SkMaskCache, rendering and
+// adding it first if it isn't there.  The whole-pixel part of the matrix's translation is left
+// out of the mask, and the rest is rounded to a quarter pixel, so the mask can be reused wherever
+// the path moves to.  Returns false if the path is too large to keep a mask for.
+bool SkDraw::drawCachedPathMask(const SkPath& path, const SkPaint& paint,
+                                const SkMatrix& matrix) const {
+    static const SkScalar kSubpixels      = 4;
+    static const SkScalar kMaxOffset      = 1 << 24;
+    static const size_t   kMaxCachedBytes = 256 * 1024;
+
+    // Don't bother rendering a mask we can't see any of.
+    SkRect storage, devBounds;
+    matrix.mapRect(&devBounds, paint.computeFastBounds(path.getBounds(), &storage));
+    if (!SkRect::Make(fRC->getBounds()).intersects(devBounds.makeOutset(1, 1))) {
+        return true;
+    }
+
+    const SkScalar tx = matrix.getTranslateX(),
+                   ty = matrix.getTranslateY();
+    if (!(SkScalarAbs(tx) < kMaxOffset && SkScalarAbs(ty) < kMaxOffset)) {
+        return false;
+    }
+    const int ix = SkScalarFloorToInt(tx),
+              iy = SkScalarFloorToInt(ty);
+
+    SkMatrix maskMatrix(matrix);
+    maskMatrix.setTranslateX(SkScalarFloorToScalar((tx - ix) * kSubpixels) / kSubpixels);
+    maskMatrix.setTranslateY(SkScalarFloorToScalar((ty - iy) * kSubpixels) / kSubpixels);
+
+    SkMask mask;
+    SkCachedData* data = SkMaskCache::FindAndRef(path, maskMatrix, paint, &mask);
+    if (!data) {
+        SkPath devPath;
+        if (paint.getStyle() == SkPaint::kFill_Style) {
+            path.transform(maskMatrix, &devPath);
+        } else {
+            SkPath strokedPath;
+            if (!paint.getFillPath(path, &strokedPath, nullptr,
+                                   ComputeResScaleForStroking(matrix))) {
+                return false;
+            }
+            strokedPath.transform(maskMatrix, &devPath);
+        }
+        // Rendering the mask draws devPath again; don't let that look for a mask of its own.
+        devPath.setIsVolatile(true);
+        if (!DrawToMask(devPath, nullptr, nullptr, nullptr, &mask,
+                        SkMask::kJustComputeBounds_CreateMode, SkStrokeRec::kFill_InitStyle)) {
+            // Nothing to draw.
+            return true;
+        }
+        mask.fFormat = SkMask::kA8_Format;
+        mask.fRowBytes = mask.fBounds.width();
+        size_t size = mask.computeImageSize();
+        if (0 == size || size > kMaxCachedBytes) {
+            return false;
+        }
+        data = SkResourceCache::NewCachedData(size);
+        if (!data) {
+            return false;
+        }
+        mask.fImage = (uint8_t*)data->writable_data();
+        memset(mask.fImage, 0, size);
+        DrawToMask(devPath, nullptr, nullptr, nullptr, &mask,
+                   SkMask::kJustRenderImage_CreateMode, SkStrokeRec::kFill_InitStyle);
+        SkMaskCache::Add(path, maskMatrix, paint, mask, data);
+    }
+
+    mask.fBounds.offset(ix, iy);
+    this->drawDevMask(mask, paint);
+    data->unref();
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -1159,6 +1323,12 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
+    if (pathPtr == &origSrcPath && !pathIsMutable && !drawCoverage && !customBlitter &&
+            can_cache_path_mask(origSrcPath, *paint, *matrix) &&
+            this->drawCachedPathMask(origSrcPath, *paint, *matrix)) {
+        return;
+    }
+
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = nullptr;
@@ -1181,13 +1351,24 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
+    // Only a fill of the caller's own, unmodified path can be recognized again next time, so
+    // only those get to reuse edges from SkEdgeCache.  Small paths are cheaper to rebuild.
+    SkDevPathSource source;
+    const SkDevPathSource* sourcePtr = nullptr;
+    if (doFill && pathPtr == &origSrcPath && !pathIsMutable && !origSrcPath.isVolatile() &&
+            origSrcPath.countPoints() >= kMinEdgeCachePoints) {
+        source.fGenID = origSrcPath.getGenerationID();
+        source.fMatrix = *matrix;
+        sourcePtr = &source;
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
     // transform the path into device space
     pathPtr->transform(*matrix, devPathPtr);
 
-    this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill);
+    this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill, sourcePtr);
 }
 
 void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap, const SkPaint& paint) const {
@@ -1329,8 +1510,10 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             // blitter will be owned by the allocator.
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator);
             if (blitter) {
-                SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
-                                  *fRC, blitter);
+                SkIRect r = SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height());
+                if (!fDstClip || r.intersect(*fDstClip)) {
+                    SkScan::FillIRect(r, *fRC, blitter);
+                }
                 return;
             }
             // if !blitter, then we fall-through to the slower case
@@ -1386,7 +1569,10 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         // blitter will be owned by the allocator.
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator);
         if (blitter) {
-            SkScan::FillIRect(bounds, *fRC, blitter);
+            SkIRect r = bounds;
+            if (!fDstClip || r.intersect(*fDstClip)) {
+                SkScan::FillIRect(r, *fRC, blitter);
+            }
             return;
         }
     }
@@ -1613,7 +1799,7 @@ void SkDraw::drawText(const char text[], size_t byteLength,
     SkAutoGlyphCache cache(paint, &fDevice->surfaceProps(), this->scalerContextFlags(), fMatrix);
 
     // The Blitter Choose needs to be live while using the blitter below.
-    SkAutoBlitterChoose    blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose    blitterChooser(*this, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
     DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
 
@@ -1695,7 +1881,7 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
     SkAutoGlyphCache cache(paint, &fDevice->surfaceProps(), this->scalerContextFlags(), fMatrix);
 
     // The Blitter Choose needs to be live while using the blitter below.
-    SkAutoBlitterChoose    blitterChooser(fDst, *fMatrix, paint);
+    SkAutoBlitterChoose    blitterChooser(*this, paint);
     SkAAClipBlitterWrapper wrapper(*fRC, blitterChooser.get());
     DrawOneGlyph           drawOneGlyph(*this, paint, cache.get(), wrapper.getBlitter());
     SkPaint::Align         textAlignment = paint.getTextAlign();
@@ -1941,7 +2127,7 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
         }
     }
 
-    SkAutoBlitterChoose blitter(fDst, *fMatrix, p);
+    SkAutoBlitterChoose blitter(*this, p);
     // Abort early if we failed to create a shader context.
     if (blitter->isNullBlitter()) {
         return;
@@ -446,3 +446,19 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, int shiftUp,
     fEdgeList = fList.begin();
     return fList.count();
 }
+
+int SkEdgeBuilder::copyEdges(const void* edges, size_t size, const uint32_t offsets[],
+                             int count) {
+    fAlloc.reset();
+    fList.reset();
+
+    // lets store the edges and their pointers in the same block
+    size_t edgeSize = SkAlign8(size);
+    char* storage = (char*)fAlloc.allocThrow(edgeSize + count * sizeof(void*));
+    memcpy(storage, edges, size);
+    fEdgeList = (void**)(storage + edgeSize);
+    for (int i = 0; i < count; i++) {
+        fEdgeList[i] = storage + offsets[i];
+    }
+    return count;
+}
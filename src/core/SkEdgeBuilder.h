@@ -25,6 +25,10 @@ public:
     int build(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight,
               bool analyticAA = false);
 
+    // Replaces any built edges with count edges copied out of a single block of size bytes,
+    // edge i starting offsets[i] bytes in. Used by SkEdgeCache.
+    int copyEdges(const void* edges, size_t size, const uint32_t offsets[], int count);
+
     SkEdge** edgeList() { return (SkEdge**)fEdgeList; }
     SkAnalyticEdge** analyticEdgeList() { return (SkAnalyticEdge**)fEdgeList; }
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkEdgeCache.h"
+#include "SkAnalyticEdge.h"
+#include "SkCachedData.h"
+#include "SkEdge.h"
+#include "SkEdgeBuilder.h"
+#include "SkResourceCache.h"
+
+#include <atomic>
+
+static std::atomic<int> gHitCount{0};
+static std::atomic<int> gMissCount{0};
+
+namespace {
+static unsigned gEdgeKeyNamespaceLabel;
+
+struct EdgeKey : public SkResourceCache::Key {
+public:
+    EdgeKey(const SkDevPathSource& source, const SkIRect* clip, int shiftUp,
+            bool canCullToTheRight, bool analyticAA)
+        : fClip(clip ? *clip : SkIRect::MakeEmpty())
+        , fHasClip(clip != nullptr)
+        , fShiftUp(shiftUp)
+        , fFlags((canCullToTheRight ? 1 : 0) | (analyticAA ? 2 : 0))
+    {
+        source.fMatrix.get9(fMatrix);
+        this->init(&gEdgeKeyNamespaceLabel, source.fGenID,
+                   sizeof(fMatrix) + sizeof(fClip) + sizeof(fHasClip) + sizeof(fShiftUp) +
+                   sizeof(fFlags));
+    }
+
+    SkScalar fMatrix[9];
+    SkIRect  fClip;
+    int32_t  fHasClip;
+    int32_t  fShiftUp;
+    int32_t  fFlags;
+};
+
+// fData holds fCount uint32_t offsets, then the edges they point into.
+struct EdgeValue {
+    int             fCount;
+    SkCachedData*   fData;
+};
+
+struct EdgeRec : public SkResourceCache::Rec {
+    EdgeRec(const EdgeKey& key, int count, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fCount = count;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~EdgeRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    EdgeKey     fKey;
+    EdgeValue   fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "edges"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const EdgeRec& rec = static_cast<const EdgeRec&>(baseRec);
+        EdgeValue* result = (EdgeValue*)contextData;
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+// Edges still on their last curve segment (fCurveCount == 0) are only ever walked as lines,
+// so only their line part needs to be kept.
+template <typename Edge, typename QuadEdge, typename CubicEdge>
+static size_t edge_size(const Edge* edge) {
+    if (edge->fCurveCount < 0) {
+        return sizeof(CubicEdge);
+    }
+    if (edge->fCurveCount > 0) {
+        return sizeof(QuadEdge);
+    }
+    return sizeof(Edge);
+}
+
+template <typename Edge, typename QuadEdge, typename CubicEdge>
+static void add_edges(const EdgeKey& key, Edge* const edges[], int count) {
+    size_t offsetSize = SkAlign8(count * sizeof(uint32_t));
+    size_t size = offsetSize;
+    for (int i = 0; i < count; i++) {
+        size += edge_size<Edge, QuadEdge, CubicEdge>(edges[i]);
+    }
+
+    size_t limit = SkResourceCache::GetEffectiveSingleAllocationByteLimit();
+    if ((limit && size > limit) || size > SK_MaxU32) {
+        return;
+    }
+    SkCachedData* data = SkResourceCache::NewCachedData(size);
+    if (nullptr == data) {
+        return;
+    }
+
+    uint32_t* offsets = (uint32_t*)data->writable_data();
+    char* storage = (char*)data->writable_data() + offsetSize;
+    size_t offset = 0;
+    for (int i = 0; i < count; i++) {
+        size_t edgeSize = edge_size<Edge, QuadEdge, CubicEdge>(edges[i]);
+        memcpy(storage + offset, edges[i], edgeSize);
+        offsets[i] = SkToU32(offset);
+        offset += edgeSize;
+    }
+
+    SkResourceCache::Add(new EdgeRec(key, count, data));
+    data->unref();
+}
+
+int SkEdgeCache::Find(const SkDevPathSource& source, const SkIRect* clip, int shiftUp,
+                      bool canCullToTheRight, bool analyticAA, SkEdgeBuilder* builder) {
+    EdgeKey key(source, clip, shiftUp, canCullToTheRight, analyticAA);
+    EdgeValue result;
+    if (!SkResourceCache::Find(key, EdgeRec::Visitor, &result)) {
+        gMissCount.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    gHitCount.fetch_add(1, std::memory_order_relaxed);
+
+    size_t offsetSize = SkAlign8(result.fCount * sizeof(uint32_t));
+    const uint32_t* offsets = (const uint32_t*)result.fData->data();
+    const char* edges = (const char*)result.fData->data() + offsetSize;
+    int count = builder->copyEdges(edges, result.fData->size() - offsetSize, offsets,
+                                   result.fCount);
+    result.fData->unref();
+    return count;
+}
+
+void SkEdgeCache::Add(const SkDevPathSource& source, const SkIRect* clip, int shiftUp,
+                      bool canCullToTheRight, SkEdge* const edges[], int count) {
+    EdgeKey key(source, clip, shiftUp, canCullToTheRight, false);
+    add_edges<SkEdge, SkQuadraticEdge, SkCubicEdge>(key, edges, count);
+}
+
+void SkEdgeCache::Add(const SkDevPathSource& source, const SkIRect* clip,
+                      bool canCullToTheRight, SkAnalyticEdge* const edges[], int count) {
+    EdgeKey key(source, clip, 0, canCullToTheRight, true);
+    add_edges<SkAnalyticEdge, SkAnalyticQuadraticEdge, SkAnalyticCubicEdge>(key, edges, count);
+}
+
+int SkEdgeCache::GetHitCount() {
+    return gHitCount.load(std::memory_order_relaxed);
+}
+
+int SkEdgeCache::GetMissCount() {
+    return gMissCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkEdgeCache_DEFINED
+#define SkEdgeCache_DEFINED
+
+#include "SkScan.h"
+
+struct SkAnalyticEdge;
+struct SkEdge;
+class SkEdgeBuilder;
+
+/**
+ *  Keeps the sorted edges SkEdgeBuilder made for a path in the global SkResourceCache, keyed
+ *  on where the path came from and on how it was clipped, so that redrawing the same geometry
+ *  copies its edges instead of building and sorting them again.
+ */
+class SkEdgeCache {
+public:
+    /**
+     *  On a hit, copy the cached edges into builder, already sorted, and return how many there
+     *  are.  On a miss, return -1.  The other arguments are those passed to
+     *  SkEdgeBuilder::build().
+     */
+    static int Find(const SkDevPathSource&, const SkIRect* clip, int shiftUp,
+                    bool canCullToTheRight, bool analyticAA, SkEdgeBuilder*);
+
+    /**
+     *  Add a copy of these count sorted edges, as built with the given arguments.
+     */
+    static void Add(const SkDevPathSource&, const SkIRect* clip, int shiftUp,
+                    bool canCullToTheRight, SkEdge* const edges[], int count);
+    static void Add(const SkDevPathSource&, const SkIRect* clip,
+                    bool canCullToTheRight, SkAnalyticEdge* const edges[], int count);
+
+    /**
+     *  Total number of Find() calls that have hit or missed.
+     */
+    static int GetHitCount();
+    static int GetMissCount();
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkFlatPicture.h"
+#include "SkPictureData.h"
+#include "SkPicturePlayback.h"
+#include "SkReadBuffer.h"
+
+// Count the ops in data, and if offsets is not null, note where each one starts.
+static int count_ops(const SkPictureData& data, SkTDArray<uint32_t>* offsets) {
+    SkReadBuffer reader(data.opData()->bytes(), data.opData()->size());
+    int count = 0;
+    while (!reader.eof() && reader.isValid()) {
+        const size_t start = reader.offset();
+        uint32_t size;
+        SkPicturePlayback::ReadOpAndSize(&reader, &size);
+        if (start + size < reader.offset()) {
+            // Ops this old don't say how big they are, so we can't skip them.
+            break;
+        }
+        reader.skip(start + size - reader.offset());
+        if (offsets) {
+            offsets->push(SkToU32(start));
+        }
+        count++;
+    }
+    return count;
+}
+
+SkFlatPicture::SkFlatPicture(const SkRect& cull, const SkPictureData* data)
+    : fCullRect(cull)
+    , fData(data)   // Take ownership.
+    , fOpCount(0)
+{}
+
+void SkFlatPicture::countOps() const {
+    fCountOnce([this] {
+        fOpCount = count_ops(*fData, fData->bbh() ? &fOpOffsets : nullptr);
+    });
+}
+
+void SkFlatPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+
+    SkPicturePlayback playback(fData);
+
+    // If the query contains the whole picture, don't bother with the BBH.
+    SkRect clipBounds = { 0, 0, 0, 0 };
+    (void)canvas->getClipBounds(&clipBounds);
+    if (!fData->bbh() || clipBounds.contains(fCullRect)) {
+        playback.draw(canvas, callback, nullptr);
+        return;
+    }
+
+    this->countOps();
+    SkTDArray<int> ops;
+    fData->bbh()->search(clipBounds, &ops);
+
+    SkTDArray<uint32_t> offsets;
+    offsets.setReserve(ops.count());
+    for (int op : ops) {
+        if (op < fOpOffsets.count()) {
+            offsets.push(fOpOffsets[op]);
+        }
+    }
+    playback.drawOps(canvas, callback, offsets);
+}
+
+SkRect SkFlatPicture::cullRect()            const { return fCullRect; }
+bool   SkFlatPicture::willPlayBackBitmaps() const { return fData->containsBitmaps(); }
+int    SkFlatPicture::approximateOpCount()  const { this->countOps(); return fOpCount; }
+size_t SkFlatPicture::approximateBytesUsed() const {
+    this->countOps();
+    size_t bytes = sizeof(*this) + sizeof(SkPictureData) + fData->opData()->size() +
+                   fOpOffsets.reserved() * sizeof(uint32_t);
+    if (fData->bbh()) { bytes += fData->bbh()->bytesUsed(); }
+    return bytes;
+}
+
+// The ops aren't analyzed the way SkBigPicture's are, so we have no count of slow paths.
+int SkFlatPicture::numSlowPaths() const { return 0; }
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFlatPicture_DEFINED
+#define SkFlatPicture_DEFINED
+
+#include "SkOnce.h"
+#include "SkPicture.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+class SkPictureData;
+
+// An implementation of SkPicture that plays back the serialized ops of an SkPictureData as they
+// are, rather than re-recording them into an SkRecord first.
+class SkFlatPicture final : public SkPicture {
+public:
+    SkFlatPicture(const SkRect& cull,
+                  const SkPictureData*);    // We take ownership.
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override;
+    bool willPlayBackBitmaps() const override;
+    int approximateOpCount() const override;
+    size_t approximateBytesUsed() const override;
+
+private:
+    int numSlowPaths() const override;
+
+    // Walking the ops costs a pass over all of fData, so we wait until someone needs them.
+    void countOps() const;
+
+    const SkRect                        fCullRect;
+    SkAutoTDelete<const SkPictureData>  fData;
+    mutable SkOnce                      fCountOnce;
+    mutable SkTDArray<uint32_t>         fOpOffsets;  // Only filled in if fData has a BBH.
+    mutable int                         fOpCount;
+};
+
+#endif//SkFlatPicture_DEFINED
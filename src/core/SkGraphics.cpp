@@ -11,6 +11,7 @@
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkCpu.h"
+#include "SkEdgeCache.h"
 #include "SkGeometry.h"
 #include "SkGlyphCache.h"
 #include "SkImageFilter.h"
@@ -57,6 +58,14 @@ void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkGlyphCache::DumpMemoryStatistics(dump);
 }
 
+int SkGraphics::GetEdgeCacheHitCount() {
+    return SkEdgeCache::GetHitCount();
+}
+
+int SkGraphics::GetEdgeCacheMissCount() {
+    return SkEdgeCache::GetMissCount();
+}
+
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkLazyPicture.h"
+#include "SkPictureData.h"
+#include "SkStream.h"
+
+sk_sp<SkPicture> SkLazyPicture::Make(sk_sp<SkData> data, const Summary& summary,
+                                     const SkTypefacePlayback& typefaces) {
+    SkPictInfo info;
+    SkMemoryStream header(data->data(), data->size());
+    if (!SkPicture::InternalOnly_StreamIsSKP(&header, &info)) {
+        return nullptr;
+    }
+    return sk_sp<SkPicture>(new SkLazyPicture(info.fCullRect, summary, std::move(data),
+                                              typefaces));
+}
+
+SkLazyPicture::SkLazyPicture(const SkRect& cull, const Summary& summary, sk_sp<SkData> data,
+                             const SkTypefacePlayback& typefaces)
+    : fCullRect(cull)
+    , fSummary(summary)
+    , fData(std::move(data))
+{
+    // We may outlive the picture these typefaces belong to, so take our own refs.
+    fTypefaces.setCount(typefaces.count());
+    for (int i = 0; i < typefaces.count(); i++) {
+        fTypefaces.set(i, typefaces.get(i));
+    }
+}
+
+const SkPicture* SkLazyPicture::picture() const {
+    fOnce([this] {
+        SkMemoryStream stream(fData);
+        // MakeInPlace() only reads from the typefaces it's passed.
+        fPicture = SkPicture::MakeInPlace(&stream, nullptr,
+                                          const_cast<SkTypefacePlayback*>(&fTypefaces));
+    });
+    return fPicture.get();
+}
+
+void SkLazyPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+
+    if (const SkPicture* picture = this->picture()) {
+        picture->playback(canvas, callback);
+    }
+}
+
+SkRect SkLazyPicture::cullRect()            const { return fCullRect; }
+int    SkLazyPicture::approximateOpCount()  const { return fSummary.fOpCount; }
+bool   SkLazyPicture::willPlayBackBitmaps() const { return fSummary.fWillPlayBackBitmaps; }
+int    SkLazyPicture::numSlowPaths()        const { return fSummary.fNumSlowPaths; }
+
+size_t SkLazyPicture::approximateBytesUsed() const {
+    return sizeof(*this) + fData->size();
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLazyPicture_DEFINED
+#define SkLazyPicture_DEFINED
+
+#include "SkOnce.h"
+#include "SkPicture.h"
+#include "SkPictureFlat.h"
+#include "SkRect.h"
+
+class SkData;
+
+// An implementation of SkPicture that holds on to a serialized sub-picture and only parses it
+// when it's first played back.
+class SkLazyPicture final : public SkPicture {
+public:
+    // What the serialized parent picture records about each sub-picture, so we can answer
+    // SkPicture's queries without parsing it.
+    struct Summary {
+        int  fOpCount;
+        int  fNumSlowPaths;
+        bool fWillPlayBackBitmaps;
+    };
+
+    // data holds the whole serialized picture, header included.  Typefaces are those of the
+    // top-level picture, which sub-pictures share.  Images are made by the default
+    // SkImageDeserializer.  Returns nullptr if data has no valid header.
+    static sk_sp<SkPicture> Make(sk_sp<SkData> data, const Summary&,
+                                 const SkTypefacePlayback& typefaces);
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override;
+    bool willPlayBackBitmaps() const override;
+    int approximateOpCount() const override;
+    size_t approximateBytesUsed() const override;
+
+private:
+    SkLazyPicture(const SkRect& cull, const Summary&, sk_sp<SkData>, const SkTypefacePlayback&);
+
+    int numSlowPaths() const override;
+
+    // Parses fData the first time it's called.  May return nullptr if fData is bad.
+    const SkPicture* picture() const;
+
+    const SkRect                fCullRect;
+    const Summary               fSummary;
+    sk_sp<SkData>               fData;
+    SkTypefacePlayback          fTypefaces;
+
+    mutable SkOnce              fOnce;
+    mutable sk_sp<SkPicture>    fPicture;
+};
+
+#endif//SkLazyPicture_DEFINED
@@ -51,6 +51,17 @@ SkShader::Context* SkLocalMatrixShader::onCreateContext(const ContextRec& rec,
     return fProxyShader->createContext(newRec, storage);
 }
 
+bool SkLocalMatrixShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dstColorSpace,
+                                         SkArenaAlloc* alloc, const SkMatrix& ctm,
+                                         const SkPaint& paint, const SkMatrix* localM) const {
+    SkMatrix tmp;
+    if (localM) {
+        tmp.setConcat(*localM, this->getLocalMatrix());
+    }
+    return fProxyShader->appendStages(p, dstColorSpace, alloc, ctm, paint,
+                                      localM ? &tmp : &this->getLocalMatrix());
+}
+
 #ifndef SK_IGNORE_TO_STRING
 void SkLocalMatrixShader::toString(SkString* str) const {
     str->append("SkLocalMatrixShader: (");
@@ -47,6 +47,10 @@ protected:
         return fProxyShader->contextSize(rec);
     }
 
+    bool onAppendStages(SkRasterPipeline*, SkColorSpace*, SkArenaAlloc*,
+                        const SkMatrix& ctm, const SkPaint&,
+                        const SkMatrix* localM) const override;
+
     SkImage* onIsAImage(SkMatrix* matrix, TileMode* mode) const override {
         return fProxyShader->isAImage(matrix, mode);
     }
@@ -6,6 +6,11 @@
  */
 
 #include "SkMaskCache.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+
+std::atomic<bool> gSkUsePathMaskCache{false};
 
 #define CHECK_LOCAL(localCache, localName, globalName, ...) \
     ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
@@ -188,3 +193,104 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
     RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathMaskKeyNamespaceLabel;
+
+struct PathMaskKey : public SkResourceCache::Key {
+public:
+    PathMaskKey(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint)
+        : fScaleX(matrix.getScaleX())
+        , fSkewX(matrix.getSkewX())
+        , fTransX(matrix.getTranslateX())
+        , fSkewY(matrix.getSkewY())
+        , fScaleY(matrix.getScaleY())
+        , fTransY(matrix.getTranslateY())
+        , fStrokeWidth(paint.getStyle() == SkPaint::kFill_Style ? 0 : paint.getStrokeWidth())
+        , fStrokeMiter(paint.getStyle() == SkPaint::kFill_Style ? 0 : paint.getStrokeMiter())
+        , fFillType(path.getFillType())
+        , fStyle(paint.getStyle())
+        , fCap(paint.getStyle() == SkPaint::kFill_Style ? 0 : paint.getStrokeCap())
+        , fJoin(paint.getStyle() == SkPaint::kFill_Style ? 0 : paint.getStrokeJoin())
+    {
+        SkASSERT(!matrix.hasPerspective());
+        this->init(&gPathMaskKeyNamespaceLabel, path.getGenerationID(),
+                   sizeof(fScaleX) + sizeof(fSkewX) + sizeof(fTransX) + sizeof(fSkewY) +
+                   sizeof(fScaleY) + sizeof(fTransY) + sizeof(fStrokeWidth) +
+                   sizeof(fStrokeMiter) + sizeof(fFillType) + sizeof(fStyle) + sizeof(fCap) +
+                   sizeof(fJoin));
+    }
+
+    SkScalar    fScaleX;
+    SkScalar    fSkewX;
+    SkScalar    fTransX;
+    SkScalar    fSkewY;
+    SkScalar    fScaleY;
+    SkScalar    fTransY;
+    SkScalar    fStrokeWidth;
+    SkScalar    fStrokeMiter;
+    int32_t     fFillType;
+    int32_t     fStyle;
+    int32_t     fCap;
+    int32_t     fJoin;
+};
+
+struct PathMaskRec : public SkResourceCache::Rec {
+    PathMaskRec(const PathMaskKey& key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathMaskRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathMaskKey    fKey;
+    MaskValue      fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "path-mask"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathMaskRec& rec = static_cast<const PathMaskRec&>(baseRec);
+        MaskValue* result = static_cast<MaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                      const SkPaint& paint, SkMask* mask,
+                                      SkResourceCache* localCache) {
+    MaskValue result;
+    PathMaskKey key(path, matrix, paint);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathMaskRec::Visitor, &result)) {
+        return nullptr;
+    }
+
+    *mask = result.fMask;
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint,
+                      const SkMask& mask, SkCachedData* data, SkResourceCache* localCache) {
+    PathMaskKey key(path, matrix, paint);
+    return CHECK_LOCAL(localCache, add, Add, new PathMaskRec(key, mask, data));
+}
@@ -15,6 +15,15 @@
 #include "SkResourceCache.h"
 #include "SkRRect.h"
 
+#include <atomic>
+
+class SkMatrix;
+class SkPaint;
+class SkPath;
+
+// When set, SkDraw draws small anti-aliased paths through coverage masks kept in SkMaskCache.
+extern std::atomic<bool> gSkUsePathMaskCache;
+
 class SkMaskCache {
 public:
     /**
@@ -39,6 +48,18 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+
+    /**
+     * Anti-aliased coverage of path, transformed by matrix, and filled or stroked as paint says.
+     * Only the path's generation ID and fill type, and the paint's style and stroke parameters,
+     * are part of the key.
+     */
+    static SkCachedData* FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                    const SkPaint& paint, SkMask* mask,
+                                    SkResourceCache* localCache = nullptr);
+    static void Add(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint,
+                    const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
 };
 
 #endif
@@ -30,8 +30,9 @@ public:
 template <typename T>
 class SkMiniPicture final : public SkPicture {
 public:
-    SkMiniPicture(SkRect cull, T* op) : fCull(cull) {
+    SkMiniPicture(SkRect cull, T* op, const SkPaint& paint) : fCull(cull), fPaint(paint) {
         memcpy(&fOp, op, sizeof(fOp));  // We take ownership of op's guts.
+        fOp.paint = &fPaint;            // Our op shares our copy of its paint.
     }
 
     void playback(SkCanvas* c, AbortCallback*) const override {
@@ -49,8 +50,9 @@ public:
     }
 
 private:
-    SkRect fCull;
-    T      fOp;
+    SkRect  fCull;
+    SkPaint fPaint;
+    T       fOp;
 };
 
 
@@ -64,10 +66,12 @@ SkMiniRecorder::~SkMiniRecorder() {
     SkASSERT(fState == State::kEmpty);
 }
 
-#define TRY_TO_STORE(Type, ...)                    \
-    if (fState != State::kEmpty) { return false; } \
-    fState = State::k##Type;                       \
-    new (fBuffer.get()) Type{__VA_ARGS__};         \
+// Our ops' paints are all shared with fPaint.
+#define TRY_TO_STORE(Type, paint, ...)                 \
+    if (fState != State::kEmpty) { return false; }     \
+    fState = State::k##Type;                           \
+    fPaint = paint;                                    \
+    new (fBuffer.get()) Type{&fPaint, __VA_ARGS__};    \
     return true
 
 bool SkMiniRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
@@ -85,10 +89,14 @@ bool SkMiniRecorder::drawTextBlob(const SkTextBlob* b, SkScalar x, SkScalar y, c
 
 
 sk_sp<SkPicture> SkMiniRecorder::detachAsPicture(const SkRect& cull) {
-#define CASE(Type)              \
-    case State::k##Type:        \
-        fState = State::kEmpty; \
-        return sk_make_sp<SkMiniPicture<Type>>(cull, reinterpret_cast<Type*>(fBuffer.get()))
+#define CASE(Type)                                                                      \
+    case State::k##Type: {                                                              \
+        fState = State::kEmpty;                                                         \
+        auto pic = sk_make_sp<SkMiniPicture<Type>>(cull, reinterpret_cast<Type*>(fBuffer.get()), \
+                                                   fPaint);                             \
+        fPaint.reset();                                                                 \
+        return std::move(pic);                                                          \
+    }
 
     static SkOnce once;
     static SkPicture* empty;
@@ -113,6 +121,7 @@ void SkMiniRecorder::flushAndReset(SkCanvas* canvas) {
         Type* op = reinterpret_cast<Type*>(fBuffer.get());          \
         SkRecords::Draw(canvas, nullptr, nullptr, 0, nullptr)(*op); \
         op->~Type();                                                \
+        fPaint.reset();                                             \
     } return
 
     switch (fState) {
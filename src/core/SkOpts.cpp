@@ -42,6 +42,7 @@
 #include "SkBlurImageFilter_opts.h"
 #include "SkChecksum_opts.h"
 #include "SkColorCubeFilter_opts.h"
+#include "SkMaskSwizzler_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkSwizzler_opts.h"
@@ -85,6 +86,14 @@ namespace SkOpts {
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
 
+    DEFINE_DEFAULT(index_to_8888);
+    DEFINE_DEFAULT(mask16_to_RGB1);
+    DEFINE_DEFAULT(mask16_to_RGBA);
+    DEFINE_DEFAULT(mask16_to_rgbA);
+    DEFINE_DEFAULT(mask32_to_RGB1);
+    DEFINE_DEFAULT(mask32_to_RGBA);
+    DEFINE_DEFAULT(mask32_to_rgbA);
+
     DEFINE_DEFAULT(srcover_srgb_srgb);
 
     DEFINE_DEFAULT(hash_fn);
@@ -64,6 +64,21 @@ namespace SkOpts {
                         inverted_CMYK_to_RGB1, // i.e. convert color space
                         inverted_CMYK_to_BGR1; // i.e. convert color space
 
+    // Look up each of count 8-bit indices in a 256 entry table of 8888 colors.
+    extern void (*index_to_8888)(uint32_t dst[], const uint8_t src[], int count,
+                                 const uint32_t table[]);
+
+    // Unpack 16- or 32-bit pixels whose channels are picked out by bit masks, as in BMP.
+    // masks[] are in dst byte order, so {r,g,b,a} makes RGBA and {b,g,r,a} makes BGRA.
+    typedef void (*Swizzle_masked)(uint32_t dst[], const void* src, int count,
+                                   const uint32_t masks[4]);
+    extern Swizzle_masked mask16_to_RGB1,          // i.e. ignore the alpha mask
+                          mask16_to_RGBA,
+                          mask16_to_rgbA,          // i.e. premultiply
+                          mask32_to_RGB1,
+                          mask32_to_RGBA,
+                          mask32_to_rgbA;
+
     // Blend ndst src pixels over dst, where both src and dst point to sRGB pixels (RGBA or BGRA).
     // If nsrc < ndst, we loop over src to create a pattern.
     extern void (*srcover_srgb_srgb)(uint32_t* dst, const uint32_t* src, int ndst, int nsrc);
@@ -74,8 +89,8 @@ namespace SkOpts {
         return hash_fn(data, bytes, seed);
     }
 
-    extern
-    std::function<void(size_t, size_t)> (*compile_pipeline)(const SkRasterPipeline::Stage*, int);
+    extern std::function<void(size_t, size_t)>
+        (*compile_pipeline)(const SkRasterPipeline::Stage*, int, bool fuse);
 }
 
 #endif//SkOpts_DEFINED
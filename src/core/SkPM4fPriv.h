@@ -9,6 +9,7 @@
 #define SkPM4fPriv_DEFINED
 
 #include "SkColorPriv.h"
+#include "SkColorSpace.h"
 #include "SkPM4f.h"
 #include "SkSRGB.h"
 
@@ -55,6 +56,17 @@ static inline Sk4f Sk4f_from_SkColor(SkColor color) {
     return swizzle_rb(Sk4f_fromS32(color));
 }
 
+// The float color for an SkColor: linearized if we're drawing gamma-correctly, i.e. with a
+// destination color space, otherwise just scaled from bytes as in legacy drawing.
+static inline SkColor4f SkColor4f_from_SkColor(SkColor color, SkColorSpace* dstColorSpace) {
+    if (dstColorSpace) {
+        return SkColor4f::FromColor(color);
+    }
+    SkColor4f color4f;
+    swizzle_rb(Sk4f_fromL32(color)).store(&color4f);
+    return color4f;
+}
+
 static inline void assert_unit(float x) {
     SkASSERT(0 <= x && x <= 1);
 }
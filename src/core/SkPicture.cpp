@@ -6,6 +6,8 @@
  */
 
 #include "SkAtomics.h"
+#include "SkBigPicture.h"
+#include "SkFlatPicture.h"
 #include "SkImageDeserializer.h"
 #include "SkImageGenerator.h"
 #include "SkMessageBus.h"
@@ -14,6 +16,9 @@
 #include "SkPicturePlayback.h"
 #include "SkPictureRecord.h"
 #include "SkPictureRecorder.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRTree.h"
 
 #if defined(SK_DISALLOW_CROSSPROCESS_PICTUREIMAGEFILTERS) || \
     defined(SK_ENABLE_PICTURE_IO_SECURITY_PRECAUTIONS)
@@ -64,6 +69,15 @@ SkPicture::~SkPicture() {
     }
 }
 
+void SkPicture::playbackSkippingOccludedOps(SkCanvas* canvas, AbortCallback* callback) const {
+    // Only SkBigPictures know which of their ops are hidden.
+    if (const SkBigPicture* big = this->asSkBigPicture()) {
+        big->playback(canvas, callback, true);
+    } else {
+        this->playback(canvas, callback);
+    }
+}
+
 uint32_t SkPicture::uniqueID() const {
     static uint32_t gNextID = 1;
     uint32_t id = sk_atomic_load(&fUniqueID, sk_memory_order_relaxed);
@@ -190,10 +204,28 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, SkImageDeserializer
     return MakeFromStream(&stream, factory, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromDataInPlace(sk_sp<SkData> data,
+                                                SkImageDeserializer* factory) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(std::move(data));
+    return MakeInPlace(&stream, factory, nullptr);
+}
+
+// Whether picture data follows the header.  Since V51 this is a whole 32-bit word, which keeps
+// everything after the header 4-byte aligned.
+static bool read_has_data(SkStream* stream, const SkPictInfo& info) {
+    if (info.getVersion() < SkReadBuffer::kAlignedPictureSections_Version) {
+        return stream->readBool();
+    }
+    return stream->readU32() != 0;
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, SkImageDeserializer* factory,
                                            SkTypefacePlayback* typefaces) {
     SkPictInfo info;
-    if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
+    if (!InternalOnly_StreamIsSKP(stream, &info) || !read_has_data(stream, info)) {
         return nullptr;
     }
     SkAutoTDelete<SkPictureData> data(
@@ -201,6 +233,25 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, SkImageDeserializer
     return Forwardport(info, data, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeInPlace(SkMemoryStream* stream, SkImageDeserializer* factory,
+                                        SkTypefacePlayback* typefaces) {
+    SkPictInfo info;
+    if (!InternalOnly_StreamIsSKP(stream, &info) || !read_has_data(stream, info)) {
+        return nullptr;
+    }
+    if (info.getVersion() < SkReadBuffer::kAlignedPictureSections_Version) {
+        // Nothing is sure to be aligned well enough to read where it is, so copy it all out.
+        SkAutoTDelete<SkPictureData> data(
+                SkPictureData::CreateFromStream(stream, info, factory, typefaces));
+        return Forwardport(info, data, nullptr);
+    }
+    SkPictureData* data = SkPictureData::CreateInPlace(stream, info, factory, typefaces);
+    if (!data) {
+        return nullptr;
+    }
+    return sk_make_sp<SkFlatPicture>(info.fCullRect, data);
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromBuffer(SkReadBuffer& buffer) {
     SkPictInfo info;
     if (!InternalOnly_BufferIsSKP(&buffer, &info) || !buffer.readBool()) {
@@ -210,13 +261,68 @@ sk_sp<SkPicture> SkPicture::MakeFromBuffer(SkReadBuffer& buffer) {
     return Forwardport(info, data, &buffer);
 }
 
-SkPictureData* SkPicture::backport() const {
+// Index each op in data by the bounds of the op in big it was played back from.  ends[i] is how
+// many bytes of ops had been written once big's op i was played back, and start how many had
+// been before the first.  Ops outside those (the initial save and final restore) may cover the
+// whole picture.
+static sk_sp<SkRTree> backport_bbh(const SkBigPicture& big, const SkPictureData& data,
+                                   size_t start, const size_t ends[]) {
+    const SkRecord& record = *big.record();
+    SkAutoTMalloc<SkRect> bounds(record.count());
+    SkRecordFillBounds(big.cullRect(), record, bounds);
+
+    SkTDArray<SkRect> opBounds;
+    SkReadBuffer reader(data.opData()->bytes(), data.opData()->size());
+    int i = 0;
+    while (!reader.eof() && reader.isValid()) {
+        const size_t offset = reader.offset();
+        uint32_t size;
+        SkPicturePlayback::ReadOpAndSize(&reader, &size);
+        reader.skip(offset + size - reader.offset());
+
+        while (i < record.count() && ends[i] <= offset) {
+            i++;
+        }
+        opBounds.push(offset >= start && i < record.count() ? bounds[i] : big.cullRect());
+    }
+
+    const SkRect& cull = big.cullRect();
+    sk_sp<SkRTree> bbh(new SkRTree(cull.width() / cull.height()));
+    bbh->insert(opBounds.begin(), opBounds.count());
+    return bbh;
+}
+
+SkPictureData* SkPicture::backport(bool withBBH) const {
     SkPictInfo info = this->createHeader();
     SkPictureRecord rec(SkISize::Make(info.fCullRect.width(), info.fCullRect.height()), 0/*flags*/);
     rec.beginRecording();
+
+    const SkBigPicture* big = withBBH ? this->asSkBigPicture() : nullptr;
+    if (big && (!big->bbh() || big->cullRect().isEmpty())) {
+        big = nullptr;
+    }
+    size_t start = 0;
+    SkAutoTMalloc<size_t> ends;
+    if (big) {
+        // Play back one op at a time, so we know which of rec's ops came from which of ours.
+        const SkRecord& record = *big->record();
+        start = rec.writeStream().bytesWritten();
+        ends.reset(record.count());
+        SkRecords::Draw draw(&rec, big->drawablePicts(), nullptr, big->drawableCount());
+        for (int i = 0; i < record.count(); i++) {
+            record.visit(i, draw);
+            ends[i] = rec.writeStream().bytesWritten();
+        }
+    } else {
         this->playback(&rec);
+    }
+
     rec.endRecording();
-    return new SkPictureData(rec, info);
+    SkPictureData* data = new SkPictureData(rec, info);
+    if (big) {
+        data->setBBH(backport_bbh(*big, *data, start, ends));
+    }
+    return data;
 }
 
 void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer) const {
@@ -233,14 +339,14 @@ void SkPicture::serialize(SkWStream* stream,
                           SkPixelSerializer* pixelSerializer,
                           SkRefCntSet* typefaceSet) const {
     SkPictInfo info = this->createHeader();
-    SkAutoTDelete<SkPictureData> data(this->backport());
+    SkAutoTDelete<SkPictureData> data(this->backport(true));
 
     stream->write(&info, sizeof(info));
     if (data) {
-        stream->writeBool(true);
+        stream->write32(true);
         data->serialize(stream, pixelSerializer, typefaceSet);
     } else {
-        stream->writeBool(false);
+        stream->write32(false);
     }
 }
 
@@ -6,9 +6,11 @@
  */
 #include <new>
 #include "SkImageGenerator.h"
+#include "SkLazyPicture.h"
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -177,6 +179,13 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Since V51 sections are padded out to keep the ones after them 4-byte aligned.
+static void write_padding(SkWStream* stream, size_t size) {
+    static const char kZeros[3] = { 0, 0, 0 };
+    SkASSERT(size < sizeof(kZeros) + 1);
+    stream->write(kZeros, size);
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -184,7 +193,8 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     SkFlattenable::Factory* array = (SkFlattenable::Factory*)storage.get();
     rec.copyToArray(array);
 
-    size_t size = compute_chunk_size(array, count);
+    size_t unpadded = compute_chunk_size(array, count);
+    size_t size = SkAlign4(unpadded);
 
     // TODO: write_tag_size should really take a size_t
     write_tag_size(stream, SK_PICT_FACTORY_TAG, (uint32_t) size);
@@ -201,6 +211,7 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
             stream->write(name, len);
         }
     }
+    write_padding(stream, size - unpadded);
 
     SkASSERT(size == (stream->bytesWritten() - start));
 }
@@ -214,9 +225,15 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     SkTypeface** array = (SkTypeface**)storage.get();
     rec.copyToArray((SkRefCnt**)array);
 
+    // The typefaces are preceded by their (padded) size in bytes.
+    SkDynamicMemoryWStream typefaces;
     for (int i = 0; i < count; i++) {
-        array[i]->serialize(stream);
+        array[i]->serialize(&typefaces);
     }
+    size_t unpadded = typefaces.bytesWritten();
+    stream->write32(SkToU32(SkAlign4(unpadded)));
+    typefaces.writeToStream(stream);
+    write_padding(stream, SkAlign4(unpadded) - unpadded);
 }
 
 void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
@@ -259,6 +276,14 @@ void SkPictureData::serialize(SkWStream* stream,
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
+    if (fBBH) {
+        SkDynamicMemoryWStream bbh;
+        fBBH->writeToStream(&bbh);
+        SkASSERT(SkIsAlign4(bbh.bytesWritten()));
+        write_tag_size(stream, SK_PICT_BBH_TAG, bbh.bytesWritten());
+        bbh.writeToStream(stream);
+    }
+
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
     SkRefCntSet* typefaceSet = topLevelTypeFaceSet ? topLevelTypeFaceSet : &localTypefaceSet;
@@ -270,18 +295,16 @@ void SkPictureData::serialize(SkWStream* stream,
     buffer.setFactoryRecorder(&factSet);
     buffer.setPixelSerializer(sk_ref_sp(pixelSerializer));
     buffer.setTypefaceRecorder(typefaceSet);
+    // Encoding is usually most of the work here, and each image can be encoded independently.
+    buffer.encodeImages(fImageRefs, fImageCount);
     this->flattenToBuffer(buffer);
 
-    // Dummy serialize our sub-pictures for the side effect of filling
-    // typefaceSet with typefaces from sub-pictures.
-    struct DevNull: public SkWStream {
-        DevNull() : fBytesWritten(0) {}
-        size_t fBytesWritten;
-        bool write(const void*, size_t size) override { fBytesWritten += size; return true; }
-        size_t bytesWritten() const override { return fBytesWritten; }
-    } devnull;
+    // Serialize our sub-pictures now, filling typefaceSet with their typefaces, but hold on to
+    // them to write after our own data.  Typefaces already in the set keep their index, so
+    // these bytes are what serializing them again later would produce.
+    SkAutoTArray<SkDynamicMemoryWStream> pictures(fPictureCount);
     for (int i = 0; i < fPictureCount; i++) {
-        fPictureRefs[i]->serialize(&devnull, pixelSerializer, typefaceSet);
+        fPictureRefs[i]->serialize(&pictures[i], pixelSerializer, typefaceSet);
     }
 
     // We need to write factories before we write the buffer.
@@ -295,11 +318,18 @@ void SkPictureData::serialize(SkWStream* stream,
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
-    // Write sub-pictures by calling serialize again.
+    // Write sub-pictures.
     if (fPictureCount > 0) {
+        // Each sub-picture is preceded by its size and what playback wants to know about it
+        // up front, so it can be skipped over and loaded lazily.
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictureCount);
         for (int i = 0; i < fPictureCount; i++) {
-            fPictureRefs[i]->serialize(stream, pixelSerializer, typefaceSet);
+            SkASSERT(SkIsAlign4(pictures[i].bytesWritten()));
+            stream->write32(SkToU32(pictures[i].bytesWritten()));
+            stream->write32(SkToU32(fPictureRefs[i]->approximateOpCount()));
+            stream->write32(SkToU32(fPictureRefs[i]->numSlowPaths()));
+            stream->write32(fPictureRefs[i]->willPlayBackBitmaps());
+            pictures[i].writeToStream(stream);
         }
     }
 
@@ -354,11 +384,34 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// If the next size bytes of stream can be read where they lie in its memory, return them.
+static const void* in_place(SkMemoryStream* stream, size_t size) {
+    if (!stream || stream->getLength() - stream->getPosition() < size) {
+        return nullptr;
+    }
+    const void* bytes = stream->getAtPos();
+    return SkIsAlign4((uintptr_t)bytes) ? bytes : nullptr;
+}
+
+static void read_typefaces(SkStream* stream, int count, SkTypefacePlayback* playback) {
+    playback->setCount(count);
+    for (int i = 0; i < count; i++) {
+        sk_sp<SkTypeface> tf(SkTypeface::MakeDeserialize(stream));
+        if (!tf.get()) {    // failed to deserialize
+            // fTFPlayback asserts it never has a null, so we plop in
+            // the default here.
+            tf = SkTypeface::MakeDefault();
+        }
+        playback->set(i, tf.get());
+    }
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    SkImageDeserializer* factory,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   SkMemoryStream* inPlace) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -369,20 +422,59 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
      *  factories or typefaces.
      */
     SkDEBUGCODE(bool haveBuffer = false;)
+    const bool aligned = fInfo.getVersion() >= SkReadBuffer::kAlignedPictureSections_Version;
 
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            if (in_place(inPlace, size)) {
+                fOpData = SkData::MakeSubset(inPlace->asData().get(), inPlace->getPosition(),
+                                             size);
+                if (inPlace->skip(size) != size) {
+                    return false;
+                }
+            } else {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_BBH_TAG: {
+            if (fInfo.getVersion() < SkReadBuffer::kPictureBBH_Version) {
+                return false;
+            }
+            if (!inPlace) {
+                // Only in-place playback culls with it; anything else is re-recorded.
+                if (stream->skip(size) != size) {
+                    return false;
+                }
+                break;
+            }
+            SkMemoryStream bbh;
+            if (const void* bytes = in_place(inPlace, size)) {
+                bbh.setMemory(bytes, size);
+                if (inPlace->skip(size) != size) {
+                    return false;
+                }
+            } else {
+                sk_sp<SkData> data(SkData::MakeFromStream(stream, size));
+                if (!data) {
+                    return false;
+                }
+                bbh.setData(std::move(data));
+            }
+            fBBH.reset(SkRTree::CreateFromStream(&bbh));
+            if (!fBBH || !bbh.isAtEnd()) {
+                return false;
+            }
+        } break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
-            size = stream->readU32();
-            fFactoryPlayback = new SkFactoryPlayback(size);
-            for (size_t i = 0; i < size; i++) {
+            const uint32_t count = stream->readU32();
+            size_t bytesRead = sizeof(count);
+            fFactoryPlayback = new SkFactoryPlayback(count);
+            for (size_t i = 0; i < count; i++) {
                 SkString str;
                 const size_t len = stream->readPackedUInt();
                 str.resize(len);
@@ -390,27 +482,65 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                     return false;
                 }
                 fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
+                bytesRead += SkWStream::SizeOfPackedUInt(len) + len;
+            }
+            if (aligned) {
+                if (bytesRead > size || stream->skip(size - bytesRead) != size - bytesRead) {
+                    return false;
+                }
             }
         } break;
         case SK_PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
             const int count = SkToInt(size);
-            fTFPlayback.setCount(count);
-            for (int i = 0; i < count; i++) {
-                sk_sp<SkTypeface> tf(SkTypeface::MakeDeserialize(stream));
-                if (!tf.get()) {    // failed to deserialize
-                    // fTFPlayback asserts it never has a null, so we plop in
-                    // the default here.
-                    tf = SkTypeface::MakeDefault();
+            if (!aligned) {
+                read_typefaces(stream, count, &fTFPlayback);
+                break;
+            }
+            const uint32_t length = stream->readU32();
+            if (const void* bytes = in_place(inPlace, length)) {
+                SkMemoryStream typefaces(bytes, length);
+                read_typefaces(&typefaces, count, &fTFPlayback);
+                if (inPlace->skip(length) != length) {
+                    return false;
+                }
+            } else {
+                sk_sp<SkData> data(SkData::MakeFromStream(stream, length));
+                if (!data) {
+                    return false;
                 }
-                fTFPlayback.set(i, tf.get());
+                SkMemoryStream typefaces(std::move(data));
+                read_typefaces(&typefaces, count, &fTFPlayback);
             }
         } break;
         case SK_PICT_PICTURE_TAG: {
+            const bool sized = fInfo.getVersion() >= SkReadBuffer::kLazySubPictures_Version;
             fPictureCount = 0;
             fPictureRefs = new const SkPicture* [size];
             for (uint32_t i = 0; i < size; i++) {
-                fPictureRefs[i] = SkPicture::MakeFromStream(stream, factory, topLevelTFPlayback).release();
+                uint32_t length = 0;
+                SkLazyPicture::Summary summary = { 0, 0, false };
+                if (sized) {
+                    length = stream->readU32();
+                    summary.fOpCount = SkToInt(stream->readU32());
+                    summary.fNumSlowPaths = SkToInt(stream->readU32());
+                    summary.fWillPlayBackBitmaps = SkToBool(stream->readU32());
+                }
+                // We can't hold on to the caller's factory past this call, so only sub-pictures
+                // using the default one are left unparsed until they're played back.
+                if (sized && !factory && in_place(inPlace, length)) {
+                    sk_sp<SkData> data(SkData::MakeSubset(inPlace->asData().get(),
+                                                          inPlace->getPosition(), length));
+                    if (inPlace->skip(length) != length) {
+                        return false;
+                    }
+                    fPictureRefs[i] = SkLazyPicture::Make(std::move(data), summary,
+                                                          *topLevelTFPlayback).release();
+                } else {
+                    fPictureRefs[i] = inPlace
+                        ? SkPicture::MakeInPlace(inPlace, factory, topLevelTFPlayback).release()
+                        : SkPicture::MakeFromStream(stream, factory, topLevelTFPlayback).release();
+                }
                 if (!fPictureRefs[i]) {
                     return false;
                 }
@@ -418,13 +548,22 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* bytes = in_place(inPlace, size);
+            if (bytes) {
+                if (inPlace->skip(size) != size) {
+                    return false;
+                }
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+                bytes = storage.get();
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.getVersion());
 
@@ -458,10 +597,6 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     return true;    // success
 }
 
-static const SkImage* create_image_from_buffer(SkReadBuffer& buffer) {
-    return buffer.readImage().release();
-}
-
 static const SkImage* create_bitmap_image_from_buffer(SkReadBuffer& buffer) {
     return buffer.readBitmapAsImage().release();
 }
@@ -510,6 +645,52 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
+// Like new_array_from_buffer(), for images.  Reading them is quick, but making them may mean
+// decoding, so we make them all at once.  A caller's deserializer may not expect to be called
+// from several threads, so only the default one is.
+static bool new_images_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
+                                   const SkImage*** array, int* outCount) {
+    if (!buffer.validate((0 == *outCount) && (nullptr == *array))) {
+        return false;
+    }
+    if (0 == inCount) {
+        return true;
+    }
+    // Each image takes at least a word to serialize, so don't trust a count that can't fit.
+    if (!buffer.validate(inCount <= (buffer.size() - buffer.offset()) / sizeof(uint32_t))) {
+        return false;
+    }
+    const int count = SkToInt(inCount);
+    SkAutoTArray<SkReadBuffer::EncodedImage> encoded(count);
+    for (int i = 0; i < count; i++) {
+        if (!buffer.readEncodedImage(&encoded[i])) {
+            return false;
+        }
+    }
+
+    SkAutoTArray<sk_sp<SkImage>> images(count);
+    auto make = [&](int i) { images[i] = buffer.makeImage(encoded[i]); };
+    if (buffer.canMakeImagesInParallel()) {
+        SkTaskGroup().batch(count, make);
+    } else {
+        for (int i = 0; i < count; i++) {
+            make(i);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (!images[i]) {
+            return false;
+        }
+    }
+
+    *outCount = count;
+    *array = new const SkImage* [count];
+    for (int i = 0; i < count; i++) {
+        (*array)[i] = images[i].release();
+    }
+    return true;
+}
+
 bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
     switch (tag) {
         case SK_PICT_BITMAP_BUFFER_TAG:
@@ -540,8 +721,7 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             }
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            if (!new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
-                                       create_image_from_buffer)) {
+            if (!new_images_from_buffer(buffer, size, &fImageRefs, &fImageCount)) {
                 return false;
             }
             break;
@@ -588,6 +768,23 @@ SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
     return data.release();
 }
 
+SkPictureData* SkPictureData::CreateInPlace(SkMemoryStream* stream,
+                                            const SkPictInfo& info,
+                                            SkImageDeserializer* factory,
+                                            SkTypefacePlayback* topLevelTFPlayback) {
+    SkAutoTDelete<SkPictureData> data(new SkPictureData(info));
+    if (!topLevelTFPlayback) {
+        topLevelTFPlayback = &data->fTFPlayback;
+    }
+
+    if (!data->parseStream(stream, factory, topLevelTFPlayback, stream)) {
+        return nullptr;
+    }
+    // We'll be played back directly, without first being re-recorded.
+    data->initForPlayback();
+    return data.release();
+}
+
 SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
                                                const SkPictInfo& info) {
     SkAutoTDelete<SkPictureData> data(new SkPictureData(info));
@@ -601,7 +798,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 SkImageDeserializer* factory,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                SkMemoryStream* inPlace) {
     for (;;) {
         uint32_t tag = stream->readU32();
         if (SK_PICT_EOF_TAG == tag) {
@@ -609,7 +807,7 @@ bool SkPictureData::parseStream(SkStream* stream,
         }
 
         uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, tag, size, factory, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, factory, topLevelTFPlayback, inPlace)) {
             return false; // we're invalid
         }
     }
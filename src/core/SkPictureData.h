@@ -13,8 +13,10 @@
 #include "SkPicture.h"
 #include "SkPictureContentInfo.h"
 #include "SkPictureFlat.h"
+#include "SkRTree.h"
 
 class SkData;
+class SkMemoryStream;
 class SkPictureRecord;
 class SkPixelSerializer;
 class SkReader32;
@@ -60,6 +62,7 @@ public:
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
 #define SK_PICT_PICTURE_TAG    SkSetFourByteTag('p', 'c', 't', 'r')
 #define SK_PICT_DRAWABLE_TAG   SkSetFourByteTag('d', 'r', 'a', 'w')
+#define SK_PICT_BBH_TAG        SkSetFourByteTag('b', 'b', 'h', ' ')
 
 // This tag specifies the size of the ReadBuffer, needed for the following tags
 #define SK_PICT_BUFFER_SIZE_TAG     SkSetFourByteTag('a', 'r', 'a', 'y')
@@ -82,6 +85,13 @@ public:
                                            SkImageDeserializer*,
                                            SkTypefacePlayback*);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
+    // Like CreateFromStream(), but reads each section where it lies in the stream's memory,
+    // sharing the op stream with it rather than copying it out.  Nested pictures are left
+    // unparsed until they're first played back.
+    static SkPictureData* CreateInPlace(SkMemoryStream*,
+                                        const SkPictInfo&,
+                                        SkImageDeserializer*,
+                                        SkTypefacePlayback*);
 
     virtual ~SkPictureData();
 
@@ -96,11 +106,18 @@ public:
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    // If the picture was recorded with a BBH, this indexes each op in opData() by its bounds, so
+    // playback can skip those outside the clip.
+    const SkRTree* bbh() const { return fBBH.get(); }
+    void setBBH(sk_sp<SkRTree> bbh) { fBBH = std::move(bbh); }
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
-    // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*);
+    // Does not affect ownership of SkStream.  If inPlace is not null, it is the same stream,
+    // and sections are read where they lie in its memory when they can be.
+    bool parseStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*,
+                     SkMemoryStream* inPlace = nullptr);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -167,7 +184,7 @@ private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
-                        SkImageDeserializer*, SkTypefacePlayback*);
+                        SkImageDeserializer*, SkTypefacePlayback*, SkMemoryStream* inPlace);
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
@@ -175,6 +192,7 @@ private:
     SkTArray<SkPath>   fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    sk_sp<SkRTree>  fBBH;       // bounds of the ops in fOpData, by index
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
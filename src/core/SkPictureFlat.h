@@ -154,6 +154,10 @@ public:
 
     void setCount(int count);
     SkRefCnt* set(int index, SkRefCnt*);
+    SkRefCnt* get(int index) const {
+        SkASSERT((unsigned)index < (unsigned)fCount);
+        return fArray[index];
+    }
 
     void setupBuffer(SkReadBuffer& buffer) const {
         buffer.setTypefaceArray((SkTypeface**)fArray, fCount);
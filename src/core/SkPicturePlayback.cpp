@@ -121,6 +121,46 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
     }
 }
 
+void SkPicturePlayback::drawOps(SkCanvas* canvas,
+                                SkPicture::AbortCallback* callback,
+                                const SkTDArray<uint32_t>& offsets) {
+    AutoResetOpID aroi(this);
+    SkASSERT(0 == fCurOffset);
+
+    SkReadBuffer reader(fPictureData->opData()->bytes(), fPictureData->opData()->size());
+
+    // Record this, so we can concat w/ it if we encounter a setMatrix()
+    SkMatrix initialMatrix = canvas->getTotalMatrix();
+
+    SkAutoCanvasRestore acr(canvas, false);
+
+    for (uint32_t offset : offsets) {
+        if (callback && callback->abort()) {
+            return;
+        }
+        // A clip that came up empty may have skipped us past this op already.
+        if (offset < reader.offset()) {
+            continue;
+        }
+        if (offset >= fPictureData->opData()->size()) {
+            return;
+        }
+        reader.skip(offset - reader.offset());
+
+        fCurOffset = reader.offset();
+        uint32_t size;
+        DrawType op = ReadOpAndSize(&reader, &size);
+        if (!reader.validate(op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+            return;
+        }
+
+        this->handleOp(&reader, op, size, canvas, initialMatrix);
+        if (!reader.isValid()) {
+            return;
+        }
+    }
+}
+
 void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                                  DrawType op,
                                  uint32_t size,
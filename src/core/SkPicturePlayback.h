@@ -25,12 +25,18 @@ public:
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // Like draw(), but only plays back the ops starting at these offsets into the op data,
+    // which must be in increasing order.
+    void drawOps(SkCanvas* canvas, SkPicture::AbortCallback*, const SkTDArray<uint32_t>& offsets);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
     size_t curOpID() const { return fCurOffset; }
     void resetOpID() { fCurOffset = 0; }
 
+    static DrawType ReadOpAndSize(SkReadBuffer* reader, uint32_t* size);
+
 protected:
     const SkPictureData* fPictureData;
 
@@ -43,8 +49,6 @@ protected:
                   SkCanvas* canvas,
                   const SkMatrix& initialMatrix);
 
-    static DrawType ReadOpAndSize(SkReadBuffer* reader, uint32_t* size);
-
     class AutoResetOpID {
     public:
         AutoResetOpID(SkPicturePlayback* playback) : fPlayback(playback) { }
@@ -11,6 +11,7 @@
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
 #include "SkRecord.h"
+#include "SkRecordDiff.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
 #include "SkRecordedDrawable.h"
@@ -20,6 +21,8 @@
 SkPictureRecorder::SkPictureRecorder() {
     fActivelyRecording = false;
     fRecorder.reset(new SkRecorder(nullptr, SkRect::MakeWH(0, 0), &fMiniRecorder));
+    fPrevCullRect.setEmpty();
+    fDamageRect.setEmpty();
 }
 
 SkPictureRecorder::~SkPictureRecorder() {}
@@ -35,13 +38,17 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& cullRect,
         SkASSERT(fBBH.get());
     }
 
-    if (!fRecord) {
+    // An incremental recording finished as null may have left fRecord as fPrevRecord, which we
+    // must not append to.
+    if (!fRecord || fRecord == fPrevRecord) {
         fRecord.reset(new SkRecord);
     }
     SkRecorder::DrawPictureMode dpm = (recordFlags & kPlaybackDrawPicture_RecordFlag)
         ? SkRecorder::Playback_DrawPictureMode
         : SkRecorder::Record_DrawPictureMode;
-    fRecorder->reset(fRecord.get(), cullRect, dpm, &fMiniRecorder);
+    // Incremental recordings always go into fRecord, so that there's something to diff against.
+    SkMiniRecorder* mr = (recordFlags & kIncremental_RecordFlag) ? nullptr : &fMiniRecorder;
+    fRecorder->reset(fRecord.get(), cullRect, dpm, mr);
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
@@ -54,7 +61,8 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
-    if (fRecord->count() == 0) {
+    const bool incremental = SkToBool(fFlags & kIncremental_RecordFlag);
+    if (fRecord->count() == 0 && !incremental) {
         if (finishFlags & kReturnNullForEmpty_FinishFlag) {
             return nullptr;
         }
@@ -64,6 +72,16 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     // TODO: delay as much of this work until just before first playback?
     SkRecordOptimize(fRecord.get());
 
+    SkAutoTMalloc<SkRect> bounds;
+    if (fBBH.get() || (fFlags & (kOcclusionCulling_RecordFlag | kIncremental_RecordFlag))) {
+        bounds.reset(fRecord->count());
+        SkRecordFillBounds(fCullRect, *fRecord, bounds);
+    }
+    bool bbhIsFilled = false;
+    if (incremental) {
+        bbhIsFilled = this->diffAgainstPrevious(bounds);
+    }
+
     if (fRecord->count() == 0) {
         if (finishFlags & kReturnNullForEmpty_FinishFlag) {
             return nullptr;
@@ -74,10 +92,20 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     SkBigPicture::SnapshotArray* pictList =
         drawableList ? drawableList->newDrawableSnapshot() : nullptr;
 
+    SkTDArray<int>* occludedOps = nullptr;
+    if (fFlags & kOcclusionCulling_RecordFlag) {
+        occludedOps = new SkTDArray<int>;
+        SkRecordComputeOccludedOps(*fRecord, bounds, occludedOps);
+        if (occludedOps->isEmpty()) {
+            delete occludedOps;
+            occludedOps = nullptr;
+        }
+    }
+
     if (fBBH.get()) {
-        SkAutoTMalloc<SkRect> bounds(fRecord->count());
-        SkRecordFillBounds(fCullRect, *fRecord, bounds);
-        fBBH->insert(bounds, fRecord->count());
+        if (!bbhIsFilled) {
+            fBBH->insert(bounds, fRecord->count());
+        }
 
         // Now that we've calculated content bounds, we can update fCullRect, often trimming it.
         // TODO: get updated fCullRect from bounds instead of forcing the BBH to return it?
@@ -92,7 +120,39 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
         subPictureBytes += SkPictureUtils::ApproximateBytesUsed(pictList->begin()[i]);
     }
     return sk_make_sp<SkBigPicture>(fCullRect, fRecord.release(), pictList, fBBH.release(),
-                                    subPictureBytes);
+                                    subPictureBytes, occludedOps);
+}
+
+bool SkPictureRecorder::diffAgainstPrevious(const SkRect bounds[]) {
+    const int count = fRecord->count();
+    bool bbhIsFilled = false;
+    bool identical = false;
+
+    if (fPrevRecord && fPrevCullRect == fCullRect) {
+        fDamageRect = SkRecordComputeDamage(*fPrevRecord, fPrevBounds, *fRecord, bounds,
+                                            &identical);
+        if (fBBH && fPrevBBH && fPrevRecord->count() == count &&
+            0 == memcmp(fPrevBounds.get(), bounds, count * sizeof(SkRect))) {
+            // Every op lands just where it did last time, so the old hierarchy still indexes them.
+            fBBH = fPrevBBH;
+            bbhIsFilled = true;
+        }
+    } else {
+        fDamageRect = fCullRect;
+    }
+
+    if (identical) {
+        // The last picture already holds an equivalent record, so share that one.
+        fRecord = fPrevRecord;
+    } else {
+        fPrevRecord = fRecord;
+        fPrevBounds.reset(count);
+        memcpy(fPrevBounds.get(), bounds, count * sizeof(SkRect));
+        fPrevCullRect = fCullRect;
+    }
+    // If this is a new hierarchy, our caller fills it in before anyone else can see it.
+    fPrevBBH = fBBH;
+    return bbhIsFilled;
 }
 
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPictureWithCull(const SkRect& cullRect,
@@ -130,6 +190,7 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFl
         }
     }
 
+    // Drawables are never played back skipping occluded ops, so there's no need to find them.
     if (fBBH.get()) {
         SkAutoTMalloc<SkRect> bounds(fRecord->count());
         SkRecordFillBounds(fCullRect, *fRecord, bounds);
@@ -5,18 +5,54 @@
  * found in the LICENSE file.
  */
 
+#include "SkNx.h"
 #include "SkRTree.h"
+#include "SkStream.h"
 
-SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
+SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio), fRoot(0) {}
 
 SkRect SkRTree::getRootBound() const {
     if (fCount) {
-        return fRoot.fBounds;
+        return fRootBounds;
     } else {
         return SkRect::MakeEmpty();
     }
 }
 
+void SkRTree::Node::init(uint16_t level) {
+    // Inverted bounds, so that unused slots never intersect anything.
+    for (int i = 0; i < kPaddedChildren; i++) {
+        fLeft[i]  = fTop[i]    =  SK_FloatInfinity;
+        fRight[i] = fBottom[i] = -SK_FloatInfinity;
+        fChildren[i] = 0;
+    }
+    fNumChildren = 0;
+    fLevel = level;
+}
+
+void SkRTree::Node::addChild(int index, const SkRect& bounds) {
+    SkASSERT(fNumChildren < kMaxChildren);
+    const int i = fNumChildren++;
+    fLeft[i]   = bounds.fLeft;
+    fTop[i]    = bounds.fTop;
+    fRight[i]  = bounds.fRight;
+    fBottom[i] = bounds.fBottom;
+    fChildren[i] = index;
+}
+
+uint32_t SkRTree::Node::intersect(const SkRect& query) const {
+    const Sk4f l(query.fLeft), t(query.fTop), r(query.fRight), b(query.fBottom);
+    uint32_t mask = 0;
+    for (int i = 0; i < kPaddedChildren; i += 4) {
+        // As in SkRect::Intersects(), the overlap must be non-empty both ways.
+        Sk4f overlapX = Sk4f::Max(Sk4f::Load(fLeft + i), l) < Sk4f::Min(Sk4f::Load(fRight  + i), r),
+             overlapY = Sk4f::Max(Sk4f::Load(fTop  + i), t) < Sk4f::Min(Sk4f::Load(fBottom + i), b);
+        Sk4f bits = overlapX.thenElse(overlapY.thenElse(Sk4f(1, 2, 4, 8), Sk4f(0)), Sk4f(0));
+        mask |= (uint32_t)(bits[0] + bits[1] + bits[2] + bits[3]) << i;
+    }
+    return mask;
+}
+
 void SkRTree::insert(const SkRect boundsArray[], int N) {
     SkASSERT(0 == fCount);
 
@@ -31,32 +67,32 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
 
         Branch* b = branches.push();
         b->fBounds = bounds;
-        b->fOpIndex = i;
+        b->fIndex = i;
     }
 
     fCount = branches.count();
     if (fCount) {
         if (1 == fCount) {
             fNodes.setReserve(1);
-            Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
+            fRoot = this->allocateNodeAtLevel(0);
+            fNodes[fRoot].addChild(branches[0].fIndex, branches[0].fBounds);
+            fRootBounds = branches[0].fBounds;
         } else {
             fNodes.setReserve(CountNodes(fCount, fAspectRatio));
-            fRoot = this->bulkLoad(&branches);
+            Branch root = this->bulkLoad(&branches);
+            fRoot       = root.fIndex;
+            fRootBounds = root.fBounds;
+            this->sortBreadthFirst();
         }
     }
 }
 
-SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
+int SkRTree::allocateNodeAtLevel(uint16_t level) {
     SkDEBUGCODE(Node* p = fNodes.begin());
     Node* out = fNodes.push();
     SkASSERT(fNodes.begin() == p);  // If this fails, we didn't setReserve() enough.
-    out->fNumChildren = 0;
-    out->fLevel = level;
-    return out;
+    out->init(level);
+    return fNodes.count() - 1;
 }
 
 // This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
@@ -140,17 +176,16 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
                     remainder -= kMaxChildren - kMinChildren;
                 }
             }
-            Node* n = allocateNodeAtLevel(level);
-            n->fNumChildren = 1;
-            n->fChildren[0] = (*branches)[currentBranch];
             Branch b;
+            b.fIndex = this->allocateNodeAtLevel(level);
             b.fBounds = (*branches)[currentBranch].fBounds;
-            b.fSubtree = n;
+            Node* n = &fNodes[b.fIndex];
+            n->addChild((*branches)[currentBranch].fIndex, (*branches)[currentBranch].fBounds);
             ++currentBranch;
             for (int k = 1; k < incrementBy && currentBranch < branches->count(); ++k) {
                 b.fBounds.join((*branches)[currentBranch].fBounds);
-                n->fChildren[k] = (*branches)[currentBranch];
-                ++n->fNumChildren;
+                n->addChild((*branches)[currentBranch].fIndex,
+                            (*branches)[currentBranch].fBounds);
                 ++currentBranch;
             }
             (*branches)[newBranches] = b;
@@ -161,20 +196,112 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
     return this->bulkLoad(branches, level + 1);
 }
 
+void SkRTree::sortBreadthFirst() {
+    // bulkLoad() allocates the nodes a level at a time from the bottom up, and the children of
+    // each node are contiguous and in order in the level below.  So reversing the order of the
+    // levels, but not of the nodes within each, puts the nodes in breadth-first order.
+    const int count  = fNodes.count();
+    const int levels = fNodes[fRoot].fLevel + 1;
+    SkASSERT(fRoot == count - 1);
+
+    SkAutoSTMalloc<8, int> oldStart(levels), newStart(levels);
+    for (int i = count - 1; i >= 0; i--) {
+        oldStart[fNodes[i].fLevel] = i;
+    }
+    auto levelSize = [&](int level) {
+        return (level + 1 < levels ? oldStart[level + 1] : count) - oldStart[level];
+    };
+    newStart[levels - 1] = 0;
+    for (int level = levels - 2; level >= 0; level--) {
+        newStart[level] = newStart[level + 1] + levelSize(level + 1);
+    }
+    auto remap = [&](int index) {
+        const int level = fNodes[index].fLevel;
+        return newStart[level] + index - oldStart[level];
+    };
+
+    SkTDArray<Node> sorted;
+    sorted.setCount(count);
+    for (int i = 0; i < count; i++) {
+        Node* node = &sorted[remap(i)];
+        *node = fNodes[i];
+        for (int j = 0; node->fLevel > 0 && j < node->fNumChildren; j++) {
+            node->fChildren[j] = remap(node->fChildren[j]);
+        }
+    }
+    fNodes.swap(sorted);
+    fRoot = 0;
+}
+
 void SkRTree::search(const SkRect& query, SkTDArray<int>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+    if (fCount > 0 && SkRect::Intersects(fRootBounds, query)) {
+        this->search(fRoot, query, results);
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push(node->fChildren[i].fOpIndex);
+void SkRTree::search(int index, const SkRect& query, SkTDArray<int>* results) const {
+    const Node& node = fNodes[index];
+    uint32_t hits = node.intersect(query);
+    for (int i = 0; hits; i++, hits >>= 1) {
+        if (hits & 1) {
+            if (0 == node.fLevel) {
+                results->push(node.fChildren[i]);
             } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+                this->search(node.fChildren[i], query, results);
+            }
+        }
+    }
+}
+
+void SkRTree::batchSearch(const SkRect queries[], int N, SkTDArray<int> results[]) const {
+    if (0 == fCount) {
+        return;
+    }
+    SkAutoSTMalloc<16, int> active(N);
+    int count = 0;
+    for (int i = 0; i < N; i++) {
+        if (SkRect::Intersects(fRootBounds, queries[i])) {
+            active[count++] = i;
+        }
+    }
+    if (count > 0) {
+        this->batchSearch(fRoot, queries, active, count, results);
+    }
+}
+
+void SkRTree::batchSearch(int index, const SkRect queries[], const int active[], int count,
+                          SkTDArray<int> results[]) const {
+    const Node& node = fNodes[index];
+
+    // Test each query against all the children at once, then visit each child that any query
+    // hit, with just the queries that hit it.
+    SkAutoSTMalloc<16, uint32_t> hits(count);
+    uint32_t anyHits = 0;
+    for (int j = 0; j < count; j++) {
+        hits[j] = node.intersect(queries[active[j]]);
+        anyHits |= hits[j];
+    }
+
+    SkAutoSTMalloc<16, int> childActive(0 == node.fLevel ? 0 : count);
+    for (int i = 0; anyHits; i++, anyHits >>= 1) {
+        if (!(anyHits & 1)) {
+            continue;
+        }
+        const uint32_t bit = 1 << i;
+        if (0 == node.fLevel) {
+            for (int j = 0; j < count; j++) {
+                if (hits[j] & bit) {
+                    results[active[j]].push(node.fChildren[i]);
+                }
+            }
+        } else {
+            int childCount = 0;
+            for (int j = 0; j < count; j++) {
+                if (hits[j] & bit) {
+                    childActive[childCount++] = active[j];
+                }
             }
+            this->batchSearch(node.fChildren[i], queries, childActive, childCount, results);
         }
     }
 }
@@ -186,3 +313,93 @@ size_t SkRTree::bytesUsed() const {
 
     return byteCount;
 }
+
+// A tree is written as its count, its node count and its root, then each node's child count,
+// level and children.  Children of leaf nodes are op indices, and all other branches point to
+// nodes by their index in fNodes.
+
+void SkRTree::writeToStream(SkWStream* stream) const {
+    stream->write32(SkToU32(fCount));
+    stream->write32(fCount ? SkToU32(fNodes.count()) : 0);
+    if (0 == fCount) {
+        return;
+    }
+
+    stream->write32(SkToU32(fRoot));
+    stream->write(&fRootBounds, sizeof(SkRect));
+    for (const Node& node : fNodes) {
+        stream->write16(node.fNumChildren);
+        stream->write16(node.fLevel);
+        for (int i = 0; i < node.fNumChildren; i++) {
+            const SkRect bounds = node.childBounds(i);
+            stream->write32(SkToU32(node.fChildren[i]));
+            stream->write(&bounds, sizeof(SkRect));
+        }
+    }
+}
+
+SkRTree* SkRTree::CreateFromStream(SkStream* stream) {
+    uint32_t header[2];
+    if (stream->read(header, sizeof(header)) != sizeof(header) || header[0] > SK_MaxS32) {
+        return nullptr;
+    }
+    const int count = SkToInt(header[0]);
+    const uint32_t nodeCount = header[1];
+
+    SkAutoTUnref<SkRTree> tree(new SkRTree);
+    if (0 == count) {
+        return 0 == nodeCount ? tree.release() : nullptr;
+    }
+    // Each node takes at least 24 bytes, so don't believe in more nodes than could fit.
+    const size_t kMinNodeSize = 2 * sizeof(uint16_t) + sizeof(uint32_t) + sizeof(SkRect);
+    if (0 == nodeCount || nodeCount > SK_MaxS32 / sizeof(Node) ||
+        (stream->hasLength() && stream->hasPosition() &&
+         (stream->getLength() - stream->getPosition()) / kMinNodeSize < nodeCount)) {
+        return nullptr;
+    }
+    tree->fCount = count;
+    tree->fNodes.setCount(SkToInt(nodeCount));
+
+    uint32_t rootIndex;
+    if (stream->read(&rootIndex, sizeof(rootIndex)) != sizeof(rootIndex) ||
+        stream->read(&tree->fRootBounds, sizeof(SkRect)) != sizeof(SkRect) ||
+        rootIndex >= nodeCount) {
+        return nullptr;
+    }
+    tree->fRoot = SkToInt(rootIndex);
+
+    // Every node bulkLoad() makes, except perhaps the root, has at least kMinChildren children,
+    // so no tree it makes is more than ceil(log_kMinChildren(count)) + 1 levels deep.  Searches
+    // recurse once per level, so don't accept anything deeper.
+    int maxLevel = 0;
+    for (int64_t n = 1; n < count; n *= kMinChildren) {
+        maxLevel++;
+    }
+
+    for (Node& node : tree->fNodes) {
+        const uint16_t numChildren = stream->readU16();
+        node.init(stream->readU16());
+        if (0 == numChildren || numChildren > kMaxChildren || node.fLevel > maxLevel) {
+            return nullptr;
+        }
+        for (int i = 0; i < numChildren; i++) {
+            uint32_t index;
+            SkRect bounds;
+            if (stream->read(&index, sizeof(index)) != sizeof(index) ||
+                stream->read(&bounds, sizeof(SkRect)) != sizeof(SkRect) ||
+                index > (node.fLevel > 0 ? nodeCount - 1 : (uint32_t)SK_MaxS32)) {
+                return nullptr;
+            }
+            node.addChild(SkToInt(index), bounds);
+        }
+    }
+    // Subtrees must be one level down from their parents, which rules out cycles.
+    for (const Node& node : tree->fNodes) {
+        for (int i = 0; node.fLevel > 0 && i < node.fNumChildren; i++) {
+            if (tree->fNodes[node.fChildren[i]].fLevel != node.fLevel - 1) {
+                return nullptr;
+            }
+        }
+    }
+    return tree.release();
+}
@@ -12,6 +12,9 @@
 #include "SkRect.h"
 #include "SkTDArray.h"
 
+class SkStream;
+class SkWStream;
+
 /**
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
@@ -42,12 +45,18 @@ public:
 
     void insert(const SkRect[], int N) override;
     void search(const SkRect& query, SkTDArray<int>* results) const override;
+    void batchSearch(const SkRect queries[], int N, SkTDArray<int> results[]) const override;
     size_t bytesUsed() const override;
 
+    // Write the tree out, so that CreateFromStream() can read it back without rebuilding it.
+    void writeToStream(SkWStream*) const;
+    // Returns nullptr if the stream doesn't hold a valid tree.
+    static SkRTree* CreateFromStream(SkStream*);
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes[fRoot].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -59,36 +68,57 @@ public:
                      kMaxChildren = 11;
 
 private:
-    struct Node;
-
-    struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
-        SkRect fBounds;
-    };
+    // Children are tested against a query four at a time, so their storage is padded out to a
+    // multiple of four.
+    static const int kPaddedChildren = SkAlign4(kMaxChildren);
 
+    // Nodes are kept in one array, breadth-first from the root, and refer to each other by index.
     struct Node {
+        // The bounds of each child, as a structure of arrays.  Unused slots never intersect.
+        float    fLeft  [kPaddedChildren],
+                 fTop   [kPaddedChildren],
+                 fRight [kPaddedChildren],
+                 fBottom[kPaddedChildren];
+        // The index in fNodes of each child, or if fLevel is 0, each child's op index.
+        int32_t  fChildren[kPaddedChildren];
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+
+        void init(uint16_t level);
+        void addChild(int index, const SkRect& bounds);
+        SkRect childBounds(int i) const {
+            return SkRect::MakeLTRB(fLeft[i], fTop[i], fRight[i], fBottom[i]);
+        }
+        // Returns a mask with bit i set for each child i whose bounds intersect query.
+        uint32_t intersect(const SkRect& query) const;
+    };
+
+    // Used only while bulk-loading.
+    struct Branch {
+        int    fIndex;    // Node index, or op index at the bottom level.
+        SkRect fBounds;
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<int>* results) const;
+    void search(int node, const SkRect& query, SkTDArray<int>* results) const;
+    void batchSearch(int node, const SkRect queries[], const int active[], int count,
+                     SkTDArray<int> results[]) const;
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
 
+    // Reorder bulkLoad()'s bottom-up nodes so that the root comes first.
+    void sortBreadthFirst();
+
     // How many times will bulkLoad() call allocateNodeAtLevel()?
     static int CountNodes(int branches, SkScalar aspectRatio);
 
-    Node* allocateNodeAtLevel(uint16_t level);
+    int allocateNodeAtLevel(uint16_t level);
 
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     SkScalar fAspectRatio;
-    Branch fRoot;
+    int fRoot;
+    SkRect fRootBounds;
     SkTDArray<Node> fNodes;
 
     typedef SkBBoxHierarchy INHERITED;
@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
+#include "SkMatrix.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
 
@@ -22,6 +24,26 @@ void SkRasterPipeline::extend(const SkRasterPipeline& src) {
     }
 }
 
+void SkRasterPipeline::appendMatrix(SkArenaAlloc* alloc, const SkMatrix& matrix) {
+    SkMatrix::TypeMask mt = matrix.getType();
+    if (mt == SkMatrix::kIdentity_Mask) {
+        return;
+    }
+    if (mt & SkMatrix::kPerspective_Mask) {
+        auto storage = alloc->makeArrayDefault<float>(9);
+        matrix.get9(storage);
+        this->append(SkRasterPipeline::matrix_perspective, storage);
+    } else {
+        auto storage = alloc->makeArrayDefault<float>(6);
+        SkAssertResult(matrix.asAffine(storage));
+        this->append(SkRasterPipeline::matrix_2x3, storage);
+    }
+}
+
 std::function<void(size_t, size_t)> SkRasterPipeline::compile() const {
-    return SkOpts::compile_pipeline(fStages, fNum);
+    return SkOpts::compile_pipeline(fStages, fNum, true);
+}
+
+std::function<void(size_t, size_t)> SkRasterPipeline::compileUnfused() const {
+    return SkOpts::compile_pipeline(fStages, fNum, false);
 }
@@ -13,6 +13,9 @@
 #include "SkTypes.h"
 #include <functional>
 
+class SkArenaAlloc;
+class SkMatrix;
+
 /**
  * SkRasterPipeline provides a cheap way to chain together a pixel processing pipeline.
  *
@@ -54,19 +57,31 @@
 // TODO: There may be a better place to stuff tail, e.g. in the bottom alignment bits of
 // the Stage*.  This mostly matters on 64-bit Windows where every register is precious.
 
-#define SK_RASTER_PIPELINE_STAGES(M)                            \
-    M(swap_src_dst) M(constant_color) M(clamp_1)                \
-    M(load_s_565)  M(load_d_565)  M(store_565)                  \
-    M(load_s_srgb) M(load_d_srgb) M(store_srgb)                 \
-    M(load_s_f16)  M(load_d_f16)  M(store_f16)                  \
-    M(scale_u8)                                                 \
-    M(lerp_u8) M(lerp_565) M(lerp_constant_float)               \
-    M(dst)                                                      \
-    M(dstatop) M(dstin) M(dstout) M(dstover)                    \
-    M(srcatop) M(srcin) M(srcout) M(srcover)                    \
-    M(clear) M(modulate) M(multiply) M(plus_) M(screen) M(xor_) \
-    M(colorburn) M(colordodge) M(darken) M(difference)          \
-    M(exclusion) M(hardlight) M(lighten) M(overlay) M(softlight)
+#define SK_RASTER_PIPELINE_STAGES(M)                                   \
+    M(swap_src_dst) M(constant_color) M(clamp_1)                       \
+    M(load_s_565)  M(load_d_565)  M(store_565)                         \
+    M(load_s_srgb) M(load_d_srgb) M(store_srgb)                        \
+    M(load_s_f16)  M(load_d_f16)  M(store_f16)                         \
+    M(load_s_8888) M(load_d_8888) M(store_8888)                        \
+    M(scale_u8)                                                        \
+    M(lerp_u8) M(lerp_565) M(lerp_constant_float)                      \
+    M(dst)                                                             \
+    M(dstatop) M(dstin) M(dstout) M(dstover)                           \
+    M(srcatop) M(srcin) M(srcout) M(srcover)                           \
+    M(clear) M(modulate) M(multiply) M(plus_) M(screen) M(xor_)        \
+    M(colorburn) M(colordodge) M(darken) M(difference)                 \
+    M(exclusion) M(hardlight) M(lighten) M(overlay) M(softlight)       \
+    M(clamp_0) M(clamp_a) M(unpremul) M(premul) M(scale_1_float)       \
+    M(matrix_4x5)                                                      \
+    M(seed_shader) M(matrix_2x3) M(matrix_perspective)                 \
+    M(clamp_x) M(clamp_y) M(repeat_x) M(repeat_y)                      \
+    M(mirror_x) M(mirror_y)                                            \
+    M(gather_8888)   M(gather_srgb)   M(gather_565)   M(gather_f16)    \
+    M(bilinear_8888) M(bilinear_srgb) M(bilinear_565) M(bilinear_f16)  \
+    M(bicubic_8888)  M(bicubic_srgb)  M(bicubic_565)  M(bicubic_f16)   \
+    M(xy_to_radius) M(xy_to_angle)                                     \
+    M(xy_to_2pt_conical) M(mask_2pt_conical_degenerates)               \
+    M(gradient) M(gradient_2stops)
 
 class SkRasterPipeline {
 public:
@@ -86,14 +101,59 @@ public:
     // Append all stages to this pipeline.
     void extend(const SkRasterPipeline&);
 
+    // Append the cheapest of matrix_2x3 or matrix_perspective that can apply this matrix to
+    // the coordinates in r,g.  Nothing is appended for the identity.
+    void appendMatrix(SkArenaAlloc*, const SkMatrix&);
+
     // Runs the pipeline walking x through [x,x+n).
+    // Common short pipelines are fused into a single specialized loop.
     std::function<void(size_t x, size_t n)> compile() const;
 
+    // Like compile(), but always chains stages through function pointers.  Mostly for testing.
+    std::function<void(size_t x, size_t n)> compileUnfused() const;
+
     struct Stage {
         StockStage stage;
         void*        ctx;
     };
 
+    // How bilinear_* and bicubic_* tile taps that fall outside the image.
+    enum TileMode { kClamp_TileMode, kRepeat_TileMode, kMirror_TileMode };
+
+    // Context for gather_*, bilinear_*, and bicubic_*: the source pixels, and how to tile them.
+    // gather_* expects coordinates already tiled by {clamp,repeat,mirror}_{x,y}, with width and
+    // height as their contexts; bilinear_* and bicubic_* tile each of their taps themselves.
+    struct ImageCtx {
+        const void* pixels;
+        int         stride;   // In pixels.
+        float       width;
+        float       height;
+        TileMode    tileX;
+        TileMode    tileY;
+    };
+
+    // Context for gradient, mapping t in r to a color.  Between ts[i] and ts[i+1] (or 1),
+    // each channel c is t*fs[4*i+c] + bs[4*i+c].  ts[0] is always 0.
+    struct GradientCtx {
+        int          stopCount;
+        const float* ts;
+        const float* fs;
+        const float* bs;
+    };
+
+    // Context for gradient_2stops: the color is t*f + b.
+    struct TwoStopGradientCtx {
+        float f[4];
+        float b[4];
+    };
+
+    // Context for xy_to_2pt_conical: the start circle, and how it changes from t=0 to t=1.
+    struct TwoPointConicalCtx {
+        float centerX, centerY, radius;
+        float dCenterX, dCenterY, dRadius;
+        bool  flipped;  // Prefer the smaller t rather than the larger when both are valid.
+    };
+
 private:
     int   fNum   = 0;
     Stage fStages[kMaxStages];
@@ -5,12 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
 #include "SkBlitter.h"
 #include "SkBlendModePriv.h"
 #include "SkColor.h"
 #include "SkColorFilter.h"
 #include "SkOpts.h"
-#include "SkPM4f.h"
+#include "SkPM4fPriv.h"
 #include "SkRasterPipeline.h"
 #include "SkShader.h"
 #include "SkXfermode.h"
@@ -18,7 +19,8 @@
 
 class SkRasterPipelineBlitter : public SkBlitter {
 public:
-    static SkBlitter* Create(const SkPixmap&, const SkPaint&, SkTBlitterAllocator*);
+    static SkBlitter* Create(const SkPixmap&, const SkPaint&, const SkMatrix& ctm,
+                             SkTBlitterAllocator*);
 
     SkRasterPipelineBlitter(SkPixmap dst,
                             SkRasterPipeline shader,
@@ -33,6 +35,7 @@ public:
     void blitH    (int x, int y, int w)                            override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
     void blitMask (const SkMask&, const SkIRect& clip)             override;
+    void blitSpans(const Span[], int count)                        override;
 
     // TODO: The default implementations of the other blits look fine,
     // but some of them like blitV could probably benefit from custom
@@ -44,10 +47,15 @@ private:
     void append_blend (SkRasterPipeline*) const;
     void maybe_clamp  (SkRasterPipeline*) const;
 
+    void compile_blitH();
+    void compile_blitAntiH();
+
     SkPixmap         fDst;
     SkRasterPipeline fShader;
     SkBlendMode      fBlend;
     SkPM4f           fPaintColor;
+    float            fPaintAlpha;
+    SkArenaAlloc     fAlloc;  // Contexts for fShader's stages.
 
     // These functions are compiled lazily when first used.
     std::function<void(size_t, size_t)> fBlitH         = nullptr,
@@ -60,19 +68,24 @@ private:
     void*       fDstPtr           = nullptr;
     const void* fMaskPtr          = nullptr;
     float       fConstantCoverage = 0.0f;
+    int         fCurrentY         = 0;
 
     typedef SkBlitter INHERITED;
 };
 
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          const SkPaint& paint,
+                                         const SkMatrix& ctm,
                                          SkTBlitterAllocator* alloc) {
-    return SkRasterPipelineBlitter::Create(dst, paint, alloc);
+    return SkRasterPipelineBlitter::Create(dst, paint, ctm, alloc);
 }
 
+std::atomic<bool> gSkForceRasterPipelineBlitter{false};
+
 static bool supported(const SkImageInfo& info) {
     switch (info.colorType()) {
-        case kN32_SkColorType:      return info.gammaCloseToSRGB();
+        case kN32_SkColorType:      return info.gammaCloseToSRGB()
+                                        || gSkForceRasterPipelineBlitter;
         case kRGBA_F16_SkColorType: return true;
         case kRGB_565_SkColorType:  return true;
         default:                    return false;
@@ -87,12 +100,13 @@ static bool append_effect_stages(const Effect* effect, SkRasterPipeline* pipelin
 
 SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
                                            const SkPaint& paint,
+                                           const SkMatrix& ctm,
                                            SkTBlitterAllocator* alloc) {
     if (!supported(dst.info())) {
         return nullptr;
     }
-    if (paint.getShader()) {
-        return nullptr;  // TODO: need to work out how shaders and their contexts work
+    if (dst.colorType() == kRGB_565_SkColorType && paint.getShader() && paint.isDither()) {
+        return nullptr;  // We've no dither stage yet, so leave these to SkRGB16_Shader_Blitter.
     }
     SkBlendMode blend = paint.getBlendMode();
     if (!SkBlendMode_AppendStages(blend)) {
@@ -104,22 +118,46 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         return nullptr;
     }
 
-    uint32_t paintColor = paint.getColor();
-
-    SkColor4f color;
-    if (SkImageInfoIsGammaCorrect(dst.info())) {
-        color = SkColor4f::FromColor(paintColor);
-    } else {
-        swizzle_rb(SkNx_cast<float>(Sk4b::Load(&paintColor)) * (1/255.0f)).store(&color);
+    // Shaders and colors work in linear floats for gamma-correct destinations.  F16 without a
+    // color space is gamma-correct too, so we tell shaders it's linear sRGB.
+    sk_sp<SkColorSpace> linear;
+    SkColorSpace* dstColorSpace = dst.info().colorSpace();
+    if (!dstColorSpace && SkImageInfoIsGammaCorrect(dst.info())) {
+        linear = SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named);
+        dstColorSpace = linear.get();
     }
 
+    SkColor4f color = SkColor4f_from_SkColor(paint.getColor(), dstColorSpace);
     auto blitter = alloc->createT<SkRasterPipelineBlitter>(dst, shader, blend, color.premul());
-
-    if (!paint.getShader()) {
+    blitter->fPaintAlpha = color.fA;
+
+    if (SkShader* paintShader = paint.getShader()) {
+        // Shaders start from the device coordinates of each pixel, and ignore the paint color
+        // except for its alpha.
+        blitter->fShader.append(SkRasterPipeline::seed_shader, &blitter->fCurrentY);
+        if (!paintShader->appendStages(&blitter->fShader, dstColorSpace, &blitter->fAlloc,
+                                       ctm, paint)) {
+            blitter->~SkRasterPipelineBlitter();
+            alloc->freeLast();
+            return nullptr;
+        }
+        if (paint.getAlpha() != 0xFF) {
+            blitter->fShader.append(SkRasterPipeline::scale_1_float, &blitter->fPaintAlpha);
+        }
+    } else {
         blitter->fShader.append(SkRasterPipeline::constant_color, &blitter->fPaintColor);
     }
     blitter->fShader.extend(colorFilter);
 
+    // An opaque source makes srcover the same as src, which lets blitH() skip loading the dst.
+    bool opaque = paint.getAlpha() == 0xFF
+               && (paint.getShader() ? paint.getShader()->isOpaque() : true)
+               && (!paint.getColorFilter() ||
+                   (paint.getColorFilter()->getFlags() & SkColorFilter::kAlphaUnchanged_Flag));
+    if (opaque && blend == SkBlendMode::kSrcOver) {
+        blitter->fBlend = SkBlendMode::kSrc;
+    }
+
     return blitter;
 }
 
@@ -130,6 +168,8 @@ void SkRasterPipelineBlitter::append_load_d(SkRasterPipeline* p) const {
         case kN32_SkColorType:
             if (fDst.info().gammaCloseToSRGB()) {
                 p->append(SkRasterPipeline::load_d_srgb, &fDstPtr);
+            } else {
+                p->append(SkRasterPipeline::load_d_8888, &fDstPtr);
             }
             break;
         case kRGBA_F16_SkColorType:
@@ -149,6 +189,8 @@ void SkRasterPipelineBlitter::append_store(SkRasterPipeline* p) const {
         case kN32_SkColorType:
             if (fDst.info().gammaCloseToSRGB()) {
                 p->append(SkRasterPipeline::store_srgb, &fDstPtr);
+            } else {
+                p->append(SkRasterPipeline::store_8888, &fDstPtr);
             }
             break;
         case kRGBA_F16_SkColorType:
@@ -169,34 +211,70 @@ void SkRasterPipelineBlitter::maybe_clamp(SkRasterPipeline* p) const {
     if (SkBlendMode_CanOverflow(fBlend)) { p->append(SkRasterPipeline::clamp_1); }
 }
 
-void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
-    if (!fBlitH) {
-        SkRasterPipeline p;
-        p.extend(fShader);
+void SkRasterPipelineBlitter::compile_blitH() {
+    SkRasterPipeline p;
+    p.extend(fShader);
+    if (fBlend != SkBlendMode::kSrc) {
         this->append_load_d(&p);
         this->append_blend(&p);
         this->maybe_clamp(&p);
-        this->append_store(&p);
-        fBlitH = p.compile();
+    }
+    this->append_store(&p);
+    fBlitH = p.compile();
+}
+
+void SkRasterPipelineBlitter::compile_blitAntiH() {
+    SkRasterPipeline p;
+    p.extend(fShader);
+    this->append_load_d(&p);
+    this->append_blend(&p);
+    p.append(SkRasterPipeline::lerp_constant_float, &fConstantCoverage);
+    this->maybe_clamp(&p);
+    this->append_store(&p);
+    fBlitAntiH = p.compile();
+}
+
+void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
+    if (!fBlitH) {
+        this->compile_blitH();
     }
 
-    fDstPtr = fDst.writable_addr(0,y);
+    fDstPtr   = fDst.writable_addr(0,y);
+    fCurrentY = y;
     fBlitH(x,w);
 }
 
+void SkRasterPipelineBlitter::blitSpans(const Span spans[], int count) {
+    for (int i = 0; i < count; i++) {
+        const Span& span = spans[i];
+        if (span.fAlpha == 0) {
+            continue;
+        }
+        fDstPtr   = fDst.writable_addr(0,span.fY);
+        fCurrentY = span.fY;
+
+        if (span.fAlpha == 0xFF) {
+            if (!fBlitH) {
+                this->compile_blitH();
+            }
+            fBlitH(span.fX, span.fWidth);
+        } else {
+            if (!fBlitAntiH) {
+                this->compile_blitAntiH();
+            }
+            fConstantCoverage = span.fAlpha * (1/255.0f);
+            fBlitAntiH(span.fX, span.fWidth);
+        }
+    }
+}
+
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
     if (!fBlitAntiH) {
-        SkRasterPipeline p;
-        p.extend(fShader);
-        this->append_load_d(&p);
-        this->append_blend(&p);
-        p.append(SkRasterPipeline::lerp_constant_float, &fConstantCoverage);
-        this->maybe_clamp(&p);
-        this->append_store(&p);
-        fBlitAntiH = p.compile();
+        this->compile_blitAntiH();
     }
 
-    fDstPtr = fDst.writable_addr(0,y);
+    fDstPtr   = fDst.writable_addr(0,y);
+    fCurrentY = y;
     for (int16_t run = *runs; run > 0; run = *runs) {
         fConstantCoverage = *aa * (1/255.0f);
         fBlitAntiH(x, run);
@@ -237,7 +315,8 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
 
     int x = clip.left();
     for (int y = clip.top(); y < clip.bottom(); y++) {
-        fDstPtr = fDst.writable_addr(0,y);
+        fDstPtr   = fDst.writable_addr(0,y);
+        fCurrentY = y;
 
         switch (mask.fFormat) {
             case SkMask::kA8_Format:
@@ -106,6 +106,10 @@ void SkReadBuffer::setImageDeserializer(SkImageDeserializer* deserializer) {
     fImageDeserializer = deserializer ? deserializer : &gDefaultImageDeserializer;
 }
 
+bool SkReadBuffer::canMakeImagesInParallel() const {
+    return fImageDeserializer == &gDefaultImageDeserializer || fImageDeserializer->isThreadSafe();
+}
+
 bool SkReadBuffer::readBool() {
     return fReader.readBool();
 }
@@ -262,48 +266,66 @@ sk_sp<SkImage> SkReadBuffer::readBitmapAsImage() {
 }
 
 sk_sp<SkImage> SkReadBuffer::readImage() {
+    EncodedImage encoded;
+    if (!this->readEncodedImage(&encoded)) {
+        return nullptr;
+    }
+    return this->makeImage(encoded);
+}
+
+bool SkReadBuffer::readEncodedImage(EncodedImage* encoded) {
     if (fInflator) {
         SkImage* img = fInflator->getImage(this->read32());
-        return img ? sk_ref_sp(img) : nullptr;
+        encoded->fImage = sk_ref_sp(img);
+        return img != nullptr;
     }
 
     int width = this->read32();
     int height = this->read32();
     if (width <= 0 || height <= 0) {    // SkImage never has a zero dimension
         this->validate(false);
-        return nullptr;
+        return false;
     }
 
     uint32_t encoded_size = this->getArrayCount();
     if (encoded_size == 0) {
         // The image could not be encoded at serialization time - return an empty placeholder.
         (void)this->readUInt();  // Swallow that encoded_size == 0 sentinel.
-        return MakeEmptyImage(width, height);
+        encoded->fImage = MakeEmptyImage(width, height);
+        return true;
     }
     if (encoded_size == 1) {
         // We had to encode the image as raw pixels via SkBitmap.
         (void)this->readUInt();  // Swallow that encoded_size == 1 sentinel.
         SkBitmap bm;
         if (SkBitmap::ReadRawPixels(this, &bm)) {
-            return SkImage::MakeFromBitmap(bm);
+            encoded->fImage = SkImage::MakeFromBitmap(bm);
+        } else {
+            encoded->fImage = MakeEmptyImage(width, height);
         }
-        return MakeEmptyImage(width, height);
+        return true;
     }
 
     // The SkImage encoded itself.
-    sk_sp<SkData> encoded(this->readByteArrayAsData());
+    encoded->fData = this->readByteArrayAsData();
 
     int originX = this->read32();
     int originY = this->read32();
     if (originX < 0 || originY < 0) {
         this->validate(false);
-        return nullptr;
+        return false;
     }
 
-    const SkIRect subset = SkIRect::MakeXYWH(originX, originY, width, height);
+    encoded->fSubset = SkIRect::MakeXYWH(originX, originY, width, height);
+    return true;
+}
 
-    sk_sp<SkImage> image = fImageDeserializer->makeFromData(encoded.get(), &subset);
-    return image ? image : MakeEmptyImage(width, height);
+sk_sp<SkImage> SkReadBuffer::makeImage(const EncodedImage& encoded) const {
+    if (!encoded.fData) {
+        return encoded.fImage;
+    }
+    sk_sp<SkImage> image = fImageDeserializer->makeFromData(encoded.fData.get(), &encoded.fSubset);
+    return image ? image : MakeEmptyImage(encoded.fSubset.width(), encoded.fSubset.height());
 }
 
 sk_sp<SkTypeface> SkReadBuffer::readTypeface() {
@@ -70,6 +70,9 @@ public:
         kBlurMaskFilterWritesOccluder      = 47,
         kGradientShaderFloatColor_Version  = 49,
         kXfermodeToBlendMode_Version       = 50,
+        kAlignedPictureSections_Version    = 51,
+        kLazySubPictures_Version           = 52,
+        kPictureBBH_Version                = 53,
     };
 
     /**
@@ -175,6 +178,19 @@ public:
 
     sk_sp<SkImage> readBitmapAsImage();
     sk_sp<SkImage> readImage();
+
+    // readImage() in two steps.  readEncodedImage() reads everything readImage() would, and
+    // makeImage() turns that into an image.  makeImage() may decode.  With the default image
+    // deserializer it's safe to call from any thread, so several images can be made at once.
+    struct EncodedImage {
+        sk_sp<SkData>  fData;    // If null, fImage is the image.
+        SkIRect        fSubset;
+        sk_sp<SkImage> fImage;
+    };
+    bool readEncodedImage(EncodedImage*);
+    sk_sp<SkImage> makeImage(const EncodedImage&) const;
+    // True if makeImage() may be called from several threads at once.
+    bool canMakeImagesInParallel() const;
     virtual sk_sp<SkTypeface> readTypeface();
 
     void setTypefaceArray(SkTypeface* array[], int count) {
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkOpts.h"
 #include "SkRecord.h"
 #include <algorithm>
 
@@ -13,6 +14,50 @@ SkRecord::~SkRecord() {
     for (int i = 0; i < this->count(); i++) {
         this->mutate(i, destroyer);
     }
+    fPaints.foreach([](SkPaint** paint) { (*paint)->~SkPaint(); });
+    fPaths .foreach([](SkPath**  path)  { (*path)->~SkPath(); });
+}
+
+template <>
+uint32_t SkRecord::InternTraits<SkPaint>::Hash(const SkPaint& paint) {
+    return paint.getHash();
+}
+
+template <>
+uint32_t SkRecord::InternTraits<SkPath>::Hash(const SkPath& path) {
+    SkPoint pts[kMaxInternedPathPoints];
+    uint8_t verbs[kMaxInternedPathPoints];
+    int ptCount   = path.getPoints(pts, kMaxInternedPathPoints),
+        verbCount = path.getVerbs(verbs, kMaxInternedPathPoints);
+    SkASSERT(ptCount <= kMaxInternedPathPoints && verbCount <= kMaxInternedPathPoints);
+
+    uint32_t hash = SkOpts::hash(pts, ptCount * sizeof(SkPoint), path.getFillType());
+    return SkOpts::hash(verbs, verbCount, hash);
+}
+
+const SkPaint* SkRecord::internPaint(const SkPaint& paint) {
+    if (SkPaint** found = fPaints.find(paint)) {
+        return *found;
+    }
+    SkPaint* copy = new (this->alloc<SkPaint>()) SkPaint(paint);
+    fPaints.set(copy);
+    return copy;
+}
+
+const SkPath& SkRecord::internPath(const SkPath& path) {
+    // SkPath::operator==() ignores volatility, which tells the GPU backend not to cache the path,
+    // so sharing a copy could change it.  Volatile paths aren't expected to repeat anyway.
+    if (path.isVolatile() ||
+        path.countPoints() > kMaxInternedPathPoints ||
+        path.countVerbs()  > kMaxInternedPathPoints) {
+        return path;
+    }
+    if (SkPath** found = fPaths.find(path)) {
+        return **found;
+    }
+    SkPath* copy = new (this->alloc<SkPath>()) SkPath(path);
+    fPaths.set(copy);
+    return *copy;
 }
 
 void SkRecord::grow() {
@@ -29,7 +74,7 @@ size_t SkRecord::bytesUsed() const {
     if (fReserved > kInlineRecords) {
         bytes += fReserved * sizeof(Record);
     }
-    return bytes;
+    return bytes + fPaints.approxBytesUsed() + fPaths.approxBytesUsed();
 }
 
 void SkRecord::defrag() {
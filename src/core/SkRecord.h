@@ -9,6 +9,7 @@
 #define SkRecord_DEFINED
 
 #include "SkRecords.h"
+#include "SkTHash.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 #include "SkVarAlloc.h"
@@ -103,6 +104,15 @@ public:
         return fRecords[i].set(this->allocCommand<T>());
     }
 
+    // Returns a paint equal to paint that lives as long as this SkRecord.  Ops that draw with
+    // equal paints share one copy, so SkRecords::SharedPaint is just a pointer to it.
+    const SkPaint* internPaint(const SkPaint& paint);
+
+    // Returns a path equal to path.  Equal small paths share one copy, so ops that copy the
+    // result share its points and verbs too.  Bigger paths aren't worth comparing, and volatile
+    // paths must stay volatile, so for those we return path itself.
+    const SkPath& internPath(const SkPath& path);
+
     // Does not return the bytes in any pointers embedded in the Records; callers
     // need to iterate with a visitor to measure those they care for.
     size_t bytesUsed() const;
@@ -144,6 +154,15 @@ private:
 
     void grow();
 
+    // Paths with more points or verbs than this are never interned.
+    static const int kMaxInternedPathPoints = 16;
+
+    template <typename T>
+    struct InternTraits {
+        static const T& GetKey(const T* t) { return *t; }
+        static uint32_t Hash(const T&);
+    };
+
     // A typed pointer to some bytes in fAlloc.  visit() and mutate() allow polymorphic dispatch.
     struct Record {
         // On 32-bit machines we store type in 4 bytes, followed by a pointer.  Simple.
@@ -193,6 +212,10 @@ private:
     // chunks, returning a stable handle to that data for later retrieval.
     SkVarAlloc fAlloc;
     char fInlineAlloc[1 << kInlineAllocLgBytes];
+
+    // Everything internPaint() and internPath() have returned, allocated in fAlloc.
+    SkTHashTable<SkPaint*, SkPaint, InternTraits<SkPaint>> fPaints;
+    SkTHashTable<SkPath*,  SkPath,  InternTraits<SkPath>>  fPaths;
 };
 
 #endif//SkRecord_DEFINED
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkPatchUtils.h"
+#include "SkRecordDiff.h"
+
+using namespace SkRecords;
+
+namespace {
+
+// Two optional objects are the same if both are missing or both are there and equal.
+template <typename T>
+bool same(const T* a, const T* b) {
+    return a ? b && *a == *b : !b;
+}
+
+// Same for optional arrays of n POD elements.
+template <typename T>
+bool same(const T* a, const T* b, size_t n) {
+    return a ? b && 0 == memcmp(a, b, n * sizeof(T)) : !b;
+}
+
+bool same(const SkData* a, const SkData* b) {
+    return a ? b && a->equals(b) : !b;
+}
+
+// Returns a pointer to the op if it's a T, otherwise nullptr.
+template <typename T>
+struct As {
+    const T* operator()(const T& op) { return &op; }
+    template <typename U> const T* operator()(const U&) { return nullptr; }
+};
+
+class OpsEqual {
+public:
+    OpsEqual(const SkRecord& other, int j) : fOther(other), fJ(j) {}
+
+    template <typename T>
+    bool operator()(const T& a) {
+        const T* b = fOther.visit(fJ, As<T>());
+        return b && equal(a, *b);
+    }
+
+private:
+    static bool equal(const NoOp&, const NoOp&) { return true; }
+    static bool equal(const Save&, const Save&) { return true; }
+    static bool equal(const Restore& a, const Restore& b) {
+        return a.devBounds == b.devBounds && a.matrix == b.matrix;
+    }
+    static bool equal(const SaveLayer& a, const SaveLayer& b) {
+        return same<SkRect>(a.bounds, b.bounds) && same<SkPaint>(a.paint, b.paint)
+            && a.backdrop == b.backdrop && a.saveLayerFlags == b.saveLayerFlags;
+    }
+
+    static bool equal(const SetMatrix& a, const SetMatrix& b) { return a.matrix == b.matrix; }
+    static bool equal(const Concat&    a, const Concat&    b) { return a.matrix == b.matrix; }
+    static bool equal(const Translate& a, const Translate& b) {
+        return a.dx == b.dx && a.dy == b.dy;
+    }
+    static bool equal(const TranslateZ& a, const TranslateZ& b) { return a.z == b.z; }
+
+    static bool equal(const ClipOpAndAA& a, const ClipOpAndAA& b) {
+        return a.op == b.op && a.aa == b.aa;
+    }
+    static bool equal(const ClipPath& a, const ClipPath& b) {
+        return a.devBounds == b.devBounds && a.path == b.path && equal(a.opAA, b.opAA);
+    }
+    static bool equal(const ClipRRect& a, const ClipRRect& b) {
+        return a.devBounds == b.devBounds && a.rrect == b.rrect && equal(a.opAA, b.opAA);
+    }
+    static bool equal(const ClipRect& a, const ClipRect& b) {
+        return a.devBounds == b.devBounds && a.rect == b.rect && equal(a.opAA, b.opAA);
+    }
+    static bool equal(const ClipRegion& a, const ClipRegion& b) {
+        return a.devBounds == b.devBounds && a.region == b.region && a.op == b.op;
+    }
+
+    // Interned paints from different records are different objects, so compare them deeply.
+    static bool equal(const SharedPaint& a, const SharedPaint& b) { return *a == *b; }
+
+    static bool equal(const DrawArc& a, const DrawArc& b) {
+        return equal(a.paint, b.paint) && a.oval == b.oval && a.startAngle == b.startAngle
+            && a.sweepAngle == b.sweepAngle && a.useCenter == b.useCenter;
+    }
+    static bool equal(const DrawDRRect& a, const DrawDRRect& b) {
+        return equal(a.paint, b.paint) && a.outer == b.outer && a.inner == b.inner;
+    }
+    // A drawable may draw something different every time it's snapped.
+    static bool equal(const DrawDrawable&, const DrawDrawable&) { return false; }
+    static bool equal(const DrawImage& a, const DrawImage& b) {
+        return same<SkPaint>(a.paint, b.paint) && a.image == b.image
+            && a.left == b.left && a.top == b.top;
+    }
+    static bool equal(const DrawImageLattice& a, const DrawImageLattice& b) {
+        return same<SkPaint>(a.paint, b.paint) && a.image == b.image
+            && a.xCount == b.xCount && same<int>(a.xDivs, b.xDivs, a.xCount)
+            && a.yCount == b.yCount && same<int>(a.yDivs, b.yDivs, a.yCount)
+            && a.flagCount == b.flagCount
+            && same<SkCanvas::Lattice::Flags>(a.flags, b.flags, a.flagCount)
+            && a.src == b.src && a.dst == b.dst;
+    }
+    static bool equal(const DrawImageRect& a, const DrawImageRect& b) {
+        return same<SkPaint>(a.paint, b.paint) && a.image == b.image
+            && same<SkRect>(a.src, b.src) && a.dst == b.dst && a.constraint == b.constraint;
+    }
+    static bool equal(const DrawImageNine& a, const DrawImageNine& b) {
+        return same<SkPaint>(a.paint, b.paint) && a.image == b.image
+            && a.center == b.center && a.dst == b.dst;
+    }
+    static bool equal(const DrawOval& a, const DrawOval& b) {
+        return equal(a.paint, b.paint) && a.oval == b.oval;
+    }
+    static bool equal(const DrawPaint& a, const DrawPaint& b) { return equal(a.paint, b.paint); }
+    static bool equal(const DrawPath& a, const DrawPath& b) {
+        return equal(a.paint, b.paint) && a.path == b.path;
+    }
+    static bool equal(const DrawPatch& a, const DrawPatch& b) {
+        return equal(a.paint, b.paint)
+            && same<SkPoint>(a.cubics,    b.cubics,    SkPatchUtils::kNumCtrlPts)
+            && same<SkColor>(a.colors,    b.colors,    SkPatchUtils::kNumCorners)
+            && same<SkPoint>(a.texCoords, b.texCoords, SkPatchUtils::kNumCorners)
+            && a.xmode == b.xmode;
+    }
+    static bool equal(const DrawPicture& a, const DrawPicture& b) {
+        return same<SkPaint>(a.paint, b.paint) && a.picture == b.picture && a.matrix == b.matrix;
+    }
+    // SkShadowParams are held by reference, and may not outlive the recording.
+    static bool equal(const DrawShadowedPicture&, const DrawShadowedPicture&) { return false; }
+    static bool equal(const DrawPoints& a, const DrawPoints& b) {
+        return equal(a.paint, b.paint) && a.mode == b.mode && a.count == b.count
+            && same<SkPoint>(a.pts, b.pts, a.count);
+    }
+
+    template <typename T>
+    static bool equal_text(const T& a, const T& b) {
+        return a.byteLength == b.byteLength && same<char>(a.text, b.text, a.byteLength);
+    }
+    static bool equal(const DrawPosText& a, const DrawPosText& b) {
+        return equal(a.paint, b.paint)
+            && equal_text(a, b)
+            && same<SkPoint>(a.pos, b.pos, a.paint->countText(a.text, a.byteLength));
+    }
+    static bool equal(const DrawPosTextH& a, const DrawPosTextH& b) {
+        return equal(a.paint, b.paint)
+            && equal_text(a, b)
+            && a.y == b.y
+            && same<SkScalar>(a.xpos, b.xpos, a.paint->countText(a.text, a.byteLength));
+    }
+    static bool equal(const DrawText& a, const DrawText& b) {
+        return equal(a.paint, b.paint)
+            && equal_text(a, b)
+            && a.x == b.x && a.y == b.y;
+    }
+    static bool equal(const DrawTextOnPath& a, const DrawTextOnPath& b) {
+        return equal(a.paint, b.paint)
+            && equal_text(a, b)
+            && a.path == b.path && a.matrix == b.matrix;
+    }
+    static bool equal(const DrawTextRSXform& a, const DrawTextRSXform& b) {
+        return equal(a.paint, b.paint)
+            && equal_text(a, b)
+            && same<SkRSXform>(a.xforms, b.xforms, a.paint->countText(a.text, a.byteLength))
+            && same<SkRect>(a.cull, b.cull);
+    }
+    static bool equal(const DrawTextBlob& a, const DrawTextBlob& b) {
+        return equal(a.paint, b.paint) && a.blob == b.blob && a.x == b.x && a.y == b.y;
+    }
+
+    static bool equal(const DrawRRect& a, const DrawRRect& b) {
+        return equal(a.paint, b.paint) && a.rrect == b.rrect;
+    }
+    static bool equal(const DrawRect& a, const DrawRect& b) {
+        return equal(a.paint, b.paint) && a.rect == b.rect;
+    }
+    static bool equal(const DrawRegion& a, const DrawRegion& b) {
+        return equal(a.paint, b.paint) && a.region == b.region;
+    }
+    static bool equal(const DrawAtlas& a, const DrawAtlas& b) {
+        return same<SkPaint>(a.paint, b.paint) && a.atlas == b.atlas && a.count == b.count
+            && same<SkRSXform>(a.xforms, b.xforms, a.count)
+            && same<SkRect>   (a.texs,   b.texs,   a.count)
+            && same<SkColor>  (a.colors, b.colors, a.count)
+            && a.mode == b.mode && same<SkRect>(a.cull, b.cull);
+    }
+    static bool equal(const DrawVertices& a, const DrawVertices& b) {
+        return equal(a.paint, b.paint) && a.vmode == b.vmode
+            && a.vertexCount == b.vertexCount
+            && same<SkPoint>(a.vertices, b.vertices, a.vertexCount)
+            && same<SkPoint>(a.texs,     b.texs,     a.vertexCount)
+            && same<SkColor>(a.colors,   b.colors,   a.vertexCount)
+            && a.xmode == b.xmode
+            && a.indexCount == b.indexCount
+            && same<uint16_t>(a.indices, b.indices, a.indexCount);
+    }
+    static bool equal(const DrawAnnotation& a, const DrawAnnotation& b) {
+        return a.rect == b.rect && a.key == b.key && same(a.value.get(), b.value.get());
+    }
+
+    const SkRecord& fOther;
+    const int       fJ;
+};
+
+}  // namespace
+
+bool SkRecordOpsEqual(const SkRecord& a, int i, const SkRecord& b, int j) {
+    return a.visit(i, OpsEqual(b, j));
+}
+
+SkRect SkRecordComputeDamage(const SkRecord& before, const SkRect beforeBounds[],
+                             const SkRecord& after,  const SkRect afterBounds[],
+                             bool* identical) {
+    auto unchanged = [&](int i, int j) {
+        return beforeBounds[i] == afterBounds[j] && SkRecordOpsEqual(before, i, after, j);
+    };
+
+    // Most edits leave a long run of ops untouched at either end.  Match those up first.
+    const int n = before.count(),
+              m = after.count();
+    int prefix = 0;
+    while (prefix < n && prefix < m && unchanged(prefix, prefix)) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix && unchanged(n-1-suffix, m-1-suffix)) {
+        suffix++;
+    }
+
+    SkRect damage = SkRect::MakeEmpty();
+    bool same = (n == m);
+    if (n == m) {
+        // Nothing was added or removed (or as much as was removed was added back), so pair the
+        // ops in between up one to one and only damage those that changed.
+        for (int i = prefix; i < n - suffix; i++) {
+            if (!unchanged(i, i)) {
+                damage.join(beforeBounds[i]);
+                damage.join(afterBounds[i]);
+                same = false;
+            }
+        }
+    } else {
+        for (int i = prefix; i < n - suffix; i++) { damage.join(beforeBounds[i]); }
+        for (int j = prefix; j < m - suffix; j++) { damage.join( afterBounds[j]); }
+    }
+
+    if (identical) {
+        *identical = same;
+    }
+    return damage;
+}
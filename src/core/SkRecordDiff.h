@@ -0,0 +1,25 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordDiff_DEFINED
+#define SkRecordDiff_DEFINED
+
+#include "SkRecord.h"
+#include "SkRect.h"
+
+// Compare two recordings made with the same cull rect, using bounds from SkRecordFillBounds().
+// Returns the union of the bounds of every op that was added, removed, or changed, before and
+// after.  If identical is not null, it's set to whether every op and its bounds is unchanged.
+SkRect SkRecordComputeDamage(const SkRecord& before, const SkRect beforeBounds[],
+                             const SkRecord& after,  const SkRect afterBounds[],
+                             bool* identical = nullptr);
+
+// Is op i of a the same as op j of b?  Ops referring to immutable objects (images, pictures,
+// text blobs) are the same only if they refer to the same object.  Drawables never match.
+bool SkRecordOpsEqual(const SkRecord& a, int i, const SkRecord& b, int j);
+
+#endif//SkRecordDiff_DEFINED
@@ -6,7 +6,52 @@
  */
 
 #include "SkRecordDraw.h"
+#include "SkClipStack.h"
 #include "SkPatchUtils.h"
+#include "SkRecordOpts.h"
+
+// The ops SkRecordComputeOccludedOps() finds are only hidden if nothing at playback time can make
+// the occluders' edges or clip partially transparent, or shrink its one unit margin below a pixel.
+static bool can_skip_occluded_ops(SkCanvas* canvas) {
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    if (ctm.hasPerspective() || ctm.getMinScale() < 1) {
+        return false;
+    }
+#ifdef SK_SUPPORT_LEGACY_DRAWFILTER
+    if (canvas->getDrawFilter()) {
+        return false;
+    }
+#endif
+    if (const SkClipStack* clipStack = canvas->getClipStack()) {
+        SkClipStack::B2TIter iter(*clipStack);
+        while (const SkClipStack::Element* element = iter.next()) {
+            if (element->isAA()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Walks a sorted list of occluded ops alongside increasing op indices.
+class OccludedOps {
+public:
+    explicit OccludedOps(const SkTDArray<int>* occluded) : fOccluded(occluded), fNext(0) {}
+
+    bool contains(int op) {
+        if (!fOccluded) {
+            return false;
+        }
+        while (fNext < fOccluded->count() && (*fOccluded)[fNext] < op) {
+            fNext++;
+        }
+        return fNext < fOccluded->count() && (*fOccluded)[fNext] == op;
+    }
+
+private:
+    const SkTDArray<int>* fOccluded;
+    int                   fNext;
+};
 
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
@@ -14,9 +59,11 @@ void SkRecordDraw(const SkRecord& record,
                   SkDrawable* const drawables[],
                   int drawableCount,
                   const SkBBoxHierarchy* bbh,
-                  SkPicture::AbortCallback* callback) {
+                  SkPicture::AbortCallback* callback,
+                  const SkTDArray<int>* occluded) {
     SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
 
+    OccludedOps skip(occluded && can_skip_occluded_ops(canvas) ? occluded : nullptr);
     if (bbh) {
         // Draw only ops that affect pixels in the canvas's current clip.
         // The SkRecord and BBH were recorded in identity space.  This canvas
@@ -36,6 +83,9 @@ void SkRecordDraw(const SkRecord& record,
             if (callback && callback->abort()) {
                 return;
             }
+            if (skip.contains(ops[i])) {
+                continue;
+            }
             // This visit call uses the SkRecords::Draw::operator() to call
             // methods on the |canvas|, wrapped by methods defined with the
             // DRAW() macro.
@@ -48,6 +98,9 @@ void SkRecordDraw(const SkRecord& record,
             if (callback && callback->abort()) {
                 return;
             }
+            if (skip.contains(i)) {
+                continue;
+            }
             // This visit call uses the SkRecords::Draw::operator() to call
             // methods on the |canvas|, wrapped by methods defined with the
             // DRAW() macro.
@@ -96,8 +149,8 @@ DRAW(TranslateZ, SkCanvas::translateZ(r.z));
 template <> void Draw::draw(const TranslateZ& r) { }
 #endif
 
-DRAW(DrawArc, drawArc(r.oval, r.startAngle, r.sweepAngle, r.useCenter, r.paint));
-DRAW(DrawDRRect, drawDRRect(r.outer, r.inner, r.paint));
+DRAW(DrawArc, drawArc(r.oval, r.startAngle, r.sweepAngle, r.useCenter, *r.paint));
+DRAW(DrawDRRect, drawDRRect(r.outer, r.inner, *r.paint));
 DRAW(DrawImage, drawImage(r.image.get(), r.left, r.top, r.paint));
 
 template <> void Draw::draw(const DrawImageLattice& r) {
@@ -113,10 +166,10 @@ template <> void Draw::draw(const DrawImageLattice& r) {
 
 DRAW(DrawImageRect, legacy_drawImageRect(r.image.get(), r.src, r.dst, r.paint, r.constraint));
 DRAW(DrawImageNine, drawImageNine(r.image.get(), r.center, r.dst, r.paint));
-DRAW(DrawOval, drawOval(r.oval, r.paint));
-DRAW(DrawPaint, drawPaint(r.paint));
-DRAW(DrawPath, drawPath(r.path, r.paint));
-DRAW(DrawPatch, drawPatch(r.cubics, r.colors, r.texCoords, r.xmode, r.paint));
+DRAW(DrawOval, drawOval(r.oval, *r.paint));
+DRAW(DrawPaint, drawPaint(*r.paint));
+DRAW(DrawPath, drawPath(r.path, *r.paint));
+DRAW(DrawPatch, drawPatch(r.cubics, r.colors, r.texCoords, r.xmode, *r.paint));
 DRAW(DrawPicture, drawPicture(r.picture.get(), &r.matrix, r.paint));
 
 #ifdef SK_EXPERIMENTAL_SHADOWING
@@ -125,20 +178,20 @@ DRAW(DrawShadowedPicture, drawShadowedPicture(r.picture.get(), &r.matrix, r.pain
 template <> void Draw::draw(const DrawShadowedPicture& r) { }
 #endif
 
-DRAW(DrawPoints, drawPoints(r.mode, r.count, r.pts, r.paint));
-DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, r.paint));
-DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, r.paint));
-DRAW(DrawRRect, drawRRect(r.rrect, r.paint));
-DRAW(DrawRect, drawRect(r.rect, r.paint));
-DRAW(DrawRegion, drawRegion(r.region, r.paint));
-DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, r.paint));
-DRAW(DrawTextBlob, drawTextBlob(r.blob.get(), r.x, r.y, r.paint));
-DRAW(DrawTextOnPath, drawTextOnPath(r.text, r.byteLength, r.path, &r.matrix, r.paint));
-DRAW(DrawTextRSXform, drawTextRSXform(r.text, r.byteLength, r.xforms, r.cull, r.paint));
+DRAW(DrawPoints, drawPoints(r.mode, r.count, r.pts, *r.paint));
+DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, *r.paint));
+DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, *r.paint));
+DRAW(DrawRRect, drawRRect(r.rrect, *r.paint));
+DRAW(DrawRect, drawRect(r.rect, *r.paint));
+DRAW(DrawRegion, drawRegion(r.region, *r.paint));
+DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, *r.paint));
+DRAW(DrawTextBlob, drawTextBlob(r.blob.get(), r.x, r.y, *r.paint));
+DRAW(DrawTextOnPath, drawTextOnPath(r.text, r.byteLength, r.path, &r.matrix, *r.paint));
+DRAW(DrawTextRSXform, drawTextRSXform(r.text, r.byteLength, r.xforms, r.cull, *r.paint));
 DRAW(DrawAtlas, drawAtlas(r.atlas.get(),
                           r.xforms, r.texs, r.colors, r.count, r.mode, r.cull, r.paint));
 DRAW(DrawVertices, drawVertices(r.vmode, r.vertexCount, r.vertices, r.texs, r.colors,
-                                r.xmode, r.indices, r.indexCount, r.paint));
+                                r.xmode, r.indices, r.indexCount, *r.paint));
 DRAW(DrawAnnotation, drawAnnotation(r.rect, r.key.c_str(), r.value.get()));
 #undef DRAW
 
@@ -408,19 +461,19 @@ private:
     Bounds bounds(const DrawPaint&) const { return fCurrentClipBounds; }
     Bounds bounds(const NoOp&)  const { return Bounds::MakeEmpty(); }    // NoOps don't draw.
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint); }
     Bounds bounds(const DrawRegion& op) const {
         SkRect rect = SkRect::Make(op.region.getBounds());
-        return this->adjustAndMap(rect, &op.paint);
+        return this->adjustAndMap(rect, op.paint);
     }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint); }
     // Tighter arc bounds?
-    Bounds bounds(const DrawArc& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawArc& op) const { return this->adjustAndMap(op.oval, op.paint); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint);
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint);
     }
     Bounds bounds(const DrawImage& op) const {
         const SkImage* image = op.image.get();
@@ -439,27 +492,27 @@ private:
     }
     Bounds bounds(const DrawPath& op) const {
         return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+                                           : this->adjustAndMap(op.path.getBounds(), op.paint);
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawAtlas& op) const {
@@ -485,18 +538,18 @@ private:
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
 
         SkRect dst;
         dst.set(op.pos, N);
-        AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        AdjustTextForFontMetrics(&dst, *op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -507,15 +560,15 @@ private:
             right = SkMaxScalar(right, op.xpos[i]);
         }
         SkRect dst = { left, op.y, right, op.y };
-        AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        AdjustTextForFontMetrics(&dst, *op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
 
         // Pad all sides by the maximum padding in any direction we'd normally apply.
         SkRect pad = { 0, 0, 0, 0};
-        AdjustTextForFontMetrics(&pad, op.paint);
+        AdjustTextForFontMetrics(&pad, *op.paint);
 
         // That maximum padding happens to always be the right pad today.
         SkASSERT(pad.fLeft == -pad.fRight);
@@ -523,7 +576,7 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawTextRSXform& op) const {
@@ -537,7 +590,7 @@ private:
     Bounds bounds(const DrawTextBlob& op) const {
         SkRect dst = op.blob->bounds();
         dst.offset(op.x, op.y);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawDrawable& op) const {
@@ -620,6 +673,137 @@ private:
     SkTDArray<int>   fControlIndices;
 };
 
+// FindOccluders walks an SkRecord front to back, noting for each op which clip it draws into and,
+// for opaque draws of simple shapes, the identity-space rect they are sure to cover.
+class FindOccluders : SkNoncopyable {
+public:
+    // A clip, as far as occlusion is concerned.  Clips that only ever shrink their parent know
+    // that everything drawn into them is also inside the parent clip.
+    struct Clip {
+        int  parent;    // Or -1 if this clip may be larger than its predecessor.
+        bool hard;      // Is every pixel either fully in or fully out of the clip?
+    };
+
+    struct Occluder {
+        int    op;
+        int    clip;
+        SkRect bounds;  // Identity space, already inset by one unit.
+    };
+
+    explicit FindOccluders(int numOps) : fCurrentClip(0), fOpClips(numOps) {
+        fCTM = SkMatrix::I();
+        *fClips.append() = { -1, true };
+    }
+
+    void setCurrentOp(int currentOp) { fCurrentOp = currentOp; }
+
+    template <typename T> void operator()(const T& op) {
+        this->updateCTM(op);
+        this->updateClip(op);
+        fOpClips[fCurrentOp] = IsVictim(op) ? fCurrentClip : -1;
+        if (IsBarrier(op)) {
+            fBarriers.push(fCurrentOp);
+        }
+
+        SkRect bounds;
+        if (this->occludes(op, &bounds)) {
+            *fOccluders.append() = { fCurrentOp, fCurrentClip, bounds };
+        }
+    }
+
+    const SkTDArray<Clip>&     clips()     const { return fClips; }
+    const SkTDArray<Occluder>& occluders() const { return fOccluders; }
+    // Ops that may read back what was drawn before them, so nothing before them is hidden by
+    // anything after them.
+    const SkTDArray<int>&      barriers()  const { return fBarriers; }
+    // The clip an op draws into, or -1 if it should never be skipped.
+    int opClip(int op) const { return fOpClips[op]; }
+
+private:
+    template <typename T> void updateCTM(const T&) {}
+    void updateCTM(const Restore& op)   { fCTM = op.matrix; }
+    void updateCTM(const SetMatrix& op) { fCTM = op.matrix; }
+    void updateCTM(const Concat& op)    { fCTM.preConcat(op.matrix); }
+    void updateCTM(const Translate& op) { fCTM.preTranslate(op.dx, op.dy); }
+
+    template <typename T> void updateClip(const T&) {}
+    void updateClip(const Save&) { fSaveStack.push(fCurrentClip); }
+    void updateClip(const SaveLayer&) {
+        // Draws into a layer can only be compared with other draws into the same layer.
+        fSaveStack.push(fCurrentClip);
+        this->pushClip(false, false);
+    }
+    void updateClip(const Restore&) {
+        if (!fSaveStack.isEmpty()) {
+            fSaveStack.pop(&fCurrentClip);
+        }
+    }
+    void updateClip(const ClipPath& op)   { this->pushClip(Shrinks(op.opAA.op), op.opAA.aa); }
+    void updateClip(const ClipRRect& op)  { this->pushClip(Shrinks(op.opAA.op), op.opAA.aa); }
+    void updateClip(const ClipRect& op)   { this->pushClip(Shrinks(op.opAA.op), op.opAA.aa); }
+    void updateClip(const ClipRegion& op) { this->pushClip(Shrinks(op.op), false); }
+
+    static bool Shrinks(SkCanvas::ClipOp op) {
+        return op == SkCanvas::kIntersect_Op || op == SkCanvas::kDifference_Op;
+    }
+
+    void pushClip(bool shrinks, bool aa) {
+        const bool hard = fClips[fCurrentClip].hard && !aa;
+        *fClips.append() = { shrinks ? fCurrentClip : -1, hard };
+        fCurrentClip = fClips.count() - 1;
+    }
+
+    // Any draw may be skipped, except nested pictures and drawables, which may do more than draw
+    // (e.g. annotate).  Annotations themselves aren't draws.
+    template <typename T>
+    static SK_WHEN(T::kTags & kDraw_Tag, bool) IsVictim(const T&) { return true; }
+    template <typename T>
+    static SK_WHEN(!(T::kTags & kDraw_Tag), bool) IsVictim(const T&) { return false; }
+    static bool IsVictim(const DrawDrawable&)        { return false; }
+    static bool IsVictim(const DrawPicture&)         { return false; }
+    static bool IsVictim(const DrawShadowedPicture&) { return false; }
+
+    // Backdrop layers read what's underneath them, and nested pictures and drawables might.
+    template <typename T> static bool IsBarrier(const T&) { return false; }
+    static bool IsBarrier(const SaveLayer& op)          { return SkToBool(op.backdrop); }
+    static bool IsBarrier(const DrawDrawable&)          { return true; }
+    static bool IsBarrier(const DrawPicture&)           { return true; }
+    static bool IsBarrier(const DrawShadowedPicture&)   { return true; }
+
+    // Antialiased occluders are fine here: covers() leaves a unit's margin for their edges.
+    template <typename T> bool occludes(const T& op, SkRect* bounds) const {
+        OccluderBounds occluder;
+        if (!occluder(op)) {
+            return false;
+        }
+        if (occluder.fEverything) {
+            bounds->setLargest();
+            return fClips[fCurrentClip].hard;
+        }
+        return this->covers(occluder.fBounds, bounds);
+    }
+
+    // Map rect to identity space, less a unit all round for antialiasing and pixel snapping.
+    bool covers(const SkRect& rect, SkRect* bounds) const {
+        if (!fClips[fCurrentClip].hard || !fCTM.rectStaysRect()) {
+            return false;
+        }
+        fCTM.mapRect(bounds, rect);
+        bounds->sort();
+        bounds->inset(SK_Scalar1, SK_Scalar1);
+        return bounds->isFinite() && !bounds->isEmpty();
+    }
+
+    int                    fCurrentOp;
+    SkMatrix               fCTM;
+    int                    fCurrentClip;
+    SkTDArray<Clip>        fClips;
+    SkTDArray<int>         fSaveStack;
+    SkAutoTMalloc<int>     fOpClips;
+    SkTDArray<Occluder>    fOccluders;
+    SkTDArray<int>         fBarriers;
+};
+
 }  // namespace SkRecords
 
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[]) {
@@ -631,3 +815,78 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect b
     visitor.cleanUp();
 }
 
+
+void SkRecordComputeOccludedOps(const SkRecord& record, const SkRect bounds[],
+                                SkTDArray<int>* occluded) {
+    SkRecords::FindOccluders visitor(record.count());
+    for (int curOp = 0; curOp < record.count(); curOp++) {
+        visitor.setCurrentOp(curOp);
+        record.visit(curOp, visitor);
+    }
+    const SkTDArray<SkRecords::FindOccluders::Clip>& clips = visitor.clips();
+    const SkTDArray<SkRecords::FindOccluders::Occluder>& occluders = visitor.occluders();
+    const SkTDArray<int>& barriers = visitor.barriers();
+    if (occluders.isEmpty()) {
+        return;
+    }
+
+    // Walk back to front, keeping the largest few occluders seen so far in each clip.
+    static const int kMaxOccludersPerClip = 4;
+    SkAutoTArray<SkTDArray<SkRect>> covered(clips.count());
+    SkTDArray<int> coveredClips;  // Those with anything in covered.
+    int nextOccluder = occluders.count() - 1,
+        nextBarrier  = barriers.count() - 1;
+    const int firstOccluded = occluded->count();
+    for (int op = record.count() - 1; op >= 0; op--) {
+        if (nextBarrier >= 0 && barriers[nextBarrier] == op) {
+            nextBarrier--;
+            for (int clip : coveredClips) {
+                covered[clip].rewind();
+            }
+            coveredClips.rewind();
+        }
+
+        // An op drawn into a clip is also inside each clip that clip shrank.
+        bool hidden = false;
+        for (int clip = visitor.opClip(op); clip >= 0 && !hidden; clip = clips[clip].parent) {
+            for (const SkRect& rect : covered[clip]) {
+                if (rect.contains(bounds[op])) {
+                    hidden = true;
+                    break;
+                }
+            }
+        }
+        if (hidden) {
+            occluded->push(op);
+            continue;
+        }
+
+        if (nextOccluder >= 0 && occluders[nextOccluder].op == op) {
+            const SkRecords::FindOccluders::Occluder& occluder = occluders[nextOccluder--];
+            SkTDArray<SkRect>* rects = &covered[occluder.clip];
+            if (rects->isEmpty()) {
+                coveredClips.push(occluder.clip);
+            }
+            if (rects->count() < kMaxOccludersPerClip) {
+                rects->push(occluder.bounds);
+            } else {
+                // Replace the smallest, if this one is bigger.
+                SkRect* smallest = rects->begin();
+                for (SkRect& rect : *rects) {
+                    if (rect.width() * rect.height() < smallest->width() * smallest->height()) {
+                        smallest = &rect;
+                    }
+                }
+                if (occluder.bounds.width()  * occluder.bounds.height() >
+                    smallest->width() * smallest->height()) {
+                    *smallest = occluder.bounds;
+                }
+            }
+        }
+    }
+
+    // We found them back to front.
+    for (int i = firstOccluded, j = occluded->count() - 1; i < j; i++, j--) {
+        SkTSwap((*occluded)[i], (*occluded)[j]);
+    }
+}
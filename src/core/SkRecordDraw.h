@@ -26,10 +26,18 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&, SkRect bounds[]
 void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord&, SkRect bounds[],
                            const SkBigPicture::SnapshotArray*, SkLayerInfo* data);
 
+// Find the draws that are completely covered by later opaque draws into the same clip, and so
+// can be skipped when played back without scaling down or antialiased clipping.  bounds are
+// those from SkRecordFillBounds().  Appends the ops' indices to occluded, in increasing order.
+void SkRecordComputeOccludedOps(const SkRecord&, const SkRect bounds[], SkTDArray<int>* occluded);
+
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
+// If occluded is not null, ops listed there by SkRecordComputeOccludedOps() are skipped when
+// the canvas's matrix and clip allow it.  The caller vouches that canvas won't rewrite paints.
 void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
                   SkDrawable* const drawables[], int drawableCount,
-                  const SkBBoxHierarchy*, SkPicture::AbortCallback*);
+                  const SkBBoxHierarchy*, SkPicture::AbortCallback*,
+                  const SkTDArray<int>* occluded = nullptr);
 
 // Draw a portion of an SkRecord into an SkCanvas.
 // When drawing a portion of an SkRecord the CTM on the passed in canvas must be
@@ -7,8 +7,10 @@
 
 #include "SkRecordOpts.h"
 
+#include "SkPaintPriv.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkRegion.h"
 #include "SkTDArray.h"
 #include "SkXfermode.h"
 
@@ -195,7 +197,7 @@ struct SaveLayerDrawRestoreNooper {
 
         // A SaveLayer's bounds field is just a hint, so we should be free to ignore it.
         SkPaint* layerPaint = match->first<SaveLayer>()->paint;
-        SkPaint* drawPaint = match->second<SkPaint>();
+        const SkPaint* drawPaint = match->second<const SkPaint>();
 
         if (nullptr == layerPaint && effectively_srcover(drawPaint)) {
             // There wasn't really any point to this SaveLayer at all.
@@ -208,13 +210,31 @@ struct SaveLayerDrawRestoreNooper {
             return false;
         }
 
-        if (!fold_opacity_layer_color_to_paint(layerPaint, false /*isSaveLayer*/, drawPaint)) {
+        // The draw's paint may be shared, so fold into a copy and give the draw that instead.
+        SkPaint folded = *drawPaint;
+        if (!fold_opacity_layer_color_to_paint(layerPaint, false /*isSaveLayer*/, &folded)) {
             return false;
         }
+        record->mutate(begin+1, PaintSetter{record, folded});
 
         return KillSaveLayerAndRestore(record, begin);
     }
 
+    // Replaces a draw's paint with paint.
+    struct PaintSetter {
+        SkRecord* record;
+        const SkPaint& paint;
+
+        template <typename T>
+        SK_WHEN(T::kTags & kHasPaint_Tag, void) operator()(T* draw) { this->set(&draw->paint); }
+
+        template <typename T>
+        SK_WHEN(!(T::kTags & kHasPaint_Tag), void) operator()(T*) { SkASSERT(false); }
+
+        void set(SharedPaint* dst)       { *dst = record->internPaint(paint); }
+        void set(Optional<SkPaint>* dst) { **dst = paint; }
+    };
+
     static bool KillSaveLayerAndRestore(SkRecord* record, int saveLayerIndex) {
         record->replace<NoOp>(saveLayerIndex);    // SaveLayer
         record->replace<NoOp>(saveLayerIndex+2);  // Restore
@@ -283,6 +303,430 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Matches a Translate or Concat, and stores the matrix it concatenates onto the CTM.
+class IsPreConcat {
+public:
+    typedef SkMatrix type;
+    type* get() { return &fMatrix; }
+
+    bool operator()(Translate* op) {
+        fMatrix.setTranslate(op->dx, op->dy);
+        return true;
+    }
+    bool operator()(Concat* op) {
+        fMatrix = op->matrix;
+        return true;
+    }
+    template <typename T>
+    bool operator()(T*) { return false; }
+
+private:
+    SkMatrix fMatrix;
+};
+
+// Replaces Translate/Concat-[NoOp]*-Translate/Concat with a single Translate or Concat.
+struct PreConcatMerger {
+    typedef Pattern<IsPreConcat, Greedy<Is<NoOp>>, IsPreConcat> Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const SkMatrix m = SkMatrix::Concat(*match->first<SkMatrix>(), *match->third<SkMatrix>());
+        record->replace<NoOp>(begin);
+        if (!(m.getType() & ~SkMatrix::kTranslate_Mask)) {
+            new (record->replace<Translate>(end-1)) Translate{m.getTranslateX(),
+                                                              m.getTranslateY()};
+        } else {
+            new (record->replace<Concat>(end-1)) Concat{TypedMatrix(m)};
+        }
+        return true;
+    }
+};
+
+// Folds the Translate or Concat in SetMatrix-[NoOp]*-Translate/Concat into the SetMatrix.
+struct SetMatrixPreConcatMerger {
+    typedef Pattern<Is<SetMatrix>, Greedy<Is<NoOp>>, IsPreConcat> Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        SetMatrix* setMatrix = match->first<SetMatrix>();
+        setMatrix->matrix = TypedMatrix(SkMatrix::Concat(setMatrix->matrix,
+                                                         *match->third<SkMatrix>()));
+        record->replace<NoOp>(end-1);
+        return true;
+    }
+};
+
+void SkRecordCollapseMatrices(SkRecord* record) {
+    PreConcatMerger preConcats;
+    SetMatrixPreConcatMerger setMatrices;
+
+    // Each run merges pairs, so chains take a few runs to collapse.
+    while (apply(&preConcats, record));
+    while (apply(&setMatrices, record));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// For ClipRect-[NoOp]*-ClipRect where both intersect and one rect contains the other, the larger
+// clip makes no difference.
+struct NestedClipRectNooper {
+    typedef Pattern<Is<ClipRect>, Greedy<Is<NoOp>>, Is<ClipRect>> Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const ClipRect* outer = match->first<ClipRect>();
+        const ClipRect* inner = match->third<ClipRect>();
+        if (outer->opAA.op != SkCanvas::kIntersect_Op ||
+            inner->opAA.op != SkCanvas::kIntersect_Op ||
+            outer->opAA.aa != inner->opAA.aa) {
+            return false;
+        }
+        // Each clip's devBounds is that of the whole clip stack after it, so either one is right.
+        if (outer->rect.contains(inner->rect)) {
+            record->replace<NoOp>(begin);
+            return true;
+        }
+        if (inner->rect.contains(outer->rect)) {
+            record->replace<NoOp>(end-1);
+            return true;
+        }
+        return false;
+    }
+};
+
+// Clips and matrix changes followed by nothing but more of the same before a Restore do nothing.
+struct DeadStateRestoreNooper {
+    typedef Or<Is<ClipPath>, Is<ClipRRect>, Is<ClipRect>, Is<ClipRegion>,
+               Is<SetMatrix>, Is<Translate>, Is<Concat>> IsStateChange;
+    typedef Pattern<IsStateChange,
+                    Greedy<Or<Is<NoOp>, IsStateChange>>,
+                    Is<Restore>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match*, int begin, int end) {
+        for (int i = begin; i < end-1; i++) {
+            record->replace<NoOp>(i);
+        }
+        return true;
+    }
+};
+
+void SkRecordNoopRedundantClips(SkRecord* record) {
+    NestedClipRectNooper nested;
+    DeadStateRestoreNooper dead;
+
+    while (apply(&nested, record));
+    apply(&dead, record);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static SkRect sorted(const SkRect& rect) {
+    SkRect r = rect;
+    r.sort();
+    return r;
+}
+
+// Would drawing with this paint replace every pixel it fully covers?
+static bool overwrites(const SkPaint* paint, SkPaintPriv::ShaderOverrideOpacity opacity) {
+    if (paint && (paint->getStyle() != SkPaint::kFill_Style ||
+                  paint->getPathEffect()                    ||
+                  paint->getMaskFilter()                    ||
+                  paint->getLooper()                        ||
+                  paint->getImageFilter())) {
+        return false;
+    }
+    return SkPaintPriv::Overwrites(paint, opacity);
+}
+
+static SkPaintPriv::ShaderOverrideOpacity image_opacity(const SkImage* image) {
+    return image->isOpaque() ? SkPaintPriv::kOpaque_ShaderOverrideOpacity
+                             : SkPaintPriv::kNotOpaque_ShaderOverrideOpacity;
+}
+
+// Does this DrawImageRect fill all of its dst?  A src reaching past the image leaves a gap.
+static bool fills_dst(const DrawImageRect& op) {
+    return !op.src || SkRect::MakeIWH(op.image->width(), op.image->height()).contains(*op.src);
+}
+
+bool OccluderBounds::operator()(const DrawPaint& op) {
+    fEverything = true;
+    fAntiAlias = false;
+    return overwrites(op.paint, SkPaintPriv::kNone_ShaderOverrideOpacity);
+}
+
+bool OccluderBounds::operator()(const DrawRect& op) {
+    fEverything = false;
+    fAntiAlias = op.paint->isAntiAlias();
+    fBounds = sorted(op.rect);
+    return overwrites(op.paint, SkPaintPriv::kNone_ShaderOverrideOpacity);
+}
+
+bool OccluderBounds::operator()(const DrawRRect& op) {
+    fEverything = false;
+    fAntiAlias = op.paint->isAntiAlias();
+    // The rrect covers its rect inset by its largest corner radii one way or the other.
+    SkRect rect = op.rrect.rect();
+    SkScalar rx = 0, ry = 0;
+    for (int i = 0; i < 4; i++) {
+        const SkVector radii = op.rrect.radii((SkRRect::Corner)i);
+        rx = SkTMax(rx, radii.fX);
+        ry = SkTMax(ry, radii.fY);
+    }
+    if (rect.width() * (rect.height() - 2*ry) > rect.height() * (rect.width() - 2*rx)) {
+        rect.inset(0, ry);
+    } else {
+        rect.inset(rx, 0);
+    }
+    fBounds = rect;
+    return !rect.isEmpty() && overwrites(op.paint, SkPaintPriv::kNone_ShaderOverrideOpacity);
+}
+
+bool OccluderBounds::operator()(const DrawImage& op) {
+    fEverything = false;
+    fAntiAlias = op.paint && op.paint->isAntiAlias();
+    fBounds = SkRect::MakeXYWH(op.left, op.top, op.image->width(), op.image->height());
+    return overwrites(op.paint, image_opacity(op.image.get()));
+}
+
+bool OccluderBounds::operator()(const DrawImageRect& op) {
+    fEverything = false;
+    fAntiAlias = op.paint && op.paint->isAntiAlias();
+    fBounds = sorted(op.dst);
+    return fills_dst(op) && overwrites(op.paint, image_opacity(op.image.get()));
+}
+
+// Decides whether a draw could be dropped underneath an occluder.
+struct IsOccludedBy {
+    explicit IsOccludedBy(const OccluderBounds& occluder) : fOccluder(occluder) {}
+
+    // Any draw is hidden by something covering the whole clip, but nested pictures and drawables
+    // may do more than draw (e.g. annotate), so they're always kept.
+    template <typename T>
+    SK_WHEN(T::kTags & kDraw_Tag, bool) operator()(const T&) { return fOccluder.fEverything; }
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), bool) operator()(const T&) { return false; }
+    bool operator()(const DrawPicture&)         { return false; }
+    bool operator()(const DrawShadowedPicture&) { return false; }
+    bool operator()(const DrawDrawable&)        { return false; }
+
+    bool operator()(const DrawArc& op)    { return this->covers(op.oval, op.paint); }
+    bool operator()(const DrawDRRect& op) { return this->covers(op.outer.getBounds(), op.paint); }
+    bool operator()(const DrawOval& op)   { return this->covers(op.oval, op.paint); }
+    bool operator()(const DrawRRect& op)  { return this->covers(op.rrect.getBounds(), op.paint); }
+    bool operator()(const DrawRect& op)   { return this->covers(op.rect, op.paint); }
+    bool operator()(const DrawRegion& op) {
+        return this->covers(SkRect::Make(op.region.getBounds()), op.paint);
+    }
+    bool operator()(const DrawPath& op) {
+        return fOccluder.fEverything ||
+               (!op.path.isInverseFillType() && this->covers(op.path.getBounds(), op.paint));
+    }
+    bool operator()(const DrawImage& op) {
+        return this->covers(SkRect::MakeXYWH(op.left, op.top,
+                                             op.image->width(), op.image->height()), op.paint);
+    }
+    bool operator()(const DrawImageRect& op) {
+        return fills_dst(op) && this->covers(op.dst, op.paint);
+    }
+    bool operator()(const DrawImageNine& op)    { return this->covers(op.dst, op.paint); }
+    bool operator()(const DrawImageLattice& op) { return this->covers(op.dst, op.paint); }
+
+    // Non-antialiased draws only touch pixels whose centers they cover, so if the occluder
+    // (also non-antialiased) covers their bounds, it covers every pixel they touch.
+    bool covers(const SkRect& rect, const SkPaint* paint) const {
+        if (fOccluder.fEverything) {
+            return true;
+        }
+        const SkRect r = sorted(rect);
+        SkRect storage;
+        const SkRect* bounds = &r;
+        if (paint) {
+            if (paint->isAntiAlias() || !paint->canComputeFastBounds()) {
+                return false;
+            }
+            if (paint->getStyle() != SkPaint::kFill_Style && 0 == paint->getStrokeWidth()) {
+                return false;  // Hairlines don't follow the pixel center rule.
+            }
+            bounds = &paint->computeFastBounds(r, &storage);
+        }
+        return fOccluder.fBounds.contains(*bounds);
+    }
+
+    const OccluderBounds& fOccluder;
+};
+
+// Can draws on either side of this command be compared directly?  Only if it changes no state.
+struct IsStateBarrier {
+    template <typename T>
+    SK_WHEN(T::kTags & kDraw_Tag, bool) operator()(const T&) { return false; }
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), bool) operator()(const T&) { return true; }
+    bool operator()(const NoOp&)           { return false; }
+    bool operator()(const DrawAnnotation&) { return false; }
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    // How far back to look from each occluder, to keep this linear in the worst case.
+    static const int kMaxLookback = 64;
+
+    int runStart = 0;
+    for (int i = 0; i < record->count(); i++) {
+        if (record->visit(i, IsStateBarrier())) {
+            runStart = i + 1;
+            continue;
+        }
+        // Antialiased occluders would blend their edges over what we'd drop.
+        OccluderBounds occluder;
+        if (!record->visit(i, occluder) || occluder.fAntiAlias) {
+            continue;
+        }
+        IsOccludedBy occluded(occluder);
+        for (int j = i - 1; j >= SkTMax(runStart, i - kMaxLookback); j--) {
+            if (record->visit(j, occluded)) {
+                record->replace<NoOp>(j);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Returns the next command at or after i that isn't a NoOp, or record->count().
+static int skip_noops(SkRecord* record, int i) {
+    while (i < record->count() && record->mutate(i, Is<NoOp>())) {
+        i++;
+    }
+    return i;
+}
+
+static bool is_integral(const SkRect& r) {
+    return SkScalarIsInt(r.fLeft)  && SkScalarIsInt(r.fTop) &&
+           SkScalarIsInt(r.fRight) && SkScalarIsInt(r.fBottom);
+}
+
+// Can DrawRects with this paint be drawn as one DrawRegion?  They must not depend on anything
+// the region loses (antialiasing, stroking, each rect's own geometry for effects).
+static bool can_merge_rects(const SkPaint& paint) {
+    return !paint.isAntiAlias()                      &&
+           paint.getStyle() == SkPaint::kFill_Style  &&
+           !paint.getPathEffect()                    &&
+           !paint.getMaskFilter()                    &&
+           !paint.getLooper()                        &&
+           !paint.getImageFilter();
+}
+
+void SkRecordMergeDrawRects(SkRecord* record) {
+    Is<DrawRect> isDrawRect;
+    for (int i = 0; i < record->count(); i++) {
+        if (!record->mutate(i, isDrawRect)) {
+            continue;
+        }
+        const DrawRect* first = isDrawRect.get();
+        if (!can_merge_rects(*first->paint) || !is_integral(first->rect)) {
+            continue;
+        }
+
+        SkRegion region(sorted(first->rect).round());
+        int64_t area = region.getBounds().width() * (int64_t)region.getBounds().height();
+        SkTDArray<int> merged;
+        int j = skip_noops(record, i + 1);
+        for (; j < record->count() && record->mutate(j, isDrawRect); j = skip_noops(record, j+1)) {
+            const DrawRect* next = isDrawRect.get();
+            // Equal paints are interned to the same pointer.
+            if (next->paint != first->paint || !is_integral(next->rect)) {
+                break;
+            }
+            const SkIRect r = sorted(next->rect).round();
+            region.op(r, SkRegion::kUnion_Op);
+            area += r.width() * (int64_t)r.height();
+            merged.push(j);
+        }
+        if (merged.isEmpty()) {
+            continue;
+        }
+
+        // Overlapping rects would blend twice, unless the paint replaces what's underneath.
+        if (!SkPaintPriv::Overwrites(*first->paint)) {
+            int64_t regionArea = 0;
+            for (SkRegion::Iterator it(region); !it.done(); it.next()) {
+                regionArea += it.rect().width() * (int64_t)it.rect().height();
+            }
+            if (regionArea != area) {
+                continue;
+            }
+        }
+
+        SharedPaint paint = first->paint;
+        new (record->replace<DrawRegion>(i)) DrawRegion{paint, region};
+        for (int index : merged) {
+            record->replace<NoOp>(index);
+        }
+        i = j - 1;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Can pieces of an image drawn with this paint be drawn as one?  Without filtering or
+// antialiasing every pixel samples the same texel either way.
+static bool can_merge_image_rects(const SkPaint* paint) {
+    return !paint || (!paint->isAntiAlias()                                 &&
+                      paint->getFilterQuality() == kNone_SkFilterQuality    &&
+                      !paint->getShader()                                   &&
+                      !paint->getMaskFilter()                               &&
+                      !paint->getLooper()                                   &&
+                      !paint->getImageFilter());
+}
+
+// If next draws the piece of image abutting prev's, on the same scale, grow prev to cover both.
+static bool merge_image_rects(DrawImageRect* prev, const DrawImageRect& next) {
+    if (prev->image != next.image || !prev->src || !next.src ||
+        prev->constraint != next.constraint) {
+        return false;
+    }
+    const SkPaint* paint = prev->paint;
+    if (paint ? !next.paint || *paint != *next.paint : SkToBool(next.paint)) {
+        return false;
+    }
+
+    const SkRect &ps = *prev->src, &ns = *next.src;
+    const bool abutsX = ns.fLeft == ps.fRight  && ns.fTop  == ps.fTop  && ns.fBottom == ps.fBottom,
+               abutsY = ns.fTop  == ps.fBottom && ns.fLeft == ps.fLeft && ns.fRight  == ps.fRight;
+    if (!abutsX && !abutsY) {
+        return false;
+    }
+
+    SkMatrix srcToDst;
+    if (!srcToDst.setRectToRect(ps, prev->dst, SkMatrix::kFill_ScaleToFit)) {
+        return false;
+    }
+    SkRect mapped;
+    srcToDst.mapRect(&mapped, ns);
+    if (mapped != next.dst) {
+        return false;
+    }
+
+    prev->src->join(ns);
+    prev->dst.join(next.dst);
+    return true;
+}
+
+void SkRecordMergeDrawImageRects(SkRecord* record) {
+    Is<DrawImageRect> isPrev, isNext;
+    for (int i = 0; i < record->count(); i++) {
+        if (!record->mutate(i, isPrev) || !can_merge_image_rects(isPrev.get()->paint)) {
+            continue;
+        }
+        int j = skip_noops(record, i + 1);
+        while (j < record->count() && record->mutate(j, isNext) &&
+               merge_image_rects(isPrev.get(), *isNext.get())) {
+            record->replace<NoOp>(j);
+            j = skip_noops(record, j + 1);
+        }
+        i = j - 1;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -299,11 +743,46 @@ void SkRecordOptimize(SkRecord* record) {
     record->defrag();
 }
 
-void SkRecordOptimize2(SkRecord* record) {
-    multiple_set_matrices(record);
-    SkRecordNoopSaveRestores(record);
-    SkRecordNoopSaveLayerDrawRestores(record);
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
+static int count_live_ops(SkRecord* record) {
+    int count = 0;
+    for (int i = 0; i < record->count(); i++) {
+        count += !record->mutate(i, Is<NoOp>());
+    }
+    return count;
+}
+
+void SkRecordOptimize2(SkRecord* record, SkRecordOptStats* stats) {
+    static const struct {
+        const char* name;
+        void (*run)(SkRecord*);
+    } kPasses[] = {
+        { "multiple_set_matrices",     multiple_set_matrices },
+        { "collapse_matrices",         SkRecordCollapseMatrices },
+        { "redundant_clips",           SkRecordNoopRedundantClips },
+        { "save_restores",             SkRecordNoopSaveRestores },
+        { "save_layer_draw_restores",  SkRecordNoopSaveLayerDrawRestores },
+        { "svg_opacity_filter_layers", SkRecordMergeSvgOpacityAndFilterLayers },
+        { "occluded_draws",            SkRecordNoopOccludedDraws },
+        { "merge_draw_rects",          SkRecordMergeDrawRects },
+        { "merge_draw_image_rects",    SkRecordMergeDrawImageRects },
+    };
+
+    int live = stats ? count_live_ops(record) : 0;
+    if (stats) {
+        stats->fOpsBefore = live;
+        stats->fPasses.reset();
+    }
+    for (const auto& pass : kPasses) {
+        pass.run(record);
+        if (stats) {
+            const int now = count_live_ops(record);
+            *stats->fPasses.append() = { pass.name, live - now };
+            live = now;
+        }
+    }
+    if (stats) {
+        stats->fOpsAfter = live;
+    }
 
     record->defrag();
 }
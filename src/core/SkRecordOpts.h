@@ -9,6 +9,7 @@
 #define SkRecordOpts_DEFINED
 
 #include "SkRecord.h"
+#include "SkTDArray.h"
 
 // Run all optimizations in recommended order.
 void SkRecordOptimize(SkRecord*);
@@ -24,7 +25,57 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
-// Experimental optimizers
-void SkRecordOptimize2(SkRecord*);
+// Merges adjacent Translate and Concat commands, and folds them into a preceding SetMatrix.
+void SkRecordCollapseMatrices(SkRecord*);
+
+// No-ops clips made redundant by a neighboring clip, and clips and matrix changes that are
+// undone by a Restore before anything draws.
+void SkRecordNoopRedundantClips(SkRecord*);
+
+// No-ops draws that are entirely covered by a later opaque draw under the same matrix and clip.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+namespace SkRecords {
+
+// Finds the area an op paints over completely, whatever was underneath it.  For such an op,
+// returns true and sets fBounds in the op's local coordinates, or fEverything if it fills its
+// clip.  Antialiased edges may only partly cover the pixels along them, as fAntiAlias says.
+struct OccluderBounds {
+    template <typename T>
+    bool operator()(const T&) { return false; }
+
+    bool operator()(const DrawPaint&);
+    bool operator()(const DrawRect&);
+    bool operator()(const DrawRRect&);
+    bool operator()(const DrawImage&);
+    bool operator()(const DrawImageRect&);
+
+    SkRect fBounds;
+    bool   fEverything;
+    bool   fAntiAlias;
+};
+
+}  // namespace SkRecords
+
+// Merges runs of non-antialiased DrawRects with the same paint into one DrawRegion.
+void SkRecordMergeDrawRects(SkRecord*);
+
+// Merges runs of DrawImageRects of abutting pieces of the same image into one DrawImageRect.
+void SkRecordMergeDrawImageRects(SkRecord*);
+
+// How many commands each pass of SkRecordOptimize2() removed.
+struct SkRecordOptStats {
+    struct Pass {
+        const char* fName;
+        int         fOpsRemoved;
+    };
+
+    int             fOpsBefore = 0,
+                    fOpsAfter  = 0;
+    SkTDArray<Pass> fPasses;
+};
+
+// Experimental optimizers.  If stats is not null, fills it in.
+void SkRecordOptimize2(SkRecord*, SkRecordOptStats* stats = nullptr);
 
 #endif//SkRecordOpts_DEFINED
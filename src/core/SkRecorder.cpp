@@ -130,40 +130,40 @@ void SkRecorder::flushMiniRecorder() {
 }
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, paint);
+    APPEND(DrawPaint, fRecord->internPaint(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    APPEND(DrawPoints, paint, mode, SkToUInt(count), this->copy(pts, count));
+    APPEND(DrawPoints, fRecord->internPaint(paint), mode, SkToUInt(count), this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     TRY_MINIRECORDER(drawRect, rect, paint);
-    APPEND(DrawRect, paint, rect);
+    APPEND(DrawRect, fRecord->internPaint(paint), rect);
 }
 
 void SkRecorder::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
-    APPEND(DrawRegion, paint, region);
+    APPEND(DrawRegion, fRecord->internPaint(paint), region);
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, paint, oval);
+    APPEND(DrawOval, fRecord->internPaint(paint), oval);
 }
 
 void SkRecorder::onDrawArc(const SkRect& oval, SkScalar startAngle, SkScalar sweepAngle,
                            bool useCenter, const SkPaint& paint) {
-    APPEND(DrawArc, paint, oval, startAngle, sweepAngle, useCenter);
+    APPEND(DrawArc, fRecord->internPaint(paint), oval, startAngle, sweepAngle, useCenter);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, paint, rrect);
+    APPEND(DrawRRect, fRecord->internPaint(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, paint, outer, inner);
+    APPEND(DrawDRRect, fRecord->internPaint(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
@@ -181,7 +181,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
     TRY_MINIRECORDER(drawPath, path, paint);
-    APPEND(DrawPath, paint, path);
+    APPEND(DrawPath, fRecord->internPaint(paint), fRecord->internPath(path));
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -249,14 +249,18 @@ void SkRecorder::onDrawImageLattice(const SkImage* image, const Lattice& lattice
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           paint, this->copy((const char*)text, byteLength), byteLength, x, y);
+           fRecord->internPaint(paint),
+           this->copy((const char*)text, byteLength),
+           byteLength,
+           x,
+           y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const int points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -266,7 +270,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const int points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            SkToUInt(byteLength),
            constY,
@@ -276,7 +280,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            path,
@@ -286,7 +290,7 @@ void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkP
 void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[],
                                    const SkRect* cull, const SkPaint& paint) {
     APPEND(DrawTextRSXform,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(xform, paint.countText(text, byteLength)),
@@ -296,7 +300,7 @@ void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const Sk
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
     TRY_MINIRECORDER(drawTextBlob, blob, x, y, paint);
-    APPEND(DrawTextBlob, paint, sk_ref_sp(blob), x, y);
+    APPEND(DrawTextBlob, fRecord->internPaint(paint), sk_ref_sp(blob), x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
@@ -332,7 +336,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
                                 const SkPoint texs[], const SkColor colors[],
                                 SkXfermode* xmode,
                                 const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, paint,
+    APPEND(DrawVertices, fRecord->internPaint(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -345,7 +349,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    APPEND(DrawPatch, paint,
+    APPEND(DrawPatch, fRecord->internPaint(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : nullptr,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : nullptr,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : nullptr,
@@ -418,7 +422,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, ClipOp op, ClipEdgeStyle edge
 void SkRecorder::onClipPath(const SkPath& path, ClipOp op, ClipEdgeStyle edgeStyle) {
     INHERITED(onClipPath, path, op, edgeStyle);
     SkRecords::ClipOpAndAA opAA(op, kSoft_ClipEdgeStyle == edgeStyle);
-    APPEND(ClipPath, this->devBounds(), path, opAA);
+    APPEND(ClipPath, this->devBounds(), fRecord->internPath(path), opAA);
 }
 
 void SkRecorder::onClipRegion(const SkRegion& deviceRgn, ClipOp op) {
@@ -16,6 +16,8 @@
     std::atomic<bool> gSkUseAnalyticAA{false};
 #endif
 
+std::atomic<bool> gSkUseParallelScanConversion{false};
+
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
 }
@@ -10,6 +10,7 @@
 #define SkScan_DEFINED
 
 #include "SkFixed.h"
+#include "SkMatrix.h"
 #include "SkRect.h"
 #include <atomic>
 
@@ -23,7 +24,17 @@ class SkPath;
 */
 typedef SkIRect SkXRect;
 
+/** Where a device-space path came from: a source path, by generation ID, drawn through a
+    matrix.  Filling the same source through the same matrix always makes the same edges, so
+    fills that know their source may reuse edges cached by an earlier draw (see SkEdgeCache).
+*/
+struct SkDevPathSource {
+    uint32_t fGenID;
+    SkMatrix fMatrix;
+};
+
 extern std::atomic<bool> gSkUseAnalyticAA;
+extern std::atomic<bool> gSkUseParallelScanConversion;
 
 class AdditiveBlitter;
 
@@ -50,7 +61,24 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
-    static void AAAFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                         const SkDevPathSource*);
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                             const SkDevPathSource*);
+    static void AAAFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                            const SkDevPathSource* = nullptr);
+
+    /*
+     *  Draw only rows [top, bottom) of FillPath() / AntiFillPath(), with exactly the pixels the
+     *  full call would produce there.  Bands of the same path may be scan converted concurrently,
+     *  each with its own blitter.  Only paths for which CanFillPathInBands() is true may be banded.
+     */
+    static bool CanFillPathInBands(const SkPath&);
+    static void FillPathBand(const SkPath&, const SkRasterClip&, int top, int bottom, SkBlitter*,
+                             const SkDevPathSource* = nullptr);
+    static void AntiFillPathBand(const SkPath&, const SkRasterClip&, int top, int bottom,
+                                 SkBlitter*, const SkDevPathSource* = nullptr);
+
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -76,9 +104,13 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
+    static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
+                         int bandTop = SK_MinS32, int bandBottom = SK_MaxS32,
+                         const SkDevPathSource* = nullptr);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
-                             bool forceRLE = false);
+                             bool forceRLE = false,
+                             int bandTop = SK_MinS32, int bandBottom = SK_MaxS32,
+                             const SkDevPathSource* = nullptr);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -86,10 +118,11 @@ private:
     static void HairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter* blitter,
-                            bool forceRLE = false); // SkAAClip uses forceRLE
+                            bool forceRLE = false, // SkAAClip uses forceRLE
+                            const SkDevPathSource* = nullptr);
     static void aaa_fill_path(const SkPath& path, const SkIRect* clipRect, AdditiveBlitter*,
                    int start_y, int stop_y, const SkRegion& clipRgn, bool isUsingMask,
-                   bool forceRLE);
+                   bool forceRLE, const SkDevPathSource*);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
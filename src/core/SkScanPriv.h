@@ -27,10 +27,43 @@ private:
     const SkIRect*      fClipRect;
 };
 
+/**
+ *  Collects spans bound for a blitter and hands them over in blitSpans() batches, so scan
+ *  converters pay one virtual call per batch rather than one per span.  Anything else sent to
+ *  the blitter must wait for flush() to keep the blits in order.
+ */
+class SkSpanBatcher : SkNoncopyable {
+public:
+    explicit SkSpanBatcher(SkBlitter* blitter) : fBlitter(blitter) {}
+    ~SkSpanBatcher() { this->flush(); }
+
+    void add(int x, int y, int width, SkAlpha alpha = 0xFF) {
+        if (fCount == kMaxSpans) {
+            this->flush();
+        }
+        fSpans[fCount++] = { x, y, width, alpha };
+    }
+
+    void flush() {
+        if (fCount > 0) {
+            fBlitter->blitSpans(fSpans, fCount);
+            fCount = 0;
+        }
+    }
+
+private:
+    static const int kMaxSpans = 64;
+
+    SkBlitter*      fBlitter;
+    SkBlitter::Span fSpans[kMaxSpans];
+    int             fCount = 0;
+};
+
 // clipRect == null means path is entirely inside the clip
+// source, if not null, lets the edges be cached for the next fill of the same source
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
-                  const SkRegion& clipRgn);
+                  const SkRegion& clipRgn, const SkDevPathSource* source = nullptr);
 
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
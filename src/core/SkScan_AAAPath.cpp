@@ -10,6 +10,7 @@
 #include "SkEdge.h"
 #include "SkAnalyticEdge.h"
 #include "SkEdgeBuilder.h"
+#include "SkEdgeCache.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
@@ -98,6 +99,11 @@ public:
     virtual void blitAntiH(int x, int y, const SkAlpha alpha) = 0;
     virtual void blitAntiH(int x, int y, int width, const SkAlpha alpha) = 0;
 
+    // Blit a full-coverage span straight to the real blitter, rather than accumulating it.
+    virtual void blitRealH(int x, int y, int width) {
+        this->getRealBlitter()->blitH(x, y, width);
+    }
+
     void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
         SkDEBUGFAIL("Please call real blitter's blitAntiH instead.");
     }
@@ -286,8 +292,17 @@ public:
         }
     }
 
+    // Queue a full-coverage span for the real blitter.  Queued spans go out in blitSpans()
+    // batches, ahead of anything else sent to the real blitter (see getRealBlitter() and flush()).
+    // Only full coverage is batched: blitSpans() draws it exactly as blitH() would, but partial
+    // coverage may blend differently than blitV() and blitAntiH2().
+    void blitRealH(int x, int y, int width) override {
+        fRealSpans.add(x, y, width);
+    }
+
 private:
-    SkBlitter* fRealBlitter;
+    SkBlitter*    fRealBlitter;
+    SkSpanBatcher fRealSpans;
 
     /// Current y coordinate
     int         fCurrY;
@@ -339,6 +354,7 @@ private:
     }
 
     inline void flush() {
+        fRealSpans.flush();
         if (fCurrY >= fTop) {
             SkASSERT(fCurrentRun < fRunsToBuffer);
             for (int x = 0; fRuns.fRuns[x]; x += fRuns.fRuns[x]) {
@@ -364,7 +380,8 @@ private:
 };
 
 RunBasedAdditiveBlitter::RunBasedAdditiveBlitter(SkBlitter* realBlitter, const SkIRect& ir, const SkRegion& clip,
-                                 bool isInverse) {
+                                 bool isInverse)
+    : fRealSpans(realBlitter) {
     fRealBlitter = realBlitter;
 
     SkIRect sectBounds;
@@ -400,6 +417,7 @@ RunBasedAdditiveBlitter::~RunBasedAdditiveBlitter() {
 }
 
 SkBlitter* RunBasedAdditiveBlitter::getRealBlitter(bool forceRealBlitter) {
+    fRealSpans.flush();
     return fRealBlitter;
 }
 
@@ -595,7 +613,7 @@ static SK_ALWAYS_INLINE void blit_full_alpha(AdditiveBlitter* blitter, int y, in
         }
     } else {
         if (fullAlpha == 0xFF) {
-            blitter->getRealBlitter()->blitH(x, y, len);
+            blitter->blitRealH(x, y, len);
         } else {
             blitter->blitAntiH(x, y, len, fullAlpha);
         }
@@ -800,8 +818,11 @@ static bool operator<(const SkAnalyticEdge& a, const SkAnalyticEdge& b) {
     return valuea < valueb;
 }
 
-static SkAnalyticEdge* sort_edges(SkAnalyticEdge* list[], int count, SkAnalyticEdge** last) {
-    SkTQSort(list, list + count - 1);
+static SkAnalyticEdge* sort_edges(SkAnalyticEdge* list[], int count, SkAnalyticEdge** last,
+                                  bool alreadySorted) {
+    if (!alreadySorted) {
+        SkTQSort(list, list + count - 1);
+    }
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; i++) {
@@ -1130,7 +1151,8 @@ END_WALK:
 
 void SkScan::aaa_fill_path(const SkPath& path, const SkIRect* clipRect, AdditiveBlitter* blitter,
                    int start_y, int stop_y, const SkRegion& clipRgn, bool isUsingMask,
-                   bool forceRLE) { // forceRLE implies that SkAAClip is calling us
+                   bool forceRLE, // forceRLE implies that SkAAClip is calling us
+                   const SkDevPathSource* source) {
     SkASSERT(blitter);
 
     // we only implemented the convex shapes yet
@@ -1142,7 +1164,20 @@ void SkScan::aaa_fill_path(const SkPath& path, const SkIRect* clipRect, Additive
     const bool canCullToTheRight = !path.isConvex();
 
     SkASSERT(gSkUseAnalyticAA.load());
-    int count = builder.build(path, clipRect, 0, canCullToTheRight, true);
+    // Cached edges come back sorted, and we sort any we build for the cache before adding them.
+    int count = source ? SkEdgeCache::Find(*source, clipRect, 0, canCullToTheRight, true,
+                                           &builder)
+                       : -1;
+    bool sorted = count >= 0;
+    if (!sorted) {
+        count = builder.build(path, clipRect, 0, canCullToTheRight, true);
+        if (source && count > 0) {
+            SkAnalyticEdge** list = builder.analyticEdgeList();
+            SkTQSort(list, list + count - 1);
+            SkEdgeCache::Add(*source, clipRect, canCullToTheRight, list, count);
+            sorted = true;
+        }
+    }
     SkASSERT(count >= 0);
 
     SkAnalyticEdge** list = (SkAnalyticEdge**)builder.analyticEdgeList();
@@ -1171,7 +1206,7 @@ void SkScan::aaa_fill_path(const SkPath& path, const SkIRect* clipRect, Additive
 
     SkAnalyticEdge headEdge, tailEdge, *last;
     // this returns the first and last edge after they're sorted into a dlink list
-    SkAnalyticEdge* edge = sort_edges(list, count, &last);
+    SkAnalyticEdge* edge = sort_edges(list, count, &last, sorted);
 
     headEdge.fPrev = nullptr;
     headEdge.fNext = edge;
@@ -1213,13 +1248,13 @@ void SkScan::aaa_fill_path(const SkPath& path, const SkIRect* clipRect, Additive
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkScan::AAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter* blitter,
-                         bool forceRLE) {
+                         bool forceRLE, const SkDevPathSource* source) {
     if (origClip.isEmpty()) {
         return;
     }
     if (path.isInverseFillType() || !path.isConvex()) {
         // Fall back as we only implemented the algorithm for convex shapes yet.
-        SkScan::AntiFillPath(path, origClip, blitter, forceRLE);
+        SkScan::AntiFillPath(path, origClip, blitter, forceRLE, SK_MinS32, SK_MaxS32, source);
         return;
     }
 
@@ -1287,11 +1322,11 @@ void SkScan::AAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter
     if (MaskAdditiveBlitter::canHandleRect(ir) && !isInverse && !forceRLE) {
         MaskAdditiveBlitter additiveBlitter(blitter, ir, *clipRgn, isInverse);
         aaa_fill_path(path, clipRect, &additiveBlitter, ir.fTop, ir.fBottom, *clipRgn, true,
-                      forceRLE);
+                      forceRLE, source);
     } else {
         RunBasedAdditiveBlitter additiveBlitter(blitter, ir, *clipRgn, isInverse);
         aaa_fill_path(path, clipRect, &additiveBlitter, ir.fTop, ir.fBottom, *clipRgn, false,
-                      forceRLE);
+                      forceRLE, source);
     }
 
     if (isInverse) {
@@ -1302,19 +1337,20 @@ void SkScan::AAAFillPath(const SkPath& path, const SkRegion& origClip, SkBlitter
 }
 
 // This almost copies SkScan::AntiFillPath
-void SkScan::AAAFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+void SkScan::AAAFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter,
+                         const SkDevPathSource* source) {
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        AAAFillPath(path, clip.bwRgn(), blitter);
+        AAAFillPath(path, clip.bwRgn(), blitter, false, source);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        AAAFillPath(path, tmp, &aaBlitter, true);
+        AAAFillPath(path, tmp, &aaBlitter, true, source);
     }
 }
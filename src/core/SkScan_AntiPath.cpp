@@ -115,6 +115,13 @@ public:
     /// Blits a row of pixels, with location and width specified
     /// in supersampled coordinates.
     void blitH(int x, int y, int width) override;
+    /// Blits opaque spans from the edge walker, without a virtual call for each.
+    void blitSpans(const Span spans[], int count) override {
+        for (int i = 0; i < count; i++) {
+            SkASSERT(spans[i].fAlpha == 0xFF);
+            this->SuperBlitter::blitH(spans[i].fX, spans[i].fY, spans[i].fWidth);
+        }
+    }
     /// Blits a rectangle of pixels, with location and size specified
     /// in supersampled coordinates.
     void blitRect(int x, int y, int width, int height) override;
@@ -399,6 +406,13 @@ public:
     }
 
     void blitH(int x, int y, int width) override;
+    /// Blits opaque spans from the edge walker, without a virtual call for each.
+    void blitSpans(const Span spans[], int count) override {
+        for (int i = 0; i < count; i++) {
+            SkASSERT(spans[i].fAlpha == 0xFF);
+            this->MaskSuperBlitter::blitH(spans[i].fX, spans[i].fY, spans[i].fWidth);
+        }
+    }
 
     static bool CanHandleRect(const SkIRect& bounds) {
 #ifdef FORCE_RLE
@@ -622,7 +636,10 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, int bandTop, int bandBottom,
+                          const SkDevPathSource* source) {
+    SkASSERT((SK_MinS32 == bandTop && SK_MaxS32 == bandBottom) || CanFillPathInBands(path));
+
     if (origClip.isEmpty()) {
         return;
     }
@@ -658,7 +675,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
        }
     }
     if (rect_overflows_short_shift(clippedIR, SHIFT)) {
-        SkScan::FillPath(path, origClip, blitter);
+        SkScan::FillPath(path, origClip, blitter, bandTop, bandBottom, source);
         return;
     }
 
@@ -710,15 +727,25 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
 
+    // A band walks fewer rows, but picks its super blitter and clips its edges
+    // exactly as the whole path would.
+    SkIRect bandIR = ir;
+    bandIR.fTop = SkMax32(ir.fTop, bandTop);
+    bandIR.fBottom = SkMin32(ir.fBottom, bandBottom);
+
     // MaskSuperBlitter can't handle drawing outside of ir, so we can't use it
     // if we're an inverse filltype
-    if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
-        MaskSuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
+    if (bandIR.isEmpty()) {
+        // nothing of the path in this band
+    } else if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
+        MaskSuperBlitter    superBlit(blitter, bandIR, *clipRgn, isInverse);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
-        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
+        sk_fill_path(path, superClipRect, &superBlit, bandIR.fTop, bandIR.fBottom, SHIFT,
+                     *clipRgn, source);
     } else {
-        SuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
-        sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
+        SuperBlitter    superBlit(blitter, bandIR, *clipRgn, isInverse);
+        sk_fill_path(path, superClipRect, &superBlit, bandIR.fTop, bandIR.fBottom, SHIFT,
+                     *clipRgn, source);
     }
 
     if (isInverse) {
@@ -732,41 +759,62 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
 void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip,
                           SkBlitter* blitter) {
+    FillPath(path, clip, blitter, nullptr);
+}
+
+void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter,
+                      const SkDevPathSource* source) {
+    FillPathBand(path, clip, SK_MinS32, SK_MaxS32, blitter, source);
+}
+
+void SkScan::FillPathBand(const SkPath& path, const SkRasterClip& clip, int top, int bottom,
+                          SkBlitter* blitter, const SkDevPathSource* source) {
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        FillPath(path, clip.bwRgn(), blitter);
+        FillPath(path, clip.bwRgn(), blitter, top, bottom, source);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::FillPath(path, tmp, &aaBlitter);
+        SkScan::FillPath(path, tmp, &aaBlitter, top, bottom, source);
     }
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
                           SkBlitter* blitter) {
+    AntiFillPath(path, clip, blitter, nullptr);
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter,
+                          const SkDevPathSource* source) {
     if (gSkUseAnalyticAA.load()) {
-        SkScan::AAAFillPath(path, clip, blitter);
+        SkScan::AAAFillPath(path, clip, blitter, source);
         return;
     }
 
+    AntiFillPathBand(path, clip, SK_MinS32, SK_MaxS32, blitter, source);
+}
+
+// Bandable paths are never convex, and so would fall back from AAA to supersampling anyway.
+void SkScan::AntiFillPathBand(const SkPath& path, const SkRasterClip& clip, int top, int bottom,
+                              SkBlitter* blitter, const SkDevPathSource* source) {
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, top, bottom, source);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        SkScan::AntiFillPath(path, tmp, &aaBlitter, true, top, bottom, source);
     }
 }
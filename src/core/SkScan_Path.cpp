@@ -9,6 +9,7 @@
 #include "SkBlitter.h"
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
+#include "SkEdgeCache.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
@@ -136,6 +137,7 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
     int curr_y = start_y;
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     int windingMask = (fillType & 1) ? 1 : -1;
+    SkSpanBatcher spans(blitter);
 
     for (;;) {
         int     w = 0;
@@ -147,6 +149,7 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
         validate_edges_for_y(currE, curr_y);
 
         if (proc) {
+            spans.flush();
             proc(blitter, curr_y, PREPOST_START);    // pre-proc
         }
 
@@ -160,7 +163,7 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
                 int width = x - left;
                 SkASSERT(width >= 0);
                 if (width)
-                    blitter->blitH(left, curr_y, width);
+                    spans.add(left, curr_y, width);
                 in_interval = false;
             } else if (!in_interval) {
                 left = x;
@@ -204,11 +207,12 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
         if (in_interval) {
             int width = rightClip - left;
             if (width > 0) {
-                blitter->blitH(left, curr_y, width);
+                spans.add(left, curr_y, width);
             }
         }
 
         if (proc) {
+            spans.flush();
             proc(blitter, curr_y, PREPOST_END);    // post-proc
         }
 
@@ -259,6 +263,7 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
     int local_top = SkMax32(leftE->fFirstY, riteE->fFirstY);
 #endif
     SkASSERT(local_top >= start_y);
+    SkSpanBatcher spans(blitter);
 
     for (;;) {
         SkASSERT(leftE->fFirstY <= stop_y);
@@ -284,6 +289,7 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
             int R = SkFixedRoundToInt(rite);
             if (L < R) {
                 count += 1;
+                spans.flush();
                 blitter->blitRect(L, local_top, R - L, count);
             }
             local_top = local_bot + 1;
@@ -292,7 +298,7 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
                 int L = SkFixedRoundToInt(left);
                 int R = SkFixedRoundToInt(rite);
                 if (L < R) {
-                    blitter->blitH(L, local_top, R - L);
+                    spans.add(L, local_top, R - L);
                 }
                 left += dLeft;
                 rite += dRite;
@@ -408,8 +414,10 @@ static bool operator<(const SkEdge& a, const SkEdge& b) {
     return valuea < valueb;
 }
 
-static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
-    SkTQSort(list, list + count - 1);
+static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last, bool alreadySorted) {
+    if (!alreadySorted) {
+        SkTQSort(list, list + count - 1);
+    }
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; i++) {
@@ -421,13 +429,59 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
     return list[0];
 }
 
+// Step edge down to row y exactly as walk_edges() would have, one row at a time.
+// Returns false if the edge ends above y.
+static bool advance_edge_to(SkEdge* edge, int y) {
+    while (edge->fLastY < y) {
+        if (edge->fCurveCount < 0) {
+            if (!((SkCubicEdge*)edge)->updateCubic()) {
+                return false;
+            }
+        } else if (edge->fCurveCount > 0) {
+            if (!((SkQuadraticEdge*)edge)->updateQuadratic()) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (edge->fFirstY < y) {
+        edge->fX += (SkFixed)((int64_t)edge->fDX * (y - edge->fFirstY));
+        edge->fFirstY = y;
+    }
+    return true;
+}
+
+// When we're only drawing a band of the path, drop the edges outside [start_y, stop_y)
+// and bring the ones crossing start_y down to it. Returns whether any were brought down.
+static bool trim_edges_to_band(SkEdge* list[], int* count, int start_y, int stop_y) {
+    bool advanced = false;
+    int kept = 0;
+    for (int i = 0; i < *count; i++) {
+        SkEdge* edge = list[i];
+        if (edge->fFirstY >= stop_y) {
+            continue;
+        }
+        if (edge->fFirstY < start_y) {
+            if (!advance_edge_to(edge, start_y)) {
+                continue;
+            }
+            advanced = true;
+        }
+        list[kept++] = edge;
+    }
+    *count = kept;
+    return advanced;
+}
+
 // clipRect may be null, even though we always have a clip. This indicates that
 // the path is contained in the clip, and so we can ignore it during the blit
 //
 // clipRect (if no null) has already been shifted up
 //
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitter,
-                  int start_y, int stop_y, int shiftEdgesUp, const SkRegion& clipRgn) {
+                  int start_y, int stop_y, int shiftEdgesUp, const SkRegion& clipRgn,
+                  const SkDevPathSource* source) {
     SkASSERT(blitter);
 
     SkEdgeBuilder   builder;
@@ -435,11 +489,41 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
     // If we're convex, then we need both edges, even the right edge is past the clip
     const bool canCullToTheRight = !path.isConvex();
 
-    int count = builder.build(path, clipRect, shiftEdgesUp, canCullToTheRight);
+    // Cached edges come back sorted, and we sort any we build for the cache before adding them.
+    int count = source ? SkEdgeCache::Find(*source, clipRect, shiftEdgesUp, canCullToTheRight,
+                                           false, &builder)
+                       : -1;
+    bool sorted = count >= 0;
+    if (!sorted) {
+        count = builder.build(path, clipRect, shiftEdgesUp, canCullToTheRight);
+        if (source && count > 0) {
+            SkTQSort(builder.edgeList(), builder.edgeList() + count - 1);
+            SkEdgeCache::Add(*source, clipRect, shiftEdgesUp, canCullToTheRight,
+                             builder.edgeList(), count);
+            sorted = true;
+        }
+    }
     SkASSERT(count >= 0);
 
     SkEdge**    list = builder.edgeList();
 
+    int top = SkLeftShift(start_y, shiftEdgesUp);
+    int bottom = SkLeftShift(stop_y, shiftEdgesUp);
+    if (clipRect && top < clipRect->fTop) {
+        top = clipRect->fTop;
+    }
+    if (clipRect && bottom > clipRect->fBottom) {
+        bottom = clipRect->fBottom;
+    }
+    if (trim_edges_to_band(list, &count, top, bottom) && sorted) {
+        // The edges we brought down to the top moved in x, so re-sort those starting there.
+        int n = 0;
+        while (n < count && list[n]->fFirstY == top) {
+            n++;
+        }
+        SkTQSort(list, list + n - 1);
+    }
+
     if (0 == count) {
         if (path.isInverseFillType()) {
             /*
@@ -467,7 +551,7 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
 
     SkEdge headEdge, tailEdge, *last;
     // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
+    SkEdge* edge = sort_edges(list, count, &last, sorted);
 
     headEdge.fPrev = nullptr;
     headEdge.fNext = edge;
@@ -482,14 +566,8 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
 
     // now edge is the head of the sorted linklist
 
-    start_y = SkLeftShift(start_y, shiftEdgesUp);
-    stop_y = SkLeftShift(stop_y, shiftEdgesUp);
-    if (clipRect && start_y < clipRect->fTop) {
-        start_y = clipRect->fTop;
-    }
-    if (clipRect && stop_y > clipRect->fBottom) {
-        stop_y = clipRect->fBottom;
-    }
+    start_y = top;
+    stop_y = bottom;
 
     InverseBlitter  ib;
     PrePostProc     proc = nullptr;
@@ -627,8 +705,17 @@ static void round_asymmetric_to_int(const SkRect& src, SkIRect* dst) {
              SkDScalarRoundToInt(src.fRight), SkDScalarRoundToInt(src.fBottom));
 }
 
+bool SkScan::CanFillPathInBands(const SkPath& path) {
+    // Inverse fills blit the whole clip around the path, and the convex walker can start
+    // its edges a row apart, so neither can be resumed at an arbitrary row.
+    return !path.isInverseFillType() && !path.isConvex();
+}
+
 void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
-                      SkBlitter* blitter) {
+                      SkBlitter* blitter, int bandTop, int bandBottom,
+                      const SkDevPathSource* source) {
+    SkASSERT((SK_MinS32 == bandTop && SK_MaxS32 == bandBottom) || CanFillPathInBands(path));
+
     if (origClip.isEmpty()) {
         return;
     }
@@ -667,8 +754,13 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
         if (path.isInverseFillType()) {
             sk_blit_above(blitter, ir, *clipPtr);
         }
-        sk_fill_path(path, clipper.getClipRect(), blitter, ir.fTop, ir.fBottom,
-                     0, *clipPtr);
+        // The clipper and edges stay those of the whole path; only the rows walked shrink.
+        int top = SkMax32(ir.fTop, bandTop);
+        int bottom = SkMin32(ir.fBottom, bandBottom);
+        if (top < bottom) {
+            sk_fill_path(path, clipper.getClipRect(), blitter, top, bottom, 0, *clipPtr,
+                         source);
+        }
         if (path.isInverseFillType()) {
             sk_blit_below(blitter, ir, *clipPtr);
         }
@@ -719,7 +811,7 @@ static void sk_fill_triangle(const SkPoint pts[], const SkIRect* clipRect,
     SkEdge headEdge, tailEdge, *last;
 
     // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
+    SkEdge* edge = sort_edges(list, count, &last, false);
 
     headEdge.fPrev = nullptr;
     headEdge.fNext = edge;
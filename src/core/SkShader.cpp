@@ -66,15 +66,28 @@ void SkShader::flatten(SkWriteBuffer& buffer) const {
 }
 
 bool SkShader::computeTotalInverse(const ContextRec& rec, SkMatrix* totalInverse) const {
-    SkMatrix total;
-    total.setConcat(*rec.fMatrix, fLocalMatrix);
+    return this->computeTotalInverse(*rec.fMatrix, rec.fLocalMatrix, totalInverse);
+}
 
-    const SkMatrix* m = &total;
-    if (rec.fLocalMatrix) {
-        total.setConcat(*m, *rec.fLocalMatrix);
-        m = &total;
+bool SkShader::computeTotalInverse(const SkMatrix& ctm, const SkMatrix* localM,
+                                   SkMatrix* totalInverse) const {
+    SkMatrix total;
+    total.setConcat(ctm, fLocalMatrix);
+    if (localM) {
+        total.preConcat(*localM);
     }
-    return m->invert(totalInverse);
+    return total.invert(totalInverse);
+}
+
+bool SkShader::appendStages(SkRasterPipeline* pipeline, SkColorSpace* dstColorSpace,
+                            SkArenaAlloc* alloc, const SkMatrix& ctm, const SkPaint& paint,
+                            const SkMatrix* localM) const {
+    return this->onAppendStages(pipeline, dstColorSpace, alloc, ctm, paint, localM);
+}
+
+bool SkShader::onAppendStages(SkRasterPipeline*, SkColorSpace*, SkArenaAlloc*,
+                              const SkMatrix&, const SkPaint&, const SkMatrix*) const {
+    return false;
 }
 
 bool SkShader::asLuminanceColor(SkColor* colorPtr) const {
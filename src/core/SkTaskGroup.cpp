@@ -12,8 +12,11 @@
 #include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTaskGroup.h"
+#include "SkThreadID.h"
 #include "SkThreadUtils.h"
 
+#include <atomic>
+
 #if defined(SK_BUILD_FOR_WIN32)
     static void query_num_cores(int* cores) {
         SYSTEM_INFO sysinfo;
@@ -38,6 +41,123 @@ static int num_cores() {
 
 namespace {
 
+struct Work {
+    std::function<void(void)> fn; // A function to call
+    SkAtomic<int32_t>* pending;   // then decrement pending afterwards.
+};
+
+// A Chase-Lev work-stealing deque of Work*, following
+//     'Correct and Efficient Work-Stealing for Weak Memory Models' (Lê et al., PPoPP 2013).
+// Only the owning worker thread may push() and pop(), which work LIFO at the bottom.
+// Any thread may steal(), which takes the oldest Work from the top.
+class WorkDeque : SkNoncopyable {
+public:
+    enum class Steal { kEmpty, kAbort, kSuccess };
+
+    WorkDeque() : fTop(0), fBottom(0), fRing(new Ring(kInitialLgCapacity)) {}
+
+    ~WorkDeque() {
+        SkASSERT(fTop.load() == fBottom.load());
+        delete fRing.load();
+        fRetired.deleteAll();
+    }
+
+    // Owner only.
+    void push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed);
+        int64_t t = fTop.load(std::memory_order_acquire);
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        if (b - t > ring->mask()) {
+            ring = this->grow(ring, t, b);
+        }
+        ring->put(b, work);
+        fBottom.store(b + 1, std::memory_order_release);  // Pairs with acquire in steal().
+    }
+
+    // Owner only.  Returns nullptr when empty.
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        fBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty.  Put fBottom back where it was.
+            fBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Work* work = ring->get(b);
+        if (t == b) {
+            // This is the last Work in the deque.  Race any thieves for it.
+            if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                work = nullptr;  // A thief won.
+            }
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    // Any thread.  kAbort means we lost a race with another thread and the deque may not be empty.
+    Steal steal(Work** work) {
+        int64_t t = fTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = fBottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return Steal::kEmpty;
+        }
+        // Technically this should be memory_order_consume, but that's promoted to acquire anyway.
+        Ring* ring = fRing.load(std::memory_order_acquire);
+        Work* stolen = ring->get(t);
+        if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+            return Steal::kAbort;
+        }
+        *work = stolen;
+        return Steal::kSuccess;
+    }
+
+private:
+    static const int kInitialLgCapacity = 8;
+
+    // A power-of-two sized circular buffer indexed by the ever-increasing fTop and fBottom.
+    class Ring : SkNoncopyable {
+    public:
+        explicit Ring(int lgCapacity)
+            : fMask((1 << lgCapacity) - 1)
+            , fLgCapacity(lgCapacity)
+            , fSlots(1 << lgCapacity) {}
+
+        int64_t mask()       const { return fMask; }
+        int     lgCapacity() const { return fLgCapacity; }
+
+        Work* get(int64_t i) const { return fSlots[i & fMask].load(std::memory_order_relaxed); }
+        void  put(int64_t i, Work* w) { fSlots[i & fMask].store(w, std::memory_order_relaxed); }
+
+    private:
+        int64_t                          fMask;
+        int                              fLgCapacity;
+        SkAutoTArray<std::atomic<Work*>> fSlots;
+    };
+
+    Ring* grow(Ring* ring, int64_t t, int64_t b) {
+        Ring* bigger = new Ring(ring->lgCapacity() + 1);
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, ring->get(i));
+        }
+        // Thieves may still be reading from the old ring, so we keep it around until we die.
+        fRetired.push(ring);
+        fRing.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t> fTop;
+    std::atomic<int64_t> fBottom;
+    std::atomic<Ring*>   fRing;
+    SkTDArray<Ring*>     fRetired;  // Owner only.
+};
+
 class ThreadPool : SkNoncopyable {
 public:
     static void Add(std::function<void(void)> fn, SkAtomic<int32_t>* pending) {
@@ -60,27 +180,20 @@ public:
             SkASSERT(pending->load(sk_memory_order_relaxed) == 0);
             return;
         }
-        // Acquire pairs with decrement release here or in Loop.
+        // If we're one of the pool's own threads (a task waiting on nested tasks),
+        // we'll look in our own deque first, running the nested tasks inline.
+        Worker* self = gGlobal->currentWorker();
+
+        // Acquire pairs with decrement release in Run().
         while (pending->load(sk_memory_order_acquire) > 0) {
             // Lend a hand until our SkTaskGroup of interest is done.
-            Work work;
-            {
-                // We're stealing work opportunistically,
-                // so we never call fWorkAvailable.wait(), which could sleep us if there's no work.
-                // This means fWorkAvailable is only an upper bound on fWork.count().
-                AutoLock lock(&gGlobal->fWorkLock);
-                if (gGlobal->fWork.empty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                work = gGlobal->fWork.back();
-                gGlobal->fWork.pop_back();
-            }
             // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
-            work.fn();
-            work.pending->fetch_add(-1, sk_memory_order_release);  // Pairs with load above.
+            if (Work* work = gGlobal->find(self)) {
+                Run(work);
+            }
+            // Otherwise someone has picked up all the work (including ours).  How nice of them!
+            // (They may still be working on it, so we can't assert *pending == 0 here.)
         }
     }
 
@@ -92,98 +205,196 @@ private:
         SkSpinlock* fLock;
     };
 
-    struct Work {
-        std::function<void(void)> fn; // A function to call
-        SkAtomic<int32_t>* pending;   // then decrement pending afterwards.
+    struct Worker {
+        ThreadPool*             pool;
+        int                     index;
+        std::atomic<SkThreadID> threadID;  // Set by the worker thread itself once it's running.
+        WorkDeque               deque;
+        SkThread*               thread;
     };
 
-    explicit ThreadPool(int threads) {
+    explicit ThreadPool(int threads) : fShutdown(false) {
         if (threads == -1) {
             threads = num_cores();
         }
         for (int i = 0; i < threads; i++) {
-            fThreads.push(new SkThread(&ThreadPool::Loop, this));
-            fThreads.top()->start();
+            Worker* worker = new Worker;
+            worker->pool   = this;
+            worker->index  = i;
+            worker->threadID.store(kIllegalThreadID, std::memory_order_relaxed);
+            worker->thread = new SkThread(&ThreadPool::Loop, worker);
+            fWorkers.push(worker);
+        }
+        // Only start the threads once fWorkers is complete, as they all read it to steal.
+        for (int i = 0; i < fWorkers.count(); i++) {
+            fWorkers[i]->thread->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.empty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(fInjected.empty());  // All SkTaskGroups should be destroyed by now.
+
+        // Tell each thread to quit once it runs out of work, and wake any sleepers.
+        fShutdown.store(true, std::memory_order_release);
+        fWorkAvailable.signal(fWorkers.count());
 
-        // Send a poison pill to each thread.
-        SkAtomic<int> dummy(0);
-        for (int i = 0; i < fThreads.count(); i++) {
-            this->add(nullptr, &dummy);
+        // Wait for them all to notice and die.
+        for (int i = 0; i < fWorkers.count(); i++) {
+            fWorkers[i]->thread->join();
         }
-        // Wait for them all to swallow the pill and die.
-        for (int i = 0; i < fThreads.count(); i++) {
-            fThreads[i]->join();
+        SkASSERT(fInjected.empty());  // Can't hurt to double check.
+        for (int i = 0; i < fWorkers.count(); i++) {
+            delete fWorkers[i]->thread;
+        }
+        fWorkers.deleteAll();
+    }
+
+    // Returns the Worker for the calling thread, or nullptr if it's not one of ours.
+    Worker* currentWorker() const {
+        SkThreadID id = SkGetThreadID();
+        for (int i = 0; i < fWorkers.count(); i++) {
+            if (fWorkers[i]->threadID.load(std::memory_order_relaxed) == id) {
+                return fWorkers[i];
+            }
         }
-        SkASSERT(fWork.empty());  // Can't hurt to double check.
-        fThreads.deleteAll();
+        return nullptr;
+    }
+
+    static void Run(Work* work) {
+        work->fn();
+        work->pending->fetch_add(-1, sk_memory_order_release);  // Pairs with load in Wait().
+        delete work;
     }
 
     void add(std::function<void(void)> fn, SkAtomic<int32_t>* pending) {
-        Work work = { fn, pending };
+        Work* work = new Work{ fn, pending };
         pending->fetch_add(+1, sk_memory_order_relaxed);  // No barrier needed.
-        {
-            AutoLock lock(&fWorkLock);
-            fWork.push_back(work);
+        if (Worker* self = this->currentWorker()) {
+            // Nested tasks go on our own deque, where we'll find them first and others can steal.
+            self->deque.push(work);
+        } else {
+            AutoLock lock(&fInjectedLock);
+            fInjected.push_back(work);
         }
         fWorkAvailable.signal(1);
     }
 
     void batch(int N, std::function<void(int)> fn, SkAtomic<int32_t>* pending) {
+        if (N <= 0) {
+            return;
+        }
         pending->fetch_add(+N, sk_memory_order_relaxed);  // No barrier needed.
-        {
-            AutoLock lock(&fWorkLock);
+        if (Worker* self = this->currentWorker()) {
+            for (int i = 0; i < N; i++) {
+                self->deque.push(new Work{ [i, fn]() { fn(i); }, pending });
+            }
+        } else {
+            AutoLock lock(&fInjectedLock);
             for (int i = 0; i < N; i++) {
-                Work work = { [i, fn]() { fn(i); }, pending };
-                fWork.push_back(work);
+                fInjected.push_back(new Work{ [i, fn]() { fn(i); }, pending });
             }
         }
-        fWorkAvailable.signal(N);
+        // Any thread that wakes will keep looking for work until there's none left,
+        // so there's no point waking more threads than we have.
+        fWorkAvailable.signal(SkTMin(N, fWorkers.count()));
     }
 
-    static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
-        Work work;
-        while (true) {
-            // Sleep until there's work available, and claim one unit of Work as we wake.
-            pool->fWorkAvailable.wait();
-            {
-                AutoLock lock(&pool->fWorkLock);
-                if (pool->fWork.empty()) {
-                    // Someone in Wait() stole our work (fWorkAvailable is an upper bound).
-                    // Well, that's fine, back to sleep for us.
+    // Take one Work from fInjected.  When a Worker does this, it also moves a fair share of
+    // what's left over onto its own deque so that the rest of the pool can steal it from there
+    // instead of all contending for fInjectedLock.
+    Work* takeInjected(Worker* self) {
+        SkTDArray<Work*> share;
+        Work* work;
+        {
+            AutoLock lock(&fInjectedLock);
+            if (fInjected.empty()) {
+                return nullptr;
+            }
+            work = fInjected.back();
+            fInjected.pop_back();
+            if (self) {
+                int n = SkTMin(fInjected.count() / fWorkers.count(), kMaxInjectedShare);
+                for (int i = 0; i < n; i++) {
+                    share.push(fInjected.back());
+                    fInjected.pop_back();
+                }
+            }
+        }
+        // Push in reverse so that we pop() them in the same order they'd have left fInjected.
+        for (int i = share.count(); i --> 0;) {
+            self->deque.push(share[i]);
+        }
+        return work;
+    }
+
+    // Find one Work to run: first our own deque (if we're a Worker), then work added from
+    // outside the pool, then other Workers' deques.  Returns nullptr if there's nothing to do.
+    Work* find(Worker* self) {
+        if (self) {
+            if (Work* work = self->deque.pop()) {
+                return work;
+            }
+        }
+        if (Work* work = this->takeInjected(self)) {
+            return work;
+        }
+        const int n = fWorkers.count();
+        const int start = self ? self->index + 1 : 0;
+        bool aborted;
+        do {
+            aborted = false;
+            for (int i = 0; i < n; i++) {
+                Worker* victim = fWorkers[(start + i) % n];
+                if (victim == self) {
                     continue;
                 }
-                work = pool->fWork.back();
-                pool->fWork.pop_back();
+                Work* work;
+                switch (victim->deque.steal(&work)) {
+                    case WorkDeque::Steal::kSuccess: return work;
+                    case WorkDeque::Steal::kAbort:   aborted = true; break;
+                    case WorkDeque::Steal::kEmpty:   break;
+                }
             }
-            if (!work.fn) {
-                return;  // Poison pill.  Time... to die.
+            // If we lost any race we can't be sure that deque is empty, so look again.
+        } while (aborted);
+        return nullptr;
+    }
+
+    static void Loop(void* arg) {
+        Worker* self = (Worker*)arg;
+        ThreadPool* pool = self->pool;
+        self->threadID.store(SkGetThreadID(), std::memory_order_relaxed);
+        while (true) {
+            if (Work* work = pool->find(self)) {
+                Run(work);
+                continue;
             }
-            work.fn();
-            work.pending->fetch_add(-1, sk_memory_order_release);  // Pairs with load in Wait().
+            if (pool->fShutdown.load(std::memory_order_acquire)) {
+                return;  // Time... to die.
+            }
+            // Sleep until there's more work available.
+            pool->fWorkAvailable.wait();
         }
     }
 
-    // fWorkLock must be held when reading or modifying fWork.
-    SkSpinlock      fWorkLock;
-    SkTArray<Work>  fWork;
+    // Upper bound on how many Work a Worker will move from fInjected onto its own deque at once.
+    static const int kMaxInjectedShare = 64;
 
-    // A thread-safe upper bound for fWork.count().
+    // Work added by threads outside the pool.  fInjectedLock must be held to touch fInjected.
+    SkSpinlock      fInjectedLock;
+    SkTArray<Work*> fInjected;
+
+    // A thread-safe upper bound for the number of Work waiting to be picked up.
     //
-    // We'd have it be an exact count but for the loop in Wait():
-    // we never want that to block, so it can't call fWorkAvailable.wait(),
-    // and that's the only way to decrement fWorkAvailable.
-    // So fWorkAvailable may overcount actual the work available.
-    // We make do, but this means some worker threads may wake spuriously.
+    // Work taken by threads in Wait() never decrements fWorkAvailable (that could block),
+    // and Workers keep running until they find no Work anywhere before sleeping again,
+    // so fWorkAvailable may overcount the work available and some threads may wake spuriously.
     SkSemaphore fWorkAvailable;
 
+    std::atomic<bool> fShutdown;
+
     // These are only changed in a single-threaded context.
-    SkTDArray<SkThread*> fThreads;
+    SkTDArray<Worker*> fWorkers;
     static ThreadPool* gGlobal;
 
     friend struct SkTaskGroup::Enabler;
@@ -0,0 +1,350 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkData.h"
+#include "SkDraw.h"
+#include "SkPath.h"
+#include "SkPixmap.h"
+#include "SkRRect.h"
+#include "SkSpecialImage.h"
+#include "SkTaskGroup.h"
+#include "SkXfermode.h"
+
+// An SkBitmapDevice that draws right away, with its drawing entry points made public so we can
+// replay our recorded draws through exactly the same code SkBitmapDevice would have used.
+// It never touches its own bitmap when drawing, only the pixels of the SkDraw it's handed,
+// so one can be safely shared by all the threads rasterizing tiles.
+class SkThreadedBMPDevice::ImmediateDevice final : public SkBitmapDevice {
+public:
+    ImmediateDevice(const SkBitmap& bitmap, const SkSurfaceProps& props)
+        : SkBitmapDevice(bitmap, props) {}
+
+    using SkBitmapDevice::drawPaint;
+    using SkBitmapDevice::drawPoints;
+    using SkBitmapDevice::drawRect;
+    using SkBitmapDevice::drawRRect;
+    using SkBitmapDevice::drawPath;
+    using SkBitmapDevice::drawBitmap;
+    using SkBitmapDevice::drawSprite;
+    using SkBitmapDevice::drawBitmapRect;
+    using SkBitmapDevice::drawText;
+    using SkBitmapDevice::drawPosText;
+    using SkBitmapDevice::drawVertices;
+};
+
+// Draws are deferred, so we must not let the caller change a mutable bitmap out from under us.
+static SkBitmap snapshot(const SkBitmap& bitmap) {
+    if (bitmap.isImmutable()) {
+        return bitmap;
+    }
+    SkBitmap copy;
+    if (!bitmap.copyTo(&copy, bitmap.colorType())) {
+        return SkBitmap();
+    }
+    copy.setImmutable();
+    return copy;
+}
+
+static sk_sp<SkData> copy_or_null(const void* data, size_t bytes) {
+    return data ? SkData::MakeWithCopy(data, bytes) : nullptr;
+}
+
+template <typename T>
+static const T* data_or_null(const sk_sp<SkData>& data) {
+    return data ? static_cast<const T*>(data->data()) : nullptr;
+}
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
+                                         const SkSurfaceProps& surfaceProps,
+                                         int tileSize)
+    : INHERITED(bitmap, surfaceProps)
+    , fTileSize(tileSize)
+    , fTileCols((bitmap.width()  + tileSize - 1) / tileSize)
+    , fTileRows((bitmap.height() + tileSize - 1) / tileSize)
+{
+    SkASSERT(tileSize > 0);
+    fTileElements.reset(this->tileCount());
+}
+
+SkThreadedBMPDevice::~SkThreadedBMPDevice() {
+    this->flush();
+}
+
+SkIRect SkThreadedBMPDevice::tileBounds(int tile) const {
+    int x = (tile % fTileCols) * fTileSize,
+        y = (tile / fTileCols) * fTileSize;
+    SkIRect bounds = SkIRect::MakeXYWH(x, y, fTileSize, fTileSize);
+    SkAssertResult(bounds.intersect(SkIRect::MakeWH(this->width(), this->height())));
+    return bounds;
+}
+
+SkIRect SkThreadedBMPDevice::DrawBounds(const SkDraw& draw, const SkRect& localBounds,
+                                        const SkPaint& paint) {
+    const SkIRect& clipBounds = draw.fRC->getBounds();
+    if (!paint.canComputeFastBounds()) {
+        return clipBounds;
+    }
+    SkRect storage, devBounds;
+    draw.fMatrix->mapRect(&devBounds, paint.computeFastBounds(localBounds, &storage));
+    // Outset a pixel for anti-aliasing and hairlines.
+    SkIRect bounds = devBounds.makeOutset(1, 1).roundOut();
+    if (!bounds.intersect(clipBounds)) {
+        return SkIRect::MakeEmpty();
+    }
+    return bounds;
+}
+
+void SkThreadedBMPDevice::recordDraw(const SkDraw& draw, const SkIRect& bounds, DrawFn&& fn) {
+    if (bounds.isEmpty() || draw.fRC->isEmpty()) {
+        return;
+    }
+    if (fClips.empty() || fClips.back() != *draw.fRC) {
+        fClips.push_back(*draw.fRC);
+    }
+    const int index = fElements.count();
+    fElements.push_back(DrawElement{ *draw.fMatrix, fClips.count() - 1, std::move(fn) });
+
+    SkIRect tiles = bounds;
+    if (!tiles.intersect(SkIRect::MakeWH(this->width(), this->height()))) {
+        return;
+    }
+    for (int y = tiles.fTop / fTileSize; y <= (tiles.fBottom - 1) / fTileSize; y++) {
+        for (int x = tiles.fLeft / fTileSize; x <= (tiles.fRight - 1) / fTileSize; x++) {
+            fTileElements[y * fTileCols + x].push(index);
+        }
+    }
+}
+
+void SkThreadedBMPDevice::drawTile(ImmediateDevice* device, const SkPixmap& dst, int tile) const {
+    // Intersecting the clip with the tile would change how anti-aliased edges crossing the
+    // tile's sides are scan converted, so we keep the recorded clip and only limit the writes.
+    const SkIRect tileBounds = this->tileBounds(tile);
+
+    for (int index : fTileElements[tile]) {
+        const DrawElement& element = fElements[index];
+
+        SkDraw draw;
+        draw.fDst     = dst;
+        draw.fMatrix  = &element.fMatrix;
+        draw.fRC      = &fClips[element.fClipIndex];
+        draw.fDevice  = device;
+        draw.fDstClip = &tileBounds;
+        element.fDraw(device, draw);
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fElements.empty()) {
+        return;
+    }
+
+    SkPixmap dst;
+    if (INHERITED::onPeekPixels(&dst)) {
+        SkBitmap bitmap;
+        bitmap.installPixels(dst);
+        ImmediateDevice device(bitmap, this->surfaceProps());
+
+        SkTaskGroup().batch(this->tileCount(), [&](int tile) {
+            this->drawTile(&device, dst, tile);
+        });
+    }
+
+    fElements.reset();
+    fClips.reset();
+    for (int i = 0; i < fTileElements.count(); i++) {
+        fTileElements[i].rewind();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkDraw& draw, const SkPaint& paint) {
+    this->recordDraw(draw, draw.fRC->getBounds(), [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawPaint(draw, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(const SkDraw& draw, SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    if (count == 0) {
+        return;
+    }
+    SkRect bounds;
+    bounds.set(pts, SkToInt(count));
+    sk_sp<SkData> points = SkData::MakeWithCopy(pts, count * sizeof(SkPoint));
+    this->recordDraw(draw, DrawBounds(draw, bounds, paint),
+                     [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawPoints(draw, mode, count, data_or_null<SkPoint>(points), paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint& paint) {
+    this->recordDraw(draw, DrawBounds(draw, r, paint), [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawRect(draw, r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkDraw& draw, const SkRRect& rrect,
+                                    const SkPaint& paint) {
+    this->recordDraw(draw, DrawBounds(draw, rrect.getBounds(), paint),
+                     [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawRRect(draw, rrect, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPath(const SkDraw& draw, const SkPath& path, const SkPaint& paint,
+                                   const SkMatrix* prePathMatrix, bool) {
+    SkIRect bounds;
+    if (path.isInverseFillType()) {
+        bounds = draw.fRC->getBounds();
+    } else {
+        SkRect pathBounds = path.getBounds();
+        if (prePathMatrix) {
+            prePathMatrix->mapRect(&pathBounds);
+        }
+        bounds = DrawBounds(draw, pathBounds, paint);
+    }
+
+    const bool hasPrePathMatrix = prePathMatrix != nullptr;
+    const SkMatrix pre = hasPrePathMatrix ? *prePathMatrix : SkMatrix::I();
+    this->recordDraw(draw, bounds, [=](ImmediateDevice* d, const SkDraw& draw) {
+        // We can never let the path be mutated, as every tile shares it.
+        d->drawPath(draw, path, paint, hasPrePathMatrix ? &pre : nullptr, false);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkDraw& draw, const SkBitmap& bitmap,
+                                     const SkMatrix& matrix, const SkPaint& paint) {
+    SkRect bounds;
+    matrix.mapRect(&bounds, SkRect::Make(bitmap.bounds()));
+    SkBitmap snap = snapshot(bitmap);
+    this->recordDraw(draw, DrawBounds(draw, bounds, paint),
+                     [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawBitmap(draw, snap, matrix, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkDraw& draw, const SkBitmap& bitmap,
+                                     int x, int y, const SkPaint& paint) {
+    SkIRect bounds = SkIRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+    if (!bounds.intersect(draw.fRC->getBounds())) {
+        return;
+    }
+    SkBitmap snap = snapshot(bitmap);
+    this->recordDraw(draw, bounds, [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawSprite(draw, snap, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmapRect(const SkDraw& draw, const SkBitmap& bitmap,
+                                         const SkRect* src, const SkRect& dst,
+                                         const SkPaint& paint,
+                                         SkCanvas::SrcRectConstraint constraint) {
+    const bool hasSrc = src != nullptr;
+    const SkRect srcRect = hasSrc ? *src : SkRect::MakeEmpty();
+    SkBitmap snap = snapshot(bitmap);
+    this->recordDraw(draw, DrawBounds(draw, dst, paint),
+                     [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawBitmapRect(draw, snap, hasSrc ? &srcRect : nullptr, dst, paint, constraint);
+    });
+}
+
+void SkThreadedBMPDevice::drawText(const SkDraw& draw, const void* text, size_t len,
+                                   SkScalar x, SkScalar y, const SkPaint& paint) {
+    sk_sp<SkData> copy = SkData::MakeWithCopy(text, len);
+    this->recordDraw(draw, draw.fRC->getBounds(), [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawText(draw, copy->data(), len, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
+                                      const SkScalar pos[], int scalarsPerPos,
+                                      const SkPoint& offset, const SkPaint& paint) {
+    int glyphs = paint.countText(text, len);
+    sk_sp<SkData> copy = SkData::MakeWithCopy(text, len);
+    sk_sp<SkData> posCopy = SkData::MakeWithCopy(pos, glyphs * scalarsPerPos * sizeof(SkScalar));
+    this->recordDraw(draw, draw.fRC->getBounds(), [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawPosText(draw, copy->data(), len, data_or_null<SkScalar>(posCopy), scalarsPerPos,
+                       offset, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode,
+                                       int vertexCount, const SkPoint verts[],
+                                       const SkPoint texs[], const SkColor colors[],
+                                       SkXfermode* xmode, const uint16_t indices[],
+                                       int indexCount, const SkPaint& paint) {
+    if (vertexCount <= 0) {
+        return;
+    }
+    SkRect bounds;
+    bounds.set(verts, vertexCount);
+
+    sk_sp<SkData>     vertsCopy   = copy_or_null(verts,   vertexCount * sizeof(SkPoint)),
+                      texsCopy    = copy_or_null(texs,    vertexCount * sizeof(SkPoint)),
+                      colorsCopy  = copy_or_null(colors,  vertexCount * sizeof(SkColor)),
+                      indicesCopy = copy_or_null(indices, indexCount  * sizeof(uint16_t));
+    sk_sp<SkXfermode> xfer = sk_ref_sp(xmode);
+
+    this->recordDraw(draw, DrawBounds(draw, bounds, paint),
+                     [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawVertices(draw, vmode, vertexCount,
+                        data_or_null<SkPoint>(vertsCopy),
+                        data_or_null<SkPoint>(texsCopy),
+                        data_or_null<SkColor>(colorsCopy),
+                        xfer.get(),
+                        data_or_null<uint16_t>(indicesCopy), indexCount,
+                        paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawDevice(const SkDraw& draw, SkBaseDevice* device,
+                                     int x, int y, const SkPaint& paint) {
+    SkASSERT(!paint.getImageFilter());
+    // This is a layer that's being restored, and the canvas is about to throw it away,
+    // so we can hang onto its pixels without copying them.
+    const SkBitmap layer = static_cast<SkBitmapDevice*>(device)->fBitmap;
+
+    SkIRect bounds = SkIRect::MakeXYWH(x, y, layer.width(), layer.height());
+    if (!bounds.intersect(draw.fRC->getBounds())) {
+        return;
+    }
+    this->recordDraw(draw, bounds, [=](ImmediateDevice* d, const SkDraw& draw) {
+        d->drawSprite(draw, layer, x, y, paint);
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels,
+                                       size_t dstRowBytes, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(dstInfo, dstPixels, dstRowBytes, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkImageInfo& srcInfo, const void* srcPixels,
+                                        size_t srcRowBytes, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(srcInfo, srcPixels, srcRowBytes, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onAccessPixels(pmap);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkBitmapDevice.h"
+#include "SkRasterClip.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+
+#include <functional>
+
+/**
+ *  SkThreadedBMPDevice is an SkBitmapDevice that defers its draws.  Each draw is recorded along
+ *  with its matrix and clip, and binned into every tile of the device its bounds touch.  When
+ *  anyone needs to see our pixels (flush(), readPixels(), peekPixels(), snapSpecial(), ...) we
+ *  rasterize all the tiles in parallel on SkTaskGroup, each tile replaying its own draws with
+ *  the recorded clip but writing only the pixels inside that tile.  Scan conversion sees the same
+ *  geometry and clip as SkBitmapDevice would, so output is identical to SkBitmapDevice's.
+ *
+ *  Layers (saveLayer) are drawn immediately into ordinary SkBitmapDevices; only their final
+ *  composite onto this device is deferred.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    static constexpr int kDefaultTileSize = 256;
+
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                        int tileSize = kDefaultTileSize);
+    ~SkThreadedBMPDevice() override;
+
+    // Rasterize everything drawn so far.
+    void flush() override;
+
+protected:
+    void drawPaint(const SkDraw&, const SkPaint&) override;
+    void drawPoints(const SkDraw&, SkCanvas::PointMode, size_t count,
+                    const SkPoint[], const SkPaint&) override;
+    void drawRect(const SkDraw&, const SkRect&, const SkPaint&) override;
+    void drawRRect(const SkDraw&, const SkRRect&, const SkPaint&) override;
+    void drawPath(const SkDraw&, const SkPath&, const SkPaint&,
+                  const SkMatrix* prePathMatrix, bool pathIsMutable) override;
+    void drawBitmap(const SkDraw&, const SkBitmap&, const SkMatrix&, const SkPaint&) override;
+    void drawSprite(const SkDraw&, const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawBitmapRect(const SkDraw&, const SkBitmap&, const SkRect*, const SkRect&,
+                        const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawText(const SkDraw&, const void* text, size_t len,
+                  SkScalar x, SkScalar y, const SkPaint&) override;
+    void drawPosText(const SkDraw&, const void* text, size_t len,
+                     const SkScalar pos[], int scalarsPerPos,
+                     const SkPoint& offset, const SkPaint&) override;
+    void drawVertices(const SkDraw&, SkCanvas::VertexMode, int vertexCount,
+                      const SkPoint verts[], const SkPoint texs[],
+                      const SkColor colors[], SkXfermode* xmode,
+                      const uint16_t indices[], int indexCount,
+                      const SkPaint&) override;
+    void drawDevice(const SkDraw&, SkBaseDevice*, int x, int y, const SkPaint&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+
+    bool onReadPixels(const SkImageInfo&, void*, size_t, int x, int y) override;
+    bool onWritePixels(const SkImageInfo&, const void*, size_t, int x, int y) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    class ImmediateDevice;
+    typedef std::function<void(ImmediateDevice*, const SkDraw&)> DrawFn;
+
+    struct DrawElement {
+        SkMatrix fMatrix;
+        int      fClipIndex;   // Index into fClips.
+        DrawFn   fDraw;
+    };
+
+    // Record a draw that will touch at most the device-space pixels in bounds.
+    void recordDraw(const SkDraw&, const SkIRect& bounds, DrawFn&&);
+
+    // Device-space bounds for a draw of local-space bounds with this paint and SkDraw.
+    // Conservatively falls back to the clip bounds when the paint's effect is unbounded.
+    static SkIRect DrawBounds(const SkDraw&, const SkRect& localBounds, const SkPaint&);
+
+    int tileCount() const { return fTileCols * fTileRows; }
+    SkIRect tileBounds(int tile) const;
+    void drawTile(ImmediateDevice*, const SkPixmap&, int tile) const;
+
+    int                        fTileSize;
+    int                        fTileCols;
+    int                        fTileRows;
+
+    SkTArray<SkRasterClip>     fClips;     // Deduplicated clips of fElements.
+    SkTArray<DrawElement>      fElements;  // Every recorded draw, in order.
+    SkTArray<SkTDArray<int>>   fTileElements;  // Per tile, indices into fElements.
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif//SkThreadedBMPDevice_DEFINED
@@ -12,6 +12,7 @@
 #include "SkPixelRef.h"
 #include "SkPtrRecorder.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTypeface.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -193,7 +194,12 @@ void SkBinaryWriteBuffer::writeImage(const SkImage* image) {
     this->writeInt(image->width());
     this->writeInt(image->height());
 
-    sk_sp<SkData> encoded(image->encode(this->getPixelSerializer()));
+    sk_sp<SkData> encoded;
+    if (sk_sp<SkData>* found = fEncodedImages.find(image->uniqueID())) {
+        encoded = *found;
+    } else {
+        encoded.reset(image->encode(this->getPixelSerializer()));
+    }
     if (encoded && encoded->size() > 0) {
         write_encoded_bitmap(this, encoded.get(), SkIPoint::Make(0, 0));
         return;
@@ -209,6 +215,24 @@ void SkBinaryWriteBuffer::writeImage(const SkImage* image) {
     this->writeUInt(0); // signal no pixels (in place of the size of the encoded data)
 }
 
+void SkBinaryWriteBuffer::encodeImages(const SkImage* const images[], int count) {
+    if (fDeduper) {
+        return;  // writeImage() won't encode anything.
+    }
+    SkPixelSerializer* serializer = this->getPixelSerializer();
+    if (serializer && !serializer->isThreadSafe()) {
+        return;  // writeImage() will call it one image at a time.
+    }
+
+    SkAutoTArray<sk_sp<SkData>> encoded(count);
+    SkTaskGroup().batch(count, [&](int i) {
+        encoded[i].reset(images[i]->encode(serializer));
+    });
+    for (int i = 0; i < count; i++) {
+        fEncodedImages.set(images[i]->uniqueID(), std::move(encoded[i]));
+    }
+}
+
 void SkBinaryWriteBuffer::writeTypeface(SkTypeface* obj) {
     if (fDeduper) {
         this->write32(fDeduper->findOrDefineTypeface(obj));
@@ -6,11 +6,14 @@
  */
 
 #include "Sk4fLinearGradient.h"
+#include "SkArenaAlloc.h"
 #include "SkColorSpace_XYZ.h"
 #include "SkGradientShaderPriv.h"
 #include "SkHalf.h"
 #include "SkLinearGradient.h"
+#include "SkPM4fPriv.h"
 #include "SkRadialGradient.h"
+#include "SkRasterPipeline.h"
 #include "SkTwoPointConicalGradient.h"
 #include "SkSweepGradient.h"
 
@@ -350,6 +353,84 @@ bool SkGradientShaderBase::isOpaque() const {
     return fColorsAreOpaque;
 }
 
+bool SkGradientShaderBase::onAppendStages(SkRasterPipeline* p, SkColorSpace* dstColorSpace,
+                                          SkArenaAlloc* alloc, const SkMatrix& ctm,
+                                          const SkPaint&, const SkMatrix* localM) const {
+    SkMatrix matrix;
+    if (!this->computeTotalInverse(ctm, localM, &matrix)) {
+        return false;
+    }
+    matrix.postConcat(fPtsToUnit);
+
+    SkRasterPipeline postPipeline;
+
+    p->appendMatrix(alloc, matrix);
+    this->appendGradientStages(alloc, p, &postPipeline);
+
+    static const float kOne = 1.0f;
+    switch (fTileMode) {
+        case kClamp_TileMode:  p->append(SkRasterPipeline::clamp_x,  &kOne); break;
+        case kRepeat_TileMode: p->append(SkRasterPipeline::repeat_x, &kOne); break;
+        case kMirror_TileMode: p->append(SkRasterPipeline::mirror_x, &kOne); break;
+    }
+
+    // Legacy destinations interpolate the stops' bytes as-is; others use linear floats.
+    auto stop_color = [&](int i) {
+        SkColor4f c = dstColorSpace ? fOrigColors4f[i]
+                                    : SkColor4f_from_SkColor(fOrigColors[i], nullptr);
+        return fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag
+                ? Sk4f::Load(c.premul().fVec)
+                : Sk4f::Load(c.vec());
+    };
+    auto stop_pos = [&](int i) {
+        if (i == 0)               { return 0.0f; }
+        if (i == fColorCount - 1) { return 1.0f; }
+        return fOrigPos ? fOrigPos[i] : (float)i / (fColorCount - 1);
+    };
+
+    // Convert the stops into intervals where each channel is t*f + b, skipping empty ones.
+    auto ts = alloc->makeArrayDefault<float>(fColorCount - 1),
+         fs = alloc->makeArrayDefault<float>(4 * (fColorCount - 1)),
+         bs = alloc->makeArrayDefault<float>(4 * (fColorCount - 1));
+    int intervals = 0;
+    float t0 = 0;
+    for (int i = 0; i + 1 < fColorCount; i++) {
+        float t1 = SkTMax(t0, stop_pos(i+1));
+        if (t1 > t0) {
+            Sk4f c0 = stop_color(i),
+                 c1 = stop_color(i+1),
+                 f  = (c1 - c0) * (1 / (t1 - t0)),
+                 b  = c0 - f*t0;
+            ts[intervals] = intervals == 0 ? 0 : t0;
+            f.store(fs + 4*intervals);
+            b.store(bs + 4*intervals);
+            intervals++;
+        }
+        t0 = t1;
+    }
+    SkASSERT(intervals > 0);
+
+    if (intervals == 1) {
+        auto ctx = alloc->make<SkRasterPipeline::TwoStopGradientCtx>();
+        memcpy(ctx->f, fs, sizeof(ctx->f));
+        memcpy(ctx->b, bs, sizeof(ctx->b));
+        p->append(SkRasterPipeline::gradient_2stops, ctx);
+    } else {
+        auto ctx = alloc->make<SkRasterPipeline::GradientCtx>();
+        ctx->stopCount = intervals;
+        ctx->ts = ts;
+        ctx->fs = fs;
+        ctx->bs = bs;
+        p->append(SkRasterPipeline::gradient, ctx);
+    }
+
+    if (!(fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag) && !fColorsAreOpaque) {
+        p->append(SkRasterPipeline::premul);
+    }
+    p->extend(postPipeline);
+    return true;
+}
+
 static unsigned rounded_divide(unsigned numer, unsigned denom) {
     return (numer + (denom >> 1)) / denom;
 }
@@ -220,6 +220,14 @@ protected:
 
     bool onAsLuminanceColor(SkColor*) const override;
 
+    bool onAppendStages(SkRasterPipeline*, SkColorSpace*, SkArenaAlloc*, const SkMatrix& ctm,
+                        const SkPaint&, const SkMatrix* localM) const override;
+
+    // Appends to p the stages that map a point in unit space (after fPtsToUnit) in r,g to the
+    // gradient's t in r.  Stages appended to postPipeline run after t has become a color.
+    virtual void appendGradientStages(SkArenaAlloc*, SkRasterPipeline* p,
+                                      SkRasterPipeline* postPipeline) const = 0;
+
 
     void initLinearBitmap(SkBitmap* bitmap) const;
 
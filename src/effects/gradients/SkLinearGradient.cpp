@@ -86,6 +86,11 @@ SkShader::Context* SkLinearGradient::onCreateContext(const ContextRec& rec, void
         : CheckedCreateContext<  LinearGradientContext>(storage, *this, rec);
 }
 
+void SkLinearGradient::appendGradientStages(SkArenaAlloc*, SkRasterPipeline*,
+                                            SkRasterPipeline*) const {
+    // fPtsToUnit leaves t in x already.
+}
+
 // This swizzles SkColor into the same component order as SkPMColor, but does not actually
 // "pre" multiply the color components.
 //
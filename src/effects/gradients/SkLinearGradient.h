@@ -68,6 +68,8 @@ protected:
     void flatten(SkWriteBuffer& buffer) const override;
     size_t onContextSize(const ContextRec&) const override;
     Context* onCreateContext(const ContextRec&, void* storage) const override;
+    void appendGradientStages(SkArenaAlloc*, SkRasterPipeline* p,
+                              SkRasterPipeline* postPipeline) const override;
 
 private:
     class LinearGradient4fContext;
@@ -7,6 +7,7 @@
 
 #include "SkRadialGradient.h"
 #include "SkNx.h"
+#include "SkRasterPipeline.h"
 
 namespace {
 
@@ -47,6 +48,11 @@ SkShader::Context* SkRadialGradient::onCreateContext(const ContextRec& rec, void
     return CheckedCreateContext<RadialGradientContext>(storage, *this, rec);
 }
 
+void SkRadialGradient::appendGradientStages(SkArenaAlloc*, SkRasterPipeline* p,
+                                            SkRasterPipeline*) const {
+    p->append(SkRasterPipeline::xy_to_radius);
+}
+
 SkRadialGradient::RadialGradientContext::RadialGradientContext(
         const SkRadialGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec) {}
@@ -240,6 +246,7 @@ void SkRadialGradient::RadialGradientContext::shadeSpan(int x, int y,
 #if SK_SUPPORT_GPU
 
 #include "SkGr.h"
+#include "SkRasterPipeline.h"
 #include "glsl/GrGLSLCaps.h"
 #include "glsl/GrGLSLFragmentShaderBuilder.h"
 
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkRasterPipeline.h"
 #include "SkSweepGradient.h"
 
 static SkMatrix translate(SkScalar dx, SkScalar dy) {
@@ -53,6 +54,11 @@ SkShader::Context* SkSweepGradient::onCreateContext(const ContextRec& rec, void*
     return CheckedCreateContext<SweepGradientContext>(storage, *this, rec);
 }
 
+void SkSweepGradient::appendGradientStages(SkArenaAlloc*, SkRasterPipeline* p,
+                                           SkRasterPipeline*) const {
+    p->append(SkRasterPipeline::xy_to_angle);
+}
+
 SkSweepGradient::SweepGradientContext::SweepGradientContext(
         const SkSweepGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec) {}
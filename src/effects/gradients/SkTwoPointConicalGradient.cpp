@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
+#include "SkRasterPipeline.h"
 #include "SkTwoPointConicalGradient.h"
 
 struct TwoPtRadialContext {
@@ -219,6 +221,22 @@ SkShader::Context* SkTwoPointConicalGradient::onCreateContext(const ContextRec&
     return CheckedCreateContext<TwoPointConicalGradientContext>(storage, *this, rec);
 }
 
+void SkTwoPointConicalGradient::appendGradientStages(SkArenaAlloc* alloc, SkRasterPipeline* p,
+                                                     SkRasterPipeline* postPipeline) const {
+    auto ctx = alloc->make<SkRasterPipeline::TwoPointConicalCtx>();
+    ctx->centerX  = fRec.fCenterX;
+    ctx->centerY  = fRec.fCenterY;
+    ctx->radius   = fRec.fRadius;
+    ctx->dCenterX = fRec.fDCenterX;
+    ctx->dCenterY = fRec.fDCenterY;
+    ctx->dRadius  = fRec.fDRadius;
+    ctx->flipped  = fRec.fFlipped;
+
+    p->append(SkRasterPipeline::xy_to_2pt_conical, ctx);
+    // Points with no valid t stay transparent, as in the legacy shadeSpan().
+    postPipeline->append(SkRasterPipeline::mask_2pt_conical_degenerates);
+}
+
 SkTwoPointConicalGradient::TwoPointConicalGradientContext::TwoPointConicalGradientContext(
         const SkTwoPointConicalGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
 #include "SkBitmapProcShader.h"
 #include "SkBitmapProvider.h"
 #include "SkColorShader.h"
@@ -12,6 +13,7 @@
 #include "SkEmptyShader.h"
 #include "SkImage_Base.h"
 #include "SkImageShader.h"
+#include "SkRasterPipeline.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 
@@ -54,6 +56,117 @@ SkShader::Context* SkImageShader::onCreateContext(const ContextRec& rec, void* s
                                                  SkBitmapProvider(fImage.get()), rec, storage);
 }
 
+static SkRasterPipeline::TileMode pipeline_tile_mode(SkShader::TileMode mode) {
+    switch (mode) {
+        case SkShader::kRepeat_TileMode: return SkRasterPipeline::kRepeat_TileMode;
+        case SkShader::kMirror_TileMode: return SkRasterPipeline::kMirror_TileMode;
+        default:                         return SkRasterPipeline::kClamp_TileMode;
+    }
+}
+
+bool SkImageShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dstColorSpace,
+                                   SkArenaAlloc* alloc, const SkMatrix& ctm,
+                                   const SkPaint& paint, const SkMatrix* localM) const {
+    SkMatrix matrix;
+    if (!this->computeTotalInverse(ctm, localM, &matrix)) {
+        return false;
+    }
+
+    // Follow SkBitmapController's choices: downscaling at medium and high quality needs mipmaps,
+    // which we leave to the legacy shader; otherwise we filter with bicubic when upscaling at
+    // high quality, and bilinear for everything else.
+    SkFilterQuality quality = paint.getFilterQuality();
+    if (quality >= kMedium_SkFilterQuality) {
+        SkSize scale;
+        if (matrix.decomposeScale(&scale)) {
+            if (scale.width() > 1 || scale.height() > 1) {
+                return false;
+            }
+            bool unscaled = SkScalarNearlyEqual(scale.width(),  1)
+                         && SkScalarNearlyEqual(scale.height(), 1);
+            quality = (quality == kHigh_SkFilterQuality && !unscaled) ? kHigh_SkFilterQuality
+                                                                      : kLow_SkFilterQuality;
+        } else {
+            quality = kLow_SkFilterQuality;
+        }
+    }
+    if (quality == kLow_SkFilterQuality &&
+        matrix.getType() <= SkMatrix::kTranslate_Mask &&
+        SkScalarIsInt(matrix.getTranslateX()) && SkScalarIsInt(matrix.getTranslateY())) {
+        quality = kNone_SkFilterQuality;  // Every sample lands right on a pixel center.
+    }
+
+    auto bitmap = alloc->make<SkBitmap>();
+    if (!as_IB(fImage)->getROPixels(bitmap)) {
+        return false;
+    }
+    bitmap->lockPixels();
+    const SkImageInfo& info = bitmap->info();
+    if (!bitmap->getPixels() || info.alphaType() == kUnpremul_SkAlphaType) {
+        return false;
+    }
+    if (quality == kHigh_SkFilterQuality &&
+        info.colorType() == kN32_SkColorType && !matrix.hasPerspective()) {
+        return false;  // The legacy shader bilerps from a cached, prescaled copy, which is faster.
+    }
+
+    using SkRP = SkRasterPipeline;
+    SkRP::StockStage gather, bilinear, bicubic;
+    switch (info.colorType()) {
+        case kN32_SkColorType:
+            if (dstColorSpace && info.gammaCloseToSRGB()) {
+                gather   = SkRP::gather_srgb;
+                bilinear = SkRP::bilinear_srgb;
+                bicubic  = SkRP::bicubic_srgb;
+            } else {
+                gather   = SkRP::gather_8888;
+                bilinear = SkRP::bilinear_8888;
+                bicubic  = SkRP::bicubic_8888;
+            }
+            break;
+        case kRGB_565_SkColorType:
+            gather   = SkRP::gather_565;
+            bilinear = SkRP::bilinear_565;
+            bicubic  = SkRP::bicubic_565;
+            break;
+        case kRGBA_F16_SkColorType:
+            gather   = SkRP::gather_f16;
+            bilinear = SkRP::bilinear_f16;
+            bicubic  = SkRP::bicubic_f16;
+            break;
+        default:
+            return false;
+    }
+
+    auto ctx = alloc->make<SkRP::ImageCtx>();
+    ctx->pixels = bitmap->getPixels();
+    ctx->stride = bitmap->rowBytesAsPixels();
+    ctx->width  = info.width();
+    ctx->height = info.height();
+    ctx->tileX  = pipeline_tile_mode(fTileModeX);
+    ctx->tileY  = pipeline_tile_mode(fTileModeY);
+
+    p->appendMatrix(alloc, matrix);
+    switch (quality) {
+        case kNone_SkFilterQuality: {
+            auto append_tile = [&](TileMode mode, SkRP::StockStage clamp, SkRP::StockStage repeat,
+                                   SkRP::StockStage mirror, const float* limit) {
+                switch (mode) {
+                    case kClamp_TileMode:  p->append(clamp,  limit); break;
+                    case kRepeat_TileMode: p->append(repeat, limit); break;
+                    case kMirror_TileMode: p->append(mirror, limit); break;
+                }
+            };
+            append_tile(fTileModeX, SkRP::clamp_x, SkRP::repeat_x, SkRP::mirror_x, &ctx->width);
+            append_tile(fTileModeY, SkRP::clamp_y, SkRP::repeat_y, SkRP::mirror_y, &ctx->height);
+            p->append(gather, ctx);
+        } break;
+        case kHigh_SkFilterQuality: p->append(bicubic,  ctx); break;
+        default:                    p->append(bilinear, ctx); break;
+    }
+    return true;
+}
+
 SkImage* SkImageShader::onIsAImage(SkMatrix* texM, TileMode xy[]) const {
     if (texM) {
         *texM = this->getLocalMatrix();
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMaskSwizzler_opts_DEFINED
+#define SkMaskSwizzler_opts_DEFINED
+
+#include "SkNx.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#endif
+
+// Palette lookups and bit-masked unpacking, for SkSwizzler and SkMaskSwizzler.
+
+namespace SK_OPTS_NS {
+
+static void index_to_8888_portable(uint32_t dst[], const uint8_t src[], int count,
+                                   const uint32_t table[]) {
+    while (count >= 4) {
+        dst[0] = table[src[0]];
+        dst[1] = table[src[1]];
+        dst[2] = table[src[2]];
+        dst[3] = table[src[3]];
+        dst   += 4;
+        src   += 4;
+        count -= 4;
+    }
+    while (count --> 0) {
+        *dst++ = table[*src++];
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+
+static void index_to_8888(uint32_t dst[], const uint8_t src[], int count,
+                          const uint32_t table[]) {
+    while (count >= 8) {
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src));
+        _mm256_storeu_si256((__m256i*)dst,
+                            _mm256_i32gather_epi32((const int*)table, indices, 4));
+        dst   += 8;
+        src   += 8;
+        count -= 8;
+    }
+    index_to_8888_portable(dst, src, count, table);
+}
+
+#else
+
+// Without a gather instruction, a lookup is as fast as a lookup gets.
+static void index_to_8888(uint32_t dst[], const uint8_t src[], int count,
+                          const uint32_t table[]) {
+    index_to_8888_portable(dst, src, count, table);
+}
+
+#endif
+
+// Each channel c of a masked pixel is scaled from its mask's bit depth n to 8 bits with
+// round(c * 255 / (2^n - 1)).  That's never a tie, and float is precise enough to round the
+// same way as SkMasks does with its lookup table.
+struct MaskChannel {
+    explicit MaskChannel(uint32_t mask) : fShift(0), fMask(0), fScale(0) {
+        if (mask) {
+            while (!(mask & 1)) {
+                mask >>= 1;
+                fShift++;
+            }
+            int size = 0;
+            for (uint32_t m = mask; m; m >>= 1) {
+                size++;
+            }
+            SkASSERT(size <= 8);
+            fMask  = mask;
+            fScale = 255.0f / ((1 << size) - 1);
+        }
+    }
+
+    Sk4i extract(const Sk4u& px) const {
+        Sk4f c = SkNx_cast<float>((px >> fShift) & fMask);
+        return SkNx_cast<int32_t>(c * fScale + 0.5f);
+    }
+
+    int      fShift;
+    uint32_t fMask;
+    float    fScale;
+};
+
+static Sk4u load_masked(const uint16_t src[4]) {
+    return Sk4u(src[0], src[1], src[2], src[3]);
+}
+static Sk4u load_masked(const uint32_t src[4]) {
+    return Sk4u::Load(src);
+}
+
+enum MaskedAlpha { kOpaque_MaskedAlpha, kUnpremul_MaskedAlpha, kPremul_MaskedAlpha };
+
+template <typename Pixel, MaskedAlpha kAlpha>
+static void masked_to(uint32_t dst[], const void* vsrc, int count, const uint32_t masks[4]) {
+    const MaskChannel c0(masks[0]), c1(masks[1]), c2(masks[2]), c3(masks[3]);
+    auto convert = [&](const Pixel src[4], uint32_t dst[4]) {
+        Sk4u px = load_masked(src);
+        Sk4i r = c0.extract(px),
+             g = c1.extract(px),
+             b = c2.extract(px),
+             a = kOpaque_MaskedAlpha == kAlpha ? Sk4i(0xFF) : c3.extract(px);
+        if (kPremul_MaskedAlpha == kAlpha) {
+            Sk4f scale = SkNx_cast<float>(a) * (1/255.0f);
+            r = SkNx_cast<int32_t>(SkNx_cast<float>(r) * scale + 0.5f);
+            g = SkNx_cast<int32_t>(SkNx_cast<float>(g) * scale + 0.5f);
+            b = SkNx_cast<int32_t>(SkNx_cast<float>(b) * scale + 0.5f);
+        }
+        (r | g << 8 | b << 16 | a << 24).store(dst);
+    };
+
+    const Pixel* src = (const Pixel*)vsrc;
+    while (count >= 4) {
+        convert(src, dst);
+        dst   += 4;
+        src   += 4;
+        count -= 4;
+    }
+    if (count > 0) {
+        Pixel    tmpSrc[4] = { 0, 0, 0, 0 };
+        uint32_t tmpDst[4];
+        memcpy(tmpSrc, src, count * sizeof(Pixel));
+        convert(tmpSrc, tmpDst);
+        memcpy(dst, tmpDst, count * sizeof(uint32_t));
+    }
+}
+
+static void mask16_to_RGB1(uint32_t dst[], const void* src, int count, const uint32_t masks[4]) {
+    masked_to<uint16_t, kOpaque_MaskedAlpha>(dst, src, count, masks);
+}
+static void mask16_to_RGBA(uint32_t dst[], const void* src, int count, const uint32_t masks[4]) {
+    masked_to<uint16_t, kUnpremul_MaskedAlpha>(dst, src, count, masks);
+}
+static void mask16_to_rgbA(uint32_t dst[], const void* src, int count, const uint32_t masks[4]) {
+    masked_to<uint16_t, kPremul_MaskedAlpha>(dst, src, count, masks);
+}
+static void mask32_to_RGB1(uint32_t dst[], const void* src, int count, const uint32_t masks[4]) {
+    masked_to<uint32_t, kOpaque_MaskedAlpha>(dst, src, count, masks);
+}
+static void mask32_to_RGBA(uint32_t dst[], const void* src, int count, const uint32_t masks[4]) {
+    masked_to<uint32_t, kUnpremul_MaskedAlpha>(dst, src, count, masks);
+}
+static void mask32_to_rgbA(uint32_t dst[], const void* src, int count, const uint32_t masks[4]) {
+    masked_to<uint32_t, kPremul_MaskedAlpha>(dst, src, count, masks);
+}
+
+}
+
+#endif // SkMaskSwizzler_opts_DEFINED
@@ -578,6 +578,8 @@ public:
         AI SkNx   sqrt() const { return _mm256_sqrt_ps (fVec); }
         AI SkNx  rsqrt() const { return _mm256_rsqrt_ps(fVec); }
         AI SkNx invert() const { return _mm256_rcp_ps  (fVec); }
+        AI SkNx  floor() const { return _mm256_floor_ps(fVec); }
+        AI SkNx    abs() const { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), fVec); }
 
         AI float operator[](int k) const {
             SkASSERT(0 <= k && k < 8);
@@ -8,11 +8,20 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS hsw
+#include "SkMaskSwizzler_opts.h"
 #include "SkRasterPipeline_opts.h"
 
 namespace SkOpts {
     void Init_hsw() {
         compile_pipeline = hsw::compile_pipeline;
+
+        index_to_8888  = hsw::index_to_8888;
+        mask16_to_RGB1 = hsw::mask16_to_RGB1;
+        mask16_to_RGBA = hsw::mask16_to_RGBA;
+        mask16_to_rgbA = hsw::mask16_to_rgbA;
+        mask32_to_RGB1 = hsw::mask32_to_RGB1;
+        mask32_to_RGBA = hsw::mask32_to_RGBA;
+        mask32_to_rgbA = hsw::mask32_to_rgbA;
     }
 }
 
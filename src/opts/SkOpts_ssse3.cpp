@@ -9,6 +9,7 @@
 #define SK_OPTS_NS ssse3
 #include "SkBlitMask_opts.h"
 #include "SkColorCubeFilter_opts.h"
+#include "SkMaskSwizzler_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkXfermode_opts.h"
 
@@ -28,5 +29,13 @@ namespace SkOpts {
         grayA_to_rgbA         = ssse3::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = ssse3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
+
+        index_to_8888  = ssse3::index_to_8888;
+        mask16_to_RGB1 = ssse3::mask16_to_RGB1;
+        mask16_to_RGBA = ssse3::mask16_to_RGBA;
+        mask16_to_rgbA = ssse3::mask16_to_rgbA;
+        mask32_to_RGB1 = ssse3::mask32_to_RGB1;
+        mask32_to_RGBA = ssse3::mask32_to_RGBA;
+        mask32_to_rgbA = ssse3::mask32_to_rgbA;
     }
 }
@@ -59,6 +59,18 @@ SI void SK_VECTORCALL next(TailStage* st, size_t x, size_t tail,
     static SK_ALWAYS_INLINE void name##_kernel(void* ctx, size_t x, size_t tail,         \
                                                SkNf&  r, SkNf&  g, SkNf&  b, SkNf&  a,   \
                                                SkNf& dr, SkNf& dg, SkNf& db, SkNf& da);  \
+    namespace {                                                                          \
+    struct name##_fused {                                                                \
+        static const SkRasterPipeline::StockStage kStage = SkRasterPipeline::name;       \
+        static const bool kCallsNext = kCallNext;                                        \
+        template <bool kIsTail>                                                          \
+        static SK_ALWAYS_INLINE void Run(void* ctx, size_t x, size_t tail,               \
+                                         SkNf&  r, SkNf&  g, SkNf&  b, SkNf&  a,         \
+                                         SkNf& dr, SkNf& dg, SkNf& db, SkNf& da) {       \
+            name##_kernel<kIsTail>(ctx, x,tail, r,g,b,a, dr,dg,db,da);                   \
+        }                                                                                \
+    };                                                                                   \
+    }                                                                                    \
     SI void SK_VECTORCALL name(BodyStage* st, size_t x,                                  \
                                SkNf  r, SkNf  g, SkNf  b, SkNf  a,                       \
                                SkNf dr, SkNf dg, SkNf db, SkNf da) {                     \
@@ -82,53 +94,71 @@ SI void SK_VECTORCALL next(TailStage* st, size_t x, size_t tail,
 
 
 // Many xfermodes apply the same logic to each channel.
-#define RGBA_XFERMODE(name)                                                     \
-    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,   \
-                                               const SkNf& d, const SkNf& da);  \
-    SI void SK_VECTORCALL name(BodyStage* st, size_t x,                         \
-                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,              \
-                               SkNf dr, SkNf dg, SkNf db, SkNf da) {            \
-        r = name##_kernel(r,a,dr,da);                                           \
-        g = name##_kernel(g,a,dg,da);                                           \
-        b = name##_kernel(b,a,db,da);                                           \
-        a = name##_kernel(a,a,da,da);                                           \
-        next(st, x, r,g,b,a, dr,dg,db,da);                                      \
-    }                                                                           \
-    SI void SK_VECTORCALL name(TailStage* st, size_t x, size_t tail,            \
-                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,              \
-                               SkNf dr, SkNf dg, SkNf db, SkNf da) {            \
-        r = name##_kernel(r,a,dr,da);                                           \
-        g = name##_kernel(g,a,dg,da);                                           \
-        b = name##_kernel(b,a,db,da);                                           \
-        a = name##_kernel(a,a,da,da);                                           \
-        next(st, x,tail, r,g,b,a, dr,dg,db,da);                                 \
-    }                                                                           \
-    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,   \
+#define RGBA_XFERMODE(name)                                                             \
+    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,           \
+                                               const SkNf& d, const SkNf& da);          \
+    namespace {                                                                         \
+    struct name##_fused {                                                               \
+        static const SkRasterPipeline::StockStage kStage = SkRasterPipeline::name;      \
+        static const bool kCallsNext = true;                                            \
+        template <bool kIsTail>                                                         \
+        static SK_ALWAYS_INLINE void Run(void*, size_t, size_t,                         \
+                                         SkNf&  r, SkNf&  g, SkNf&  b, SkNf&  a,        \
+                                         SkNf& dr, SkNf& dg, SkNf& db, SkNf& da) {      \
+            r = name##_kernel(r,a,dr,da);                                               \
+            g = name##_kernel(g,a,dg,da);                                               \
+            b = name##_kernel(b,a,db,da);                                               \
+            a = name##_kernel(a,a,da,da);                                               \
+        }                                                                               \
+    };                                                                                  \
+    }                                                                                   \
+    SI void SK_VECTORCALL name(BodyStage* st, size_t x,                                 \
+                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,                      \
+                               SkNf dr, SkNf dg, SkNf db, SkNf da) {                    \
+        name##_fused::Run<false>(st->ctx, x,0, r,g,b,a, dr,dg,db,da);                   \
+        next(st, x, r,g,b,a, dr,dg,db,da);                                              \
+    }                                                                                   \
+    SI void SK_VECTORCALL name(TailStage* st, size_t x, size_t tail,                    \
+                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,                      \
+                               SkNf dr, SkNf dg, SkNf db, SkNf da) {                    \
+        name##_fused::Run<true>(st->ctx, x,tail, r,g,b,a, dr,dg,db,da);                 \
+        next(st, x,tail, r,g,b,a, dr,dg,db,da);                                         \
+    }                                                                                   \
+    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,           \
                                                const SkNf& d, const SkNf& da)
 
 // Most of the rest apply the same logic to color channels and use srcover's alpha logic.
-#define RGB_XFERMODE(name)                                                      \
-    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,   \
-                                               const SkNf& d, const SkNf& da);  \
-    SI void SK_VECTORCALL name(BodyStage* st, size_t x,                         \
-                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,              \
-                               SkNf dr, SkNf dg, SkNf db, SkNf da) {            \
-        r = name##_kernel(r,a,dr,da);                                           \
-        g = name##_kernel(g,a,dg,da);                                           \
-        b = name##_kernel(b,a,db,da);                                           \
-        a = a + (da * (1.0f-a));                                                \
-        next(st, x, r,g,b,a, dr,dg,db,da);                                      \
-    }                                                                           \
-    SI void SK_VECTORCALL name(TailStage* st, size_t x, size_t tail,            \
-                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,              \
-                               SkNf dr, SkNf dg, SkNf db, SkNf da) {            \
-        r = name##_kernel(r,a,dr,da);                                           \
-        g = name##_kernel(g,a,dg,da);                                           \
-        b = name##_kernel(b,a,db,da);                                           \
-        a = a + (da * (1.0f-a));                                                \
-        next(st, x,tail, r,g,b,a, dr,dg,db,da);                                 \
-    }                                                                           \
-    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,   \
+#define RGB_XFERMODE(name)                                                              \
+    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,           \
+                                               const SkNf& d, const SkNf& da);          \
+    namespace {                                                                         \
+    struct name##_fused {                                                               \
+        static const SkRasterPipeline::StockStage kStage = SkRasterPipeline::name;      \
+        static const bool kCallsNext = true;                                            \
+        template <bool kIsTail>                                                         \
+        static SK_ALWAYS_INLINE void Run(void*, size_t, size_t,                         \
+                                         SkNf&  r, SkNf&  g, SkNf&  b, SkNf&  a,        \
+                                         SkNf& dr, SkNf& dg, SkNf& db, SkNf& da) {      \
+            r = name##_kernel(r,a,dr,da);                                               \
+            g = name##_kernel(g,a,dg,da);                                               \
+            b = name##_kernel(b,a,db,da);                                               \
+            a = a + (da * (1.0f-a));                                                    \
+        }                                                                               \
+    };                                                                                  \
+    }                                                                                   \
+    SI void SK_VECTORCALL name(BodyStage* st, size_t x,                                 \
+                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,                      \
+                               SkNf dr, SkNf dg, SkNf db, SkNf da) {                    \
+        name##_fused::Run<false>(st->ctx, x,0, r,g,b,a, dr,dg,db,da);                   \
+        next(st, x, r,g,b,a, dr,dg,db,da);                                              \
+    }                                                                                   \
+    SI void SK_VECTORCALL name(TailStage* st, size_t x, size_t tail,                    \
+                               SkNf  r, SkNf  g, SkNf  b, SkNf  a,                      \
+                               SkNf dr, SkNf dg, SkNf db, SkNf da) {                    \
+        name##_fused::Run<true>(st->ctx, x,tail, r,g,b,a, dr,dg,db,da);                 \
+        next(st, x,tail, r,g,b,a, dr,dg,db,da);                                         \
+    }                                                                                   \
+    static SK_ALWAYS_INLINE SkNf name##_kernel(const SkNf& s, const SkNf& sa,           \
                                                const SkNf& d, const SkNf& da)
 
 SI SkNf inv(const SkNf& x) { return 1.0f - x; }
@@ -137,11 +167,52 @@ SI SkNf lerp(const SkNf& from, const SkNf& to, const SkNf& cov) {
     return SkNx_fma(to-from, cov, from);
 }
 
+// Like SkNx_fma(), but scalars can stand in for any argument.
+SI SkNf mad(const SkNf& f, const SkNf& m, const SkNf& a) {
+    return SkNx_fma(f, m, a);
+}
+
+// When we can, we load and store tails under a mask, all at once.
+// These return false when there's no masked load or store for T on this CPU.
+template <typename T>
+SI bool masked_load (size_t, const T*, SkNx<N,T>*) { return false; }
+template <typename T>
+SI bool masked_store(size_t, const SkNx<N,T>&, T*) { return false; }
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // The first tail lanes of this mask are on, the rest off.
+    SI __m256i tail_mask(size_t tail) {
+        static const int32_t kMask[] = { -1,-1,-1,-1,-1,-1,-1,-1, 0,0,0,0,0,0,0,0 };
+        return _mm256_loadu_si256((const __m256i*)(kMask + 8 - (tail & (N-1))));
+    }
+
+    SI bool masked_load(size_t tail, const int* src, SkNi* v) {
+        *v = _mm256_maskload_epi32(src, tail_mask(tail));
+        return true;
+    }
+    SI bool masked_load(size_t tail, const uint32_t* src, SkNx<N,uint32_t>* v) {
+        *v = _mm256_maskload_epi32((const int*)src, tail_mask(tail));
+        return true;
+    }
+    SI bool masked_store(size_t tail, const SkNi& v, int* dst) {
+        _mm256_maskstore_epi32(dst, tail_mask(tail), v.fVec);
+        return true;
+    }
+    SI bool masked_store(size_t tail, const SkNx<N,uint32_t>& v, uint32_t* dst) {
+        _mm256_maskstore_epi32((int*)dst, tail_mask(tail), v.fVec);
+        return true;
+    }
+#endif
+
 template <bool kIsTail, typename T>
 SI SkNx<N,T> load(size_t tail, const T* src) {
     SkASSERT(kIsTail == (tail > 0));
-    // TODO: maskload for 32- and 64-bit T
+    static_assert(N <= 8, "The tail switch below handles at most 7 tail lanes.");
     if (kIsTail) {
+        SkNx<N,T> v;
+        if (masked_load(tail, src, &v)) {
+            return v;
+        }
         T buf[8] = {0};
         switch (tail & (N-1)) {
             case 7: buf[6] = src[6];
@@ -160,8 +231,11 @@ SI SkNx<N,T> load(size_t tail, const T* src) {
 template <bool kIsTail, typename T>
 SI void store(size_t tail, const SkNx<N,T>& v, T* dst) {
     SkASSERT(kIsTail == (tail > 0));
-    // TODO: maskstore for 32- and 64-bit T
+    static_assert(N <= 8, "The tail switch below handles at most 7 tail lanes.");
     if (kIsTail) {
+        if (masked_store(tail, v, dst)) {
+            return;
+        }
         switch (tail & (N-1)) {
             case 7: dst[6] = v[6];
             case 6: dst[5] = v[5];
@@ -190,16 +264,22 @@ SI SkNh to_565(const SkNf& r, const SkNf& g, const SkNf& b) {
                               | SkNx_cast<int>(b * SK_B16_MASK + 0.5f) << SK_B16_SHIFT);
 }
 
-STAGE(just_return, false) { }
+// Ends every pipeline.  It's not a StockStage, so it's not written with STAGE().
+SI void SK_VECTORCALL just_return(BodyStage*, size_t, SkNf,SkNf,SkNf,SkNf,
+                                                      SkNf,SkNf,SkNf,SkNf) {}
+SI void SK_VECTORCALL just_return(TailStage*, size_t, size_t, SkNf,SkNf,SkNf,SkNf,
+                                                              SkNf,SkNf,SkNf,SkNf) {}
 
-/*  We don't seem to have a need for this yet.
 STAGE(clamp_0, true) {
     a = SkNf::Max(a, 0.0f);
     r = SkNf::Max(r, 0.0f);
     g = SkNf::Max(g, 0.0f);
     b = SkNf::Max(b, 0.0f);
 }
-*/
+
+STAGE(clamp_a, true) {
+    a = SkNf::Min(a, 1.0f);
+}
 
 STAGE(clamp_1, true) {
     a = SkNf::Min(a, 1.0f);
@@ -390,6 +470,33 @@ STAGE(store_srgb, false) {
                          | SkNx_cast<int>(255.0f * a + 0.5f) << SK_A32_SHIFT ), (int*)ptr);
 }
 
+// Load 8-bit SkPMColor-order linear (legacy) 8888.
+SI void from_8888(const SkNx<N, uint32_t>& px, SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+    auto to_int = [](const SkNx<N, uint32_t>& v) { return SkNi::Load(&v); };
+    *r = (1/255.0f)*SkNx_cast<float>(to_int((px >> SK_R32_SHIFT) & 0xff));
+    *g = (1/255.0f)*SkNx_cast<float>(to_int((px >> SK_G32_SHIFT) & 0xff));
+    *b = (1/255.0f)*SkNx_cast<float>(to_int((px >> SK_B32_SHIFT) & 0xff));
+    *a = (1/255.0f)*SkNx_cast<float>(to_int( px >> SK_A32_SHIFT        ));
+}
+
+STAGE(load_d_8888, true) {
+    auto ptr = *(const uint32_t**)ctx + x;
+    from_8888(load<kIsTail>(tail, ptr), &dr,&dg,&db,&da);
+}
+
+STAGE(load_s_8888, true) {
+    auto ptr = *(const uint32_t**)ctx + x;
+    from_8888(load<kIsTail>(tail, ptr), &r,&g,&b,&a);
+}
+
+STAGE(store_8888, false) {
+    auto ptr = *(uint32_t**)ctx + x;
+    store<kIsTail>(tail, ( SkNx_cast<int>(255.0f * r + 0.5f) << SK_R32_SHIFT
+                         | SkNx_cast<int>(255.0f * g + 0.5f) << SK_G32_SHIFT
+                         | SkNx_cast<int>(255.0f * b + 0.5f) << SK_B32_SHIFT
+                         | SkNx_cast<int>(255.0f * a + 0.5f) << SK_A32_SHIFT ), (int*)ptr);
+}
+
 RGBA_XFERMODE(clear)    { return 0.0f; }
 //RGBA_XFERMODE(src)      { return s; }   // This would be a no-op stage, so we just omit it.
 RGBA_XFERMODE(dst)      { return d; }
@@ -445,6 +552,393 @@ RGB_XFERMODE(softlight) {
 }
 
 
+STAGE(unpremul, true) {
+    auto scale = (a == 0.0f).thenElse(0.0f, 1.0f / a);
+    r *= scale;
+    g *= scale;
+    b *= scale;
+}
+
+STAGE(premul, true) {
+    r *= a;
+    g *= a;
+    b *= a;
+}
+
+STAGE(scale_1_float, true) {
+    SkNf c = *(const float*)ctx;
+
+    r *= c;
+    g *= c;
+    b *= c;
+    a *= c;
+}
+
+// Applies a column-major 4x5 matrix (the 4x4 matrix, then the translate) to unpremul color.
+STAGE(matrix_4x5, true) {
+    auto m = (const float*)ctx;
+
+    auto R = mad(r,m[0], mad(g,m[4], mad(b,m[ 8], mad(a,m[12], m[16])))),
+         G = mad(r,m[1], mad(g,m[5], mad(b,m[ 9], mad(a,m[13], m[17])))),
+         B = mad(r,m[2], mad(g,m[6], mad(b,m[10], mad(a,m[14], m[18])))),
+         A = mad(r,m[3], mad(g,m[7], mad(b,m[11], mad(a,m[15], m[19]))));
+    r = R;
+    g = G;
+    b = B;
+    a = A;
+}
+
+// Shaders start with the device-space coordinates of the centers of the pixels in r and g.
+// The context is a pointer to the current y.
+STAGE(seed_shader, true) {
+    static const float kIota[] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+    static_assert(N <= SK_ARRAY_COUNT(kIota), "");
+
+    r = SkNf((float)x) + SkNf::Load(kIota);
+    g = SkNf(*(const int*)ctx + 0.5f);
+    b = 1.0f;
+    a = 0.0f;
+    dr = dg = db = da = 0.0f;
+}
+
+// Maps r,g through an affine matrix, stored as in SkMatrix::asAffine().
+STAGE(matrix_2x3, true) {
+    auto m = (const float*)ctx;
+
+    auto R = mad(r,m[0], mad(g,m[2], m[4])),
+         G = mad(r,m[1], mad(g,m[3], m[5]));
+    r = R;
+    g = G;
+}
+
+// Maps r,g through a perspective matrix, stored as in SkMatrix::get9().
+STAGE(matrix_perspective, true) {
+    auto m = (const float*)ctx;
+
+    auto R = mad(r,m[0], mad(g,m[1], m[2])),
+         G = mad(r,m[3], mad(g,m[4], m[5])),
+         Z = mad(r,m[6], mad(g,m[7], m[8]));
+    r = R / Z;
+    g = G / Z;
+}
+
+// Tiling maps a coordinate into [0,limit].  The samplers take care of limit itself.
+SI SkNf clamp(const SkNf& v, float limit) {
+    return SkNf::Min(SkNf::Max(v, 0.0f), limit);
+}
+SI SkNf repeat(const SkNf& v, float limit) {
+    return v - (v * (1/limit)).floor() * limit;
+}
+SI SkNf mirror(const SkNf& v, float limit) {
+    auto t = v - limit;
+    return (t - (t * (0.5f/limit)).floor() * (2*limit) - limit).abs();
+}
+SI SkNf tile(const SkNf& v, SkRasterPipeline::TileMode mode, float limit) {
+    switch (mode) {
+        case SkRasterPipeline::kClamp_TileMode:  return clamp (v, limit);
+        case SkRasterPipeline::kRepeat_TileMode: return repeat(v, limit);
+        case SkRasterPipeline::kMirror_TileMode: return mirror(v, limit);
+    }
+    return v;
+}
+
+STAGE(clamp_x,  true) { r = clamp (r, *(const float*)ctx); }
+STAGE(clamp_y,  true) { g = clamp (g, *(const float*)ctx); }
+STAGE(repeat_x, true) { r = repeat(r, *(const float*)ctx); }
+STAGE(repeat_y, true) { g = repeat(g, *(const float*)ctx); }
+STAGE(mirror_x, true) { r = mirror(r, *(const float*)ctx); }
+STAGE(mirror_y, true) { g = mirror(g, *(const float*)ctx); }
+
+template <typename T>
+SI SkNx<N,T> gather(const T* p, const SkNi& offset) {
+    T buf[N];
+    for (int i = 0; i < N; i++) {
+        buf[i] = p[offset[i]];
+    }
+    return SkNx<N,T>::Load(buf);
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    SI SkNx<N,uint32_t> gather(const uint32_t* p, const SkNi& offset) {
+        return _mm256_i32gather_epi32((const int*)p, offset.fVec, 4);
+    }
+#endif
+
+// The offset of the pixel containing x,y, clamped to stay inside the image.
+SI SkNi offset(const SkRasterPipeline::ImageCtx* ctx, const SkNf& x, const SkNf& y) {
+    auto ix = SkNx_cast<int>(SkNf::Min(SkNf::Max(x, 0.0f), ctx->width  - 1)),
+         iy = SkNx_cast<int>(SkNf::Min(SkNf::Max(y, 0.0f), ctx->height - 1));
+    return ix + iy * SkNi(ctx->stride);
+}
+
+// Each of these reads the pixels at the given offsets, as premultiplied float color.
+namespace {
+
+    struct Read8888 {
+        static SK_ALWAYS_INLINE void Gather(const SkRasterPipeline::ImageCtx* ctx, const SkNi& off,
+                                            SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+            from_8888(gather((const uint32_t*)ctx->pixels, off), r,g,b,a);
+        }
+    };
+
+    struct ReadSRGB {
+        static SK_ALWAYS_INLINE void Gather(const SkRasterPipeline::ImageCtx* ctx, const SkNi& off,
+                                            SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+            auto px = gather((const uint32_t*)ctx->pixels, off);
+            auto to_int = [](const SkNx<N, uint32_t>& v) { return SkNi::Load(&v); };
+            *r = sk_linear_from_srgb_math(to_int((px >> SK_R32_SHIFT) & 0xff));
+            *g = sk_linear_from_srgb_math(to_int((px >> SK_G32_SHIFT) & 0xff));
+            *b = sk_linear_from_srgb_math(to_int((px >> SK_B32_SHIFT) & 0xff));
+            *a = (1/255.0f)*SkNx_cast<float>(to_int( px >> SK_A32_SHIFT        ));
+        }
+    };
+
+    struct Read565 {
+        static SK_ALWAYS_INLINE void Gather(const SkRasterPipeline::ImageCtx* ctx, const SkNi& off,
+                                            SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+            from_565(gather((const uint16_t*)ctx->pixels, off), r,g,b);
+            *a = 1.0f;
+        }
+    };
+
+    struct ReadF16 {
+        static SK_ALWAYS_INLINE void Gather(const SkRasterPipeline::ImageCtx* ctx, const SkNi& off,
+                                            SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+            auto p = (const uint64_t*)ctx->pixels;
+            uint64_t buf[N];
+            for (int i = 0; i < N; i++) {
+                buf[i] = p[off[i]];
+            }
+            SkNh rh, gh, bh, ah;
+            SkNh::Load4(buf, &rh, &gh, &bh, &ah);
+            *r = SkHalfToFloat_finite_ftz(rh);
+            *g = SkHalfToFloat_finite_ftz(gh);
+            *b = SkHalfToFloat_finite_ftz(bh);
+            *a = SkHalfToFloat_finite_ftz(ah);
+        }
+    };
+
+}  // namespace
+
+template <typename Read>
+SI void sample_nearest(const SkRasterPipeline::ImageCtx* ctx,
+                       SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+    Read::Gather(ctx, offset(ctx, *r, *g), r,g,b,a);
+}
+
+// Bilinear filtering blends the four pixels whose centers surround x,y.
+template <typename Read>
+SI void sample_bilinear(const SkRasterPipeline::ImageCtx* ctx,
+                        SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+    SkNf fx = *r - 0.5f,
+         fy = *g - 0.5f,
+         x0 = fx.floor(),
+         y0 = fy.floor(),
+         tx = fx - x0,
+         ty = fy - y0;
+
+    const SkNf xs[] = { tile(x0 + 0.5f, ctx->tileX, ctx->width),
+                        tile(x0 + 1.5f, ctx->tileX, ctx->width) },
+               wx[] = { 1.0f - tx, tx };
+
+    SkNf R = 0.0f, G = 0.0f, B = 0.0f, A = 0.0f;
+    for (int j = 0; j < 2; j++) {
+        SkNf y  = tile(y0 + (j + 0.5f), ctx->tileY, ctx->height),
+             wy = j ? ty : 1.0f - ty;
+        for (int i = 0; i < 2; i++) {
+            SkNf w = wy * wx[i];
+
+            SkNf sr, sg, sb, sa;
+            Read::Gather(ctx, offset(ctx, xs[i], y), &sr,&sg,&sb,&sa);
+            R = mad(sr, w, R);
+            G = mad(sg, w, G);
+            B = mad(sb, w, B);
+            A = mad(sa, w, A);
+        }
+    }
+    *r = R;
+    *g = G;
+    *b = B;
+    *a = A;
+}
+
+// Mitchell-Netravali filter weights (B = C = 1/3) for the four taps around a sample point,
+// at distances 1+t, t, 1-t, and 2-t.
+SI void bicubic_weights(const SkNf& t, SkNf w[4]) {
+    auto inner = [](const SkNf& d) {
+        return mad(d*d, mad(d, SkNf(7/6.0f), SkNf(-2.0f)), SkNf(8/9.0f));
+    };
+    auto outer = [](const SkNf& d) {
+        return mad(d, mad(d, mad(d, SkNf(-7/18.0f), SkNf(2.0f)),
+                                    SkNf(-10/3.0f)),
+                        SkNf(16/9.0f));
+    };
+    w[0] = outer(1.0f + t);
+    w[1] = inner(t);
+    w[2] = inner(1.0f - t);
+    w[3] = outer(2.0f - t);
+}
+
+// Bicubic filtering blends the sixteen pixels whose centers surround x,y.  The filter has
+// negative lobes, so the result is clamped back to a valid premultiplied color.
+template <typename Read>
+SI void sample_bicubic(const SkRasterPipeline::ImageCtx* ctx,
+                       SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+    SkNf fx = *r - 0.5f,
+         fy = *g - 0.5f,
+         x0 = fx.floor(),
+         y0 = fy.floor();
+
+    SkNf wx[4], wy[4], xs[4];
+    bicubic_weights(fx - x0, wx);
+    bicubic_weights(fy - y0, wy);
+    for (int i = 0; i < 4; i++) {
+        xs[i] = tile(x0 + (i - 0.5f), ctx->tileX, ctx->width);
+    }
+
+    SkNf R = 0.0f, G = 0.0f, B = 0.0f, A = 0.0f;
+    for (int j = 0; j < 4; j++) {
+        SkNf y = tile(y0 + (j - 0.5f), ctx->tileY, ctx->height);
+        for (int i = 0; i < 4; i++) {
+            SkNf w = wx[i] * wy[j];
+
+            SkNf sr, sg, sb, sa;
+            Read::Gather(ctx, offset(ctx, xs[i], y), &sr,&sg,&sb,&sa);
+            R = mad(sr, w, R);
+            G = mad(sg, w, G);
+            B = mad(sb, w, B);
+            A = mad(sa, w, A);
+        }
+    }
+    *a = SkNf::Min(SkNf::Max(A, 0.0f), 1.0f);
+    *r = SkNf::Min(SkNf::Max(R, 0.0f), *a);
+    *g = SkNf::Min(SkNf::Max(G, 0.0f), *a);
+    *b = SkNf::Min(SkNf::Max(B, 0.0f), *a);
+}
+
+#define SAMPLER_STAGES(fmt, Read)                                                         \
+    STAGE(gather_##fmt, true) {                                                          \
+        sample_nearest<Read>((const SkRasterPipeline::ImageCtx*)ctx, &r,&g,&b,&a);       \
+    }                                                                                    \
+    STAGE(bilinear_##fmt, true) {                                                        \
+        sample_bilinear<Read>((const SkRasterPipeline::ImageCtx*)ctx, &r,&g,&b,&a);      \
+    }                                                                                    \
+    STAGE(bicubic_##fmt, true) {                                                         \
+        sample_bicubic<Read>((const SkRasterPipeline::ImageCtx*)ctx, &r,&g,&b,&a);       \
+    }
+
+SAMPLER_STAGES(8888, Read8888)
+SAMPLER_STAGES(srgb, ReadSRGB)
+SAMPLER_STAGES(565,  Read565)
+SAMPLER_STAGES(f16,  ReadF16)
+#undef SAMPLER_STAGES
+
+// Gradients first map x,y to t in r, then tile t into [0,1] with {clamp,repeat,mirror}_x.
+
+STAGE(xy_to_radius, true) {
+    r = (r*r + g*g).sqrt();
+}
+
+// t is the angle from the +x axis, in [0,1) turns.
+STAGE(xy_to_angle, true) {
+    SkNf ax = r.abs(),
+         ay = g.abs(),
+         mn = SkNf::Min(ax, ay),
+         mx = SkNf::Max(ax, ay),
+         s  = (mx > 0.0f).thenElse(mn / mx, 0.0f),
+         s2 = s*s;
+
+    // A polynomial approximation of atan(s) for s in [0,1], good to about 1e-5 radians.
+    SkNf phi = s * mad(s2, mad(s2, mad(s2, mad(s2, mad(s2,
+                                SkNf(-0.01172120f), SkNf( 0.05265332f)),
+                                                    SkNf(-0.11643287f)),
+                                                    SkNf( 0.19354346f)),
+                                                    SkNf(-0.33262347f)),
+                                                    SkNf( 0.99997726f));
+    phi = (ay > ax ).thenElse(SK_ScalarPI/2 - phi, phi);
+    phi = (r < 0.0f).thenElse(SK_ScalarPI   - phi, phi);
+    phi = (g < 0.0f).thenElse(SK_ScalarPI*2 - phi, phi);
+    r = phi * (1 / (2*SK_ScalarPI));
+}
+
+// Solves for the largest t (or smallest if flipped) where x,y is on the circle interpolated
+// between the start and end circles, with a non-negative radius.  Where there's no such t, we
+// write t = 0, and leave a 0 in da for mask_2pt_conical_degenerates; otherwise da is 1.
+STAGE(xy_to_2pt_conical, true) {
+    auto c = (const SkRasterPipeline::TwoPointConicalCtx*)ctx;
+
+    float A = c->dCenterX*c->dCenterX + c->dCenterY*c->dCenterY - c->dRadius*c->dRadius;
+
+    SkNf dx = r - c->centerX,
+         dy = g - c->centerY,
+         B  = -2.0f * mad(dx, c->dCenterX, mad(dy, c->dCenterY, c->radius*c->dRadius)),
+         C  = mad(dx, dx, mad(dy, dy, -c->radius*c->radius));
+
+    SkNf t, valid;
+    if (A == 0) {
+        t     = C / (0.0f - B);
+        valid = (B != 0.0f).thenElse(1.0f, 0.0f);
+    } else {
+        SkNf disc = B*B - 4.0f*A*C,
+             root = SkNf::Max(disc, 0.0f).sqrt(),
+             t0   = (root - B) * (0.5f/A),
+             t1   = (0.0f - B - root) * (0.5f/A),
+             hi   = SkNf::Max(t0, t1),
+             lo   = SkNf::Min(t0, t1),
+             pick = c->flipped ? lo : hi,
+             alt  = c->flipped ? hi : lo;
+        t     = (mad(pick, c->dRadius, c->radius) >= 0.0f).thenElse(pick, alt);
+        valid = (disc >= 0.0f).thenElse(1.0f, 0.0f);
+    }
+    valid = (mad(t, c->dRadius, c->radius) >= 0.0f).thenElse(valid, 0.0f);
+
+    r  = (valid > 0.0f).thenElse(t, 0.0f);
+    da = valid;
+}
+
+STAGE(mask_2pt_conical_degenerates, true) {
+    r *= da;
+    g *= da;
+    b *= da;
+    a *= da;
+}
+
+STAGE(gradient, true) {
+    auto c = (const SkRasterPipeline::GradientCtx*)ctx;
+
+    // Walk up the intervals, picking up each one's f and b where t has reached it.
+    // This stays in vector registers, and is robust to t outside [0,1].
+    SkNf t = r;
+    SkNf f[4], bias[4];
+    for (int j = 0; j < 4; j++) {
+        f[j]    = c->fs[j];
+        bias[j] = c->bs[j];
+    }
+    for (int i = 1; i < c->stopCount; i++) {
+        auto reached = t >= c->ts[i];
+        for (int j = 0; j < 4; j++) {
+            f[j]    = reached.thenElse(c->fs[4*i+j], f[j]);
+            bias[j] = reached.thenElse(c->bs[4*i+j], bias[j]);
+        }
+    }
+
+    r = mad(t, f[0], bias[0]);
+    g = mad(t, f[1], bias[1]);
+    b = mad(t, f[2], bias[2]);
+    a = mad(t, f[3], bias[3]);
+}
+
+STAGE(gradient_2stops, true) {
+    auto c = (const SkRasterPipeline::TwoStopGradientCtx*)ctx;
+
+    SkNf t = r;
+    r = mad(t, c->f[0], c->b[0]);
+    g = mad(t, c->f[1], c->b[1]);
+    b = mad(t, c->f[2], c->b[2]);
+    a = mad(t, c->f[3], c->b[3]);
+}
+
+
 template <typename Fn>
 SI Fn enum_to_Fn(SkRasterPipeline::StockStage st) {
     switch (st) {
@@ -456,10 +950,394 @@ SI Fn enum_to_Fn(SkRasterPipeline::StockStage st) {
     return just_return;
 }
 
+// Low precision: pipelines on legacy 8888 need no more than 8-bit precision, and can run with
+// each channel as a 16-bit 0-255 value, eight pixels to a 128-bit register.  If every stage of a
+// pipeline has a lowp version here, compile_pipeline() runs the lowp version instead.  Stage
+// contexts are the same as for the float stages.
+//
+// With AVX2 the float stages already work on eight pixels at a time, and mixing 128-bit lowp
+// registers with 256-bit code costs a vzeroupper per stage, so there we stick to float.
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+
+#define SK_RASTER_PIPELINE_LOWP_STAGES(M)         \
+    M(swap_src_dst) M(constant_color)             \
+    M(load_s_8888) M(load_d_8888) M(store_8888)   \
+    M(scale_u8) M(lerp_u8) M(lerp_constant_float) \
+    M(clear) M(modulate) M(srcover)
+
+namespace {
+
+    static constexpr int kLowpN = 8;
+    using SkNu16 = SkNx<kLowpN, uint16_t>;
+
+    struct LowpStage;
+    using Lowp = void(SK_VECTORCALL *)(LowpStage*, size_t, size_t, SkNu16,SkNu16,SkNu16,SkNu16,
+                                                                   SkNu16,SkNu16,SkNu16,SkNu16);
+    struct LowpStage { Lowp next; void* ctx; };
+
+}  // namespace
+
+SI void SK_VECTORCALL lowp_just_return(LowpStage*, size_t, size_t, SkNu16,SkNu16,SkNu16,SkNu16,
+                                                                   SkNu16,SkNu16,SkNu16,SkNu16) {}
+
+// Lowp stages handle the tail (tail > 0) at runtime rather than with separate body and tail
+// functions.
+#define LOWP_STAGE(name, kCallNext)                                                          \
+    static SK_ALWAYS_INLINE void lowp_##name##_kernel(void* ctx, size_t x, size_t tail,      \
+                                                      SkNu16&  r, SkNu16&  g,                \
+                                                      SkNu16&  b, SkNu16&  a,                \
+                                                      SkNu16& dr, SkNu16& dg,                \
+                                                      SkNu16& db, SkNu16& da);               \
+    SI void SK_VECTORCALL lowp_##name(LowpStage* st, size_t x, size_t tail,                  \
+                                      SkNu16  r, SkNu16  g, SkNu16  b, SkNu16  a,            \
+                                      SkNu16 dr, SkNu16 dg, SkNu16 db, SkNu16 da) {          \
+        lowp_##name##_kernel(st->ctx, x,tail, r,g,b,a, dr,dg,db,da);                         \
+        if (kCallNext) {                                                                     \
+            st->next(st+1, x,tail, r,g,b,a, dr,dg,db,da);                                    \
+        }                                                                                    \
+    }                                                                                        \
+    static SK_ALWAYS_INLINE void lowp_##name##_kernel(void* ctx, size_t x, size_t tail,      \
+                                                      SkNu16&  r, SkNu16&  g,                \
+                                                      SkNu16&  b, SkNu16&  a,                \
+                                                      SkNu16& dr, SkNu16& dg,                \
+                                                      SkNu16& db, SkNu16& da)
+
+// v/255, rounded to nearest, exact for all v in [0, 255*255].
+SI SkNu16 div255(const SkNu16& v) {
+    auto w = v + 128;
+    return (w + (w >> 8)) >> 8;
+}
+
+SI SkNu16 inv(const SkNu16& x) { return SkNu16(255) - x; }
+
+SI SkNu16 lerp(const SkNu16& from, const SkNu16& to, const SkNu16& cov) {
+    return div255(to*cov + from*inv(cov));
+}
+
+// Tails go through a full-size buffer so the loads and stores below can always be full width.
+template <typename T>
+SI const T* lowp_tail_src(size_t tail, const T* src, T buf[kLowpN]) {
+    if (!tail) {
+        return src;
+    }
+    memset(buf, 0, kLowpN*sizeof(T));
+    memcpy(buf, src, tail*sizeof(T));
+    return buf;
+}
+
+SI SkNu16 lowp_load_u8(size_t tail, const uint8_t* src) {
+    uint8_t buf[kLowpN];
+    src = lowp_tail_src(tail, src, buf);
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src), _mm_setzero_si128());
+#else
+    uint16_t wide[kLowpN];
+    for (int i = 0; i < kLowpN; i++) {
+        wide[i] = src[i];
+    }
+    return SkNu16::Load(wide);
+#endif
+}
+
+SI void lowp_load_8888(size_t tail, const uint32_t* src,
+                       SkNu16* r, SkNu16* g, SkNu16* b, SkNu16* a) {
+    uint32_t buf[kLowpN];
+    src = lowp_tail_src(tail, src, buf);
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    __m128i lo = _mm_loadu_si128((const __m128i*)src + 0),
+            hi = _mm_loadu_si128((const __m128i*)src + 1);
+    // Each channel fits in 0-255, so a signed saturating pack is just a pack.
+    auto channel = [&](int shift) -> SkNu16 {
+        const __m128i mask = _mm_set1_epi32(0xff);
+        return _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, shift), mask),
+                               _mm_and_si128(_mm_srli_epi32(hi, shift), mask));
+    };
+    *r = channel(SK_R32_SHIFT);
+    *g = channel(SK_G32_SHIFT);
+    *b = channel(SK_B32_SHIFT);
+    *a = channel(SK_A32_SHIFT);
+#else
+    uint16_t rs[kLowpN], gs[kLowpN], bs[kLowpN], as[kLowpN];
+    for (int i = 0; i < kLowpN; i++) {
+        rs[i] = (src[i] >> SK_R32_SHIFT) & 0xff;
+        gs[i] = (src[i] >> SK_G32_SHIFT) & 0xff;
+        bs[i] = (src[i] >> SK_B32_SHIFT) & 0xff;
+        as[i] = (src[i] >> SK_A32_SHIFT) & 0xff;
+    }
+    *r = SkNu16::Load(rs);
+    *g = SkNu16::Load(gs);
+    *b = SkNu16::Load(bs);
+    *a = SkNu16::Load(as);
+#endif
+}
+
+SI void lowp_store_8888(size_t tail, uint32_t* dst,
+                        const SkNu16& r, const SkNu16& g, const SkNu16& b, const SkNu16& a) {
+    uint32_t buf[kLowpN];
+    uint32_t* px = tail ? buf : dst;
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    auto lo = [](const SkNu16& v, int shift) {
+        return _mm_slli_epi32(_mm_unpacklo_epi16(v.fVec, _mm_setzero_si128()), shift);
+    };
+    auto hi = [](const SkNu16& v, int shift) {
+        return _mm_slli_epi32(_mm_unpackhi_epi16(v.fVec, _mm_setzero_si128()), shift);
+    };
+    _mm_storeu_si128((__m128i*)px + 0, _mm_or_si128(_mm_or_si128(lo(r, SK_R32_SHIFT),
+                                                                 lo(g, SK_G32_SHIFT)),
+                                                    _mm_or_si128(lo(b, SK_B32_SHIFT),
+                                                                 lo(a, SK_A32_SHIFT))));
+    _mm_storeu_si128((__m128i*)px + 1, _mm_or_si128(_mm_or_si128(hi(r, SK_R32_SHIFT),
+                                                                 hi(g, SK_G32_SHIFT)),
+                                                    _mm_or_si128(hi(b, SK_B32_SHIFT),
+                                                                 hi(a, SK_A32_SHIFT))));
+#else
+    for (int i = 0; i < kLowpN; i++) {
+        px[i] = (uint32_t)r[i] << SK_R32_SHIFT
+              | (uint32_t)g[i] << SK_G32_SHIFT
+              | (uint32_t)b[i] << SK_B32_SHIFT
+              | (uint32_t)a[i] << SK_A32_SHIFT;
+    }
+#endif
+    if (tail) {
+        memcpy(dst, buf, tail*sizeof(uint32_t));
+    }
+}
+
+LOWP_STAGE(swap_src_dst, true) {
+    SkTSwap(r,dr);
+    SkTSwap(g,dg);
+    SkTSwap(b,db);
+    SkTSwap(a,da);
+}
+
+LOWP_STAGE(constant_color, true) {
+    auto color = (const SkPM4f*)ctx;
+    auto to_u16 = [](float f) { return SkNu16((uint16_t)(f * 255 + 0.5f)); };
+    r = to_u16(color->r());
+    g = to_u16(color->g());
+    b = to_u16(color->b());
+    a = to_u16(color->a());
+}
+
+LOWP_STAGE(load_d_8888, true) {
+    lowp_load_8888(tail, *(const uint32_t**)ctx + x, &dr,&dg,&db,&da);
+}
+
+LOWP_STAGE(load_s_8888, true) {
+    lowp_load_8888(tail, *(const uint32_t**)ctx + x, &r,&g,&b,&a);
+}
+
+LOWP_STAGE(store_8888, false) {
+    lowp_store_8888(tail, *(uint32_t**)ctx + x, r,g,b,a);
+}
+
+LOWP_STAGE(scale_u8, true) {
+    SkNu16 c = lowp_load_u8(tail, *(const uint8_t**)ctx + x);
+    r = div255(r*c);
+    g = div255(g*c);
+    b = div255(b*c);
+    a = div255(a*c);
+}
+
+LOWP_STAGE(lerp_u8, true) {
+    SkNu16 c = lowp_load_u8(tail, *(const uint8_t**)ctx + x);
+    r = lerp(dr, r, c);
+    g = lerp(dg, g, c);
+    b = lerp(db, b, c);
+    a = lerp(da, a, c);
+}
+
+LOWP_STAGE(lerp_constant_float, true) {
+    SkNu16 c = (uint16_t)(*(const float*)ctx * 255 + 0.5f);
+    r = lerp(dr, r, c);
+    g = lerp(dg, g, c);
+    b = lerp(db, b, c);
+    a = lerp(da, a, c);
+}
+
+LOWP_STAGE(clear, true) {
+    r = g = b = a = 0;
+}
+
+LOWP_STAGE(modulate, true) {
+    r = div255(r*dr);
+    g = div255(g*dg);
+    b = div255(b*db);
+    a = div255(a*da);
+}
+
+LOWP_STAGE(srcover, true) {
+    r = r + div255(dr*inv(a));
+    g = g + div255(dg*inv(a));
+    b = b + div255(db*inv(a));
+    a = a + div255(da*inv(a));
+}
+
+// Returns nullptr if there's no lowp version of this stage.
+SI Lowp enum_to_lowp(SkRasterPipeline::StockStage st) {
+    switch (st) {
+    #define M(stage) case SkRasterPipeline::stage: return lowp_##stage;
+        SK_RASTER_PIPELINE_LOWP_STAGES(M)
+    #undef M
+        default: return nullptr;
+    }
+}
+
+SI bool lowp_pipeline(const SkRasterPipeline::Stage* stages, int nstages,
+                      std::function<void(size_t, size_t)>* fn) {
+    if (nstages == 0) {
+        return false;
+    }
+    for (int i = 0; i < nstages; i++) {
+        if (!enum_to_lowp(stages[i].stage)) {
+            return false;
+        }
+    }
+
+    struct Compiled {
+        void operator()(size_t x, size_t n) {
+            SkNu16 v;  // Fastest to start uninitialized.
+
+            while (n >= kLowpN) {
+                fStart(fStages, x,0, v,v,v,v, v,v,v,v);
+                x += kLowpN;
+                n -= kLowpN;
+            }
+            if (n) {
+                fStart(fStages, x,n, v,v,v,v, v,v,v,v);
+            }
+        }
+
+        Lowp      fStart;
+        LowpStage fStages[SkRasterPipeline::kMaxStages];
+    } compiled;
+
+    compiled.fStart = enum_to_lowp(stages[0].stage);
+    for (int i = 0; i < nstages-1; i++) {
+        compiled.fStages[i].next = enum_to_lowp(stages[i+1].stage);
+        compiled.fStages[i].ctx  = stages[i].ctx;
+    }
+    compiled.fStages[nstages-1].next = lowp_just_return;
+    compiled.fStages[nstages-1].ctx  = stages[nstages-1].ctx;
+
+    *fn = compiled;
+    return true;
+}
+#endif//SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+
+// A few pipelines show up all the time, and are short enough that calling from stage to stage
+// through function pointers dominates their cost.  For these we instantiate the whole chain as
+// one loop at compile time, letting all the stage kernels inline into each other.
+template <typename S>
+static constexpr bool only_last_stage_returns() { return true; }
+
+template <typename S0, typename S1, typename... Rest>
+static constexpr bool only_last_stage_returns() {
+    return S0::kCallsNext && only_last_stage_returns<S1, Rest...>();
+}
+
+namespace {
+
+template <typename... Stages>
+struct Fused {
+    static_assert(only_last_stage_returns<Stages...>(), "Only the last fused stage may return.");
+    static const int kNumStages = sizeof...(Stages);
+
+    static bool Matches(const SkRasterPipeline::Stage* stages, int nstages) {
+        static const SkRasterPipeline::StockStage kStages[] = { Stages::kStage... };
+        if (nstages != kNumStages) {
+            return false;
+        }
+        for (int i = 0; i < nstages; i++) {
+            if (stages[i].stage != kStages[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    explicit Fused(const SkRasterPipeline::Stage* stages) {
+        for (int i = 0; i < kNumStages; i++) {
+            fCtx[i] = stages[i].ctx;
+        }
+    }
+
+    template <bool kIsTail>
+    SK_ALWAYS_INLINE void run(size_t x, size_t tail) {
+        SkNf r,g,b,a, dr,dg,db,da;  // Fastest to start uninitialized.
+        void** ctx = fCtx;
+        // Braced initializer lists are evaluated in order, so this runs each stage in turn.
+        using expand = int[];
+        (void)expand{ (Stages::template Run<kIsTail>(*ctx++, x,tail, r,g,b,a, dr,dg,db,da), 0)... };
+    }
+
+    void operator()(size_t x, size_t n) {
+        while (n >= N) {
+            this->run<false>(x,0);
+            x += N;
+            n -= N;
+        }
+        if (n) {
+            this->run<true>(x,n);
+        }
+    }
+
+    void* fCtx[kNumStages];
+};
+
+}  // namespace
+
+template <typename... Stages>
+SI bool try_fuse(const SkRasterPipeline::Stage* stages, int nstages,
+                 std::function<void(size_t, size_t)>* fn) {
+    if (!Fused<Stages...>::Matches(stages, nstages)) {
+        return false;
+    }
+    *fn = Fused<Stages...>(stages);
+    return true;
+}
+
+SI bool fuse_pipeline(const SkRasterPipeline::Stage* stages, int nstages,
+                      std::function<void(size_t, size_t)>* fn) {
+#define F(stage) stage##_fused
+    // SkRasterPipelineBlitter drawing a solid color with srcover: blitH(), blitAntiH(), and
+    // blitMask() with A8 or LCD16 masks.
+#define SOLID_SRCOVER(load_d, store)                                                  \
+       try_fuse<F(constant_color), F(load_d), F(srcover),                             \
+                F(store)>(stages, nstages, fn)                                        \
+    || try_fuse<F(constant_color), F(load_d), F(srcover),                             \
+                F(lerp_constant_float), F(store)>(stages, nstages, fn)                \
+    || try_fuse<F(constant_color), F(load_d), F(srcover),                             \
+                F(lerp_u8), F(store)>(stages, nstages, fn)                            \
+    || try_fuse<F(constant_color), F(load_d), F(srcover),                             \
+                F(lerp_565), F(store)>(stages, nstages, fn)
+
+    return SOLID_SRCOVER(load_d_srgb, store_srgb)
+        || SOLID_SRCOVER(load_d_f16,  store_f16)
+        || SOLID_SRCOVER(load_d_565,  store_565)
+        // An sRGB source, scaled by 8-bit coverage, srcover onto the destination.
+        || try_fuse<F(load_s_srgb), F(scale_u8), F(load_d_srgb), F(srcover), F(store_srgb)>(
+                   stages, nstages, fn)
+        || try_fuse<F(load_s_srgb), F(scale_u8), F(load_d_f16), F(srcover), F(store_f16)>(
+                   stages, nstages, fn);
+#undef SOLID_SRCOVER
+#undef F
+}
+
 namespace SK_OPTS_NS {
 
     SI std::function<void(size_t, size_t)> compile_pipeline(const SkRasterPipeline::Stage* stages,
-                                                            int nstages) {
+                                                            int nstages, bool fuse) {
+        std::function<void(size_t, size_t)> specialized;
+        if (fuse && fuse_pipeline(stages, nstages, &specialized)) {
+            return specialized;
+        }
+    #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+        if (lowp_pipeline(stages, nstages, &specialized)) {
+            return specialized;
+        }
+    #endif
+
         struct Compiled {
             Compiled(const SkRasterPipeline::Stage* stages, int nstages) {
                 if (nstages == 0) {
@@ -507,5 +1385,6 @@ namespace SK_OPTS_NS {
 #undef STAGE
 #undef RGBA_XFERMODE
 #undef RGB_XFERMODE
+#undef LOWP_STAGE
 
 #endif//SkRasterPipeline_opts_DEFINED
@@ -7,6 +7,7 @@
 
 #include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkCodecFrameCache.h"
 #include "SkStream.h"
 
 #include "Resources.h"
@@ -140,3 +141,54 @@ DEF_TEST(Codec_frames, r) {
         }
     }
 }
+
+// Playing frames back through SkCodecFrameCache should match decoding each one on its own, and
+// should only decode each frame once when played in order.
+DEF_TEST(Codec_frameCache, r) {
+    const char* name = "test640x479.gif";
+    std::unique_ptr<SkStream> stream(GetResourceAsStream(name));
+    if (!stream) {
+        return;
+    }
+    SkCodec* codec = SkCodec::NewFromStream(stream.release());
+    if (!codec) {
+        ERRORF(r, "Failed to create an SkCodec from '%s'", name);
+        return;
+    }
+    const auto info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkCodecFrameCache cache(codec, info, 2);
+    const int frameCount = cache.frameCount();
+    REPORTER_ASSERT(r, 4 == frameCount);
+
+    std::unique_ptr<SkCodec> reference(SkCodec::NewFromStream(GetResourceAsStream(name)));
+    for (int loop = 0; loop < 2; loop++) {
+        for (int i = 0; i < frameCount; i++) {
+            SkBitmap cached;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == cache.getFrame(i, &cached));
+            REPORTER_ASSERT(r, cached.isImmutable());
+
+            SkBitmap expected;
+            expected.allocPixels(info);
+            SkCodec::Options opts;
+            opts.fFrameIndex = i;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == reference->getPixels(info,
+                    expected.getPixels(), expected.rowBytes(), &opts, nullptr, nullptr));
+            for (int y = 0; y < info.height(); y++) {
+                if (memcmp(cached.getAddr(0, y), expected.getAddr(0, y),
+                           info.minRowBytes()) != 0) {
+                    ERRORF(r, "%s's frame %i differs when cached!", name, i);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Only the very first request has to wait on a decode; each later frame is prefetched
+    // while the one before it is shown.
+    REPORTER_ASSERT(r, 1 == cache.missCount());
+    REPORTER_ASSERT(r, 2 * frameCount - 1 == cache.hitCount());
+    REPORTER_ASSERT(r, cache.prefetchCount() >= 2 * frameCount - 1);
+
+    SkBitmap bm;
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters == cache.getFrame(frameCount, &bm));
+}
@@ -8,11 +8,13 @@
 #include "Resources.h"
 #include "SkAndroidCodec.h"
 #include "SkBitmap.h"
+#include "SkBitmapScaler.h"
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
 #include "SkColorSpace_XYZ.h"
 #include "SkData.h"
 #include "SkImageEncoder.h"
+#include "SkJpegCodec.h"
 #include "SkFrontBufferedStream.h"
 #include "SkMD5.h"
 #include "SkRandom.h"
@@ -1440,3 +1442,130 @@ DEF_TEST(Codec_InvalidImages, r) {
     test_invalid_images(r, "invalid_images/int_overflow.ico", false);
     test_invalid_images(r, "invalid_images/skbug5887.gif", true);
 }
+
+// icc-v2-gbr.jpg has a restart marker after every MCU row, so it can be decoded from the middle.
+DEF_TEST(Codec_jpeg_restartIndex, r) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(GetResourcePath("icc-v2-gbr.jpg").c_str());
+    if (!data) {
+        return;
+    }
+
+    // Decode the whole image one scanline after another, without skipping.
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info));
+    REPORTER_ASSERT(r, info.height() == codec->getScanlines(expected.getPixels(), info.height(),
+                                                            expected.rowBytes()));
+
+    sk_sp<SkData> index = static_cast<SkJpegCodec*>(codec.get())->getRestartIndex();
+    REPORTER_ASSERT(r, index);
+
+    // Skipping jumps ahead to the nearest stripe, and must land on the same pixels.
+    const int kRows = 10;
+    for (int start : { 3, 17, 40, 100, info.height() - kRows }) {
+        SkAutoTDelete<SkCodec> skipper(SkCodec::NewFromData(data));
+        REPORTER_ASSERT(r, static_cast<SkJpegCodec*>(skipper.get())->setRestartIndex(*index));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == skipper->startScanlineDecode(info));
+        REPORTER_ASSERT(r, skipper->skipScanlines(start));
+
+        SkBitmap actual;
+        actual.allocPixels(info.makeWH(info.width(), kRows));
+        REPORTER_ASSERT(r, kRows == skipper->getScanlines(actual.getPixels(), kRows,
+                                                          actual.rowBytes()));
+        REPORTER_ASSERT(r, 0 == memcmp(actual.getPixels(), expected.getAddr(0, start),
+                                       actual.getSize()));
+    }
+
+    // Indices only fit the image they were made for, and not every image can be indexed.
+    sk_sp<SkData> other =
+            SkData::MakeFromFileName(GetResourcePath("mandrill_512_q075.jpg").c_str());
+    SkAutoTDelete<SkCodec> otherCodec(SkCodec::NewFromData(other));
+    REPORTER_ASSERT(r, !static_cast<SkJpegCodec*>(otherCodec.get())->getRestartIndex());
+    REPORTER_ASSERT(r, !static_cast<SkJpegCodec*>(otherCodec.get())->setRestartIndex(*index));
+}
+
+// Tall enough images are decoded by getPixels() in stripes, in parallel, and must come out just
+// as they would decoded one scanline after another, at full size or scaled in the DCT.
+DEF_TEST(Codec_jpeg_stripes, r) {
+    // 96x1030, with a restart marker after each 16 row MCU row: 65 stripes, the last one short,
+    // which getPixels() splits among three tasks.
+    sk_sp<SkData> data =
+            SkData::MakeFromFileName(GetResourcePath("restart-markers-tall.jpg").c_str());
+    if (!data) {
+        return;
+    }
+
+    for (float scale : { 1.0f, 0.5f, 0.25f }) {
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+        REPORTER_ASSERT(r, static_cast<SkJpegCodec*>(codec.get())->getRestartIndex());
+        const SkISize size = codec->getScaledDimensions(scale);
+        const SkImageInfo info = codec->getInfo().makeWH(size.width(), size.height())
+                                                 .makeColorType(kN32_SkColorType);
+
+        SkBitmap expected;
+        expected.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(info));
+        REPORTER_ASSERT(r, info.height() == codec->getScanlines(expected.getPixels(),
+                                                                info.height(),
+                                                                expected.rowBytes()));
+
+        SkAutoTDelete<SkCodec> striped(SkCodec::NewFromData(data));
+        SkBitmap actual;
+        actual.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == striped->getPixels(info, actual.getPixels(),
+                                                                   actual.rowBytes()));
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSize()));
+    }
+}
+
+// Sample sizes that libjpeg-turbo can't do on its own are scaled partly in the DCT domain and
+// then resampled, which should look like resampling a full decode.
+DEF_TEST(Codec_jpeg_dctScaledSample, r) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(GetResourcePath("mandrill_512_q075.jpg").c_str());
+    if (!data) {
+        return;
+    }
+
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    SkBitmap full;
+    full.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(full.info(), full.getPixels(),
+                                                             full.rowBytes()));
+    SkPixmap fullPixmap;
+    REPORTER_ASSERT(r, full.peekPixels(&fullPixmap));
+
+    for (int sampleSize : { 3, 5, 6, 12 }) {
+        SkAutoTDelete<SkAndroidCodec> androidCodec(SkAndroidCodec::NewFromData(data));
+        const SkISize size = androidCodec->getSampledDimensions(sampleSize);
+        SkBitmap actual;
+        actual.allocPixels(full.info().makeWH(size.width(), size.height()));
+        SkAndroidCodec::AndroidOptions opts;
+        opts.fSampleSize = sampleSize;
+        REPORTER_ASSERT(r, SkCodec::kSuccess == androidCodec->getAndroidPixels(actual.info(),
+                actual.getPixels(), actual.rowBytes(), &opts));
+
+        SkBitmap expected;
+        REPORTER_ASSERT(r, SkBitmapScaler::Resize(&expected, fullPixmap,
+                                                  SkBitmapScaler::RESIZE_MITCHELL,
+                                                  size.width(), size.height()));
+
+        // The DCT scaling filters differently than SkBitmapScaler, so individual pixels may
+        // differ, but not by much on average.  Sampling misses by about 16 here.
+        int64_t totalDiff = 0;
+        for (int y = 0; y < size.height(); y++) {
+            for (int x = 0; x < size.width(); x++) {
+                const SkPMColor a = *actual.getAddr32(x, y),
+                                e = *expected.getAddr32(x, y);
+                for (int shift : { SK_R32_SHIFT, SK_G32_SHIFT, SK_B32_SHIFT }) {
+                    totalDiff += SkTAbs((int) ((a >> shift) & 0xFF) -
+                                        (int) ((e >> shift) & 0xFF));
+                }
+            }
+        }
+        const double meanDiff = (double) totalDiff / (3 * size.width() * size.height());
+        REPORTER_ASSERT(r, meanDiff < 4.0);
+    }
+}
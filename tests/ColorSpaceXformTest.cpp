@@ -25,6 +25,11 @@ public:
         // Use special testing entry point, so we don't skip the xform, even though src == dst.
         return SlowIdentityXform(static_cast<SkColorSpace_XYZ*>(space.get()));
     }
+
+    static sk_sp<SkColorSpace> CreateSpace(const sk_sp<SkGammas>& gammas) {
+        return sk_sp<SkColorSpace>(new SkColorSpace_XYZ(
+                kNonStandard_SkGammaNamed, gammas, SkMatrix::I(), nullptr));
+    }
 };
 
 static bool almost_equal(int x, int y) {
@@ -176,3 +181,70 @@ DEF_TEST(ColorSpaceXform_NonMatchingGamma, r) {
     test_identity_xform(r, gammas, true);
 }
 
+
+static void test_rgb_888_src(skiatest::Reporter* r, SkColorSpace* src, SkColorSpace* dst) {
+    std::unique_ptr<SkColorSpaceXform> xform = SkColorSpaceXform::New(src, dst);
+    REPORTER_ASSERT(r, xform);
+
+    // Arbitrary set of 13 pixels, so that we use both the 4-pixel and the 1-pixel loads.
+    constexpr int width = 13;
+    constexpr uint32_t rgbaPixels[width] = {
+            0xFFABCDEF, 0xFF146829, 0xFF382759, 0xFF184968, 0xFFDE8271,
+            0xFF32AB52, 0xFF0383BC, 0xFF000102, 0xFFFFFFFF, 0xFFDDEEFF,
+            0xFF000000, 0xFF7F7F80, 0xFF102030, };
+    uint8_t rgbPixels[3 * width];
+    for (int i = 0; i < width; i++) {
+        rgbPixels[3*i + 0] = (rgbaPixels[i] >>  0) & 0xFF;
+        rgbPixels[3*i + 1] = (rgbaPixels[i] >>  8) & 0xFF;
+        rgbPixels[3*i + 2] = (rgbaPixels[i] >> 16) & 0xFF;
+    }
+
+    // Opaque RGB pixels should xform exactly like their RGBA equivalents.
+    const SkColorSpaceXform::ColorFormat dstFormats[] = {
+            SkColorSpaceXform::kRGBA_8888_ColorFormat,
+            SkColorSpaceXform::kBGRA_8888_ColorFormat,
+            SkColorSpaceXform::kRGBA_F16_ColorFormat,
+    };
+    const SkAlphaType alphaTypes[] = {
+            kOpaque_SkAlphaType, kPremul_SkAlphaType, kUnpremul_SkAlphaType,
+    };
+    for (SkColorSpaceXform::ColorFormat dstFormat : dstFormats) {
+        for (SkAlphaType alphaType : alphaTypes) {
+            uint64_t expected[width], actual[width];
+            bool expectedResult = xform->apply(dstFormat, expected,
+                    SkColorSpaceXform::kRGBA_8888_ColorFormat, rgbaPixels, width, alphaType);
+            bool actualResult = xform->apply(dstFormat, actual,
+                    SkColorSpaceXform::kRGB_888_ColorFormat, rgbPixels, width, alphaType);
+            REPORTER_ASSERT(r, expectedResult == actualResult);
+            if (expectedResult) {
+                size_t bytes = width * (SkColorSpaceXform::kRGBA_F16_ColorFormat == dstFormat ?
+                        sizeof(uint64_t) : sizeof(uint32_t));
+                REPORTER_ASSERT(r, !memcmp(expected, actual, bytes));
+            }
+        }
+    }
+
+    // RGB_888 is not supported as a dst format.
+    uint32_t unused[width];
+    REPORTER_ASSERT(r, !xform->apply(SkColorSpaceXform::kRGB_888_ColorFormat, unused,
+                                     SkColorSpaceXform::kRGBA_8888_ColorFormat, rgbaPixels, width,
+                                     kOpaque_SkAlphaType));
+}
+
+DEF_TEST(ColorSpaceXform_RGB888Src, r) {
+    sk_sp<SkColorSpace> srgb = SkColorSpace::MakeNamed(SkColorSpace::kSRGB_Named);
+    sk_sp<SkColorSpace> adobe = SkColorSpace::MakeNamed(SkColorSpace::kAdobeRGB_Named);
+    sk_sp<SkColorSpace> linear = SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named);
+
+    test_rgb_888_src(r, adobe.get(), srgb.get());
+    test_rgb_888_src(r, adobe.get(), linear.get());
+    test_rgb_888_src(r, srgb.get(), srgb.get());
+
+    // Exercise the table-based loads.
+    sk_sp<SkGammas> gammas = sk_sp<SkGammas>(new SkGammas());
+    gammas->fRedType = gammas->fGreenType = gammas->fBlueType = SkGammas::Type::kValue_Type;
+    gammas->fRedData.fValue = gammas->fGreenData.fValue = gammas->fBlueData.fValue = 1.4f;
+    sk_sp<SkColorSpace> table = ColorSpaceXformTest::CreateSpace(gammas);
+    test_rgb_888_src(r, table.get(), srgb.get());
+    test_rgb_888_src(r, table.get(), linear.get());
+}
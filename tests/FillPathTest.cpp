@@ -5,10 +5,19 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkGraphics.h"
+#include "SkImagePriv.h"
+#include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkScan.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 
 struct FakeBlitter : public SkBlitter {
@@ -46,3 +55,326 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+struct SpanCountingBlitter : public SkBlitter {
+    void blitH(int x, int y, int width) override {
+        fBlitHCount++;
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+      SkDEBUGFAIL("blitAntiH not implemented");
+    }
+
+    void blitSpans(const Span spans[], int count) override {
+        fBlitSpansCount++;
+        fSpanCount += count;
+        this->INHERITED::blitSpans(spans, count);
+    }
+
+    int fBlitHCount     = 0;
+    int fBlitSpansCount = 0;
+    int fSpanCount      = 0;
+
+    typedef SkBlitter INHERITED;
+};
+
+// The scan converter should hand its spans over in batches, not one virtual call at a time.
+DEF_TEST(FillPathBatchesSpans, reporter) {
+    SpanCountingBlitter blitter;
+    SkPath path;
+    path.addCircle(50, 50, 40);
+    SkScan::FillPath(path, SkIRect::MakeWH(100, 100), &blitter);
+
+    REPORTER_ASSERT(reporter, blitter.fSpanCount == 80);
+    REPORTER_ASSERT(reporter, blitter.fBlitHCount == blitter.fSpanCount);
+    REPORTER_ASSERT(reporter, blitter.fBlitSpansCount > 0);
+    REPORTER_ASSERT(reporter, blitter.fBlitSpansCount * 8 < blitter.fSpanCount);
+}
+
+// Each blitter's blitSpans() should draw the same as SkBlitter's default blitH()/blitAntiH().
+DEF_TEST(BlitSpans, reporter) {
+    const SkBlitter::Span spans[] = {
+        {  0, 0, 17, 0xFF },
+        {  3, 1,  1, 0x40 },
+        {  5, 1, 70, 0x80 },
+        { 80, 1,  3, 0x00 },
+        {  0, 2, 99, 0xC0 },
+        { 98, 3,  2, 0xFF },
+    };
+
+    for (SkColorType ct : { kN32_SkColorType, kAlpha_8_SkColorType, kRGBA_F16_SkColorType }) {
+        for (U8CPU alpha : { 0xFF, 0x80 }) {
+            SkBitmap batched, reference;
+            SkImageInfo info = SkImageInfo::Make(100, 4, ct, kPremul_SkAlphaType);
+            batched.allocPixels(info);
+            reference.allocPixels(info);
+            memset(batched.getPixels(),   0x33, batched.getSize());
+            memset(reference.getPixels(), 0x33, reference.getSize());
+
+            SkPaint paint;
+            paint.setColor(0xFF336699);
+            paint.setAlpha(alpha);
+
+            SkPixmap pm;
+            SkTBlitterAllocator allocator;
+            REPORTER_ASSERT(reporter, batched.peekPixels(&pm));
+            SkBlitter* blitter = SkBlitter::Choose(pm, SkMatrix::I(), paint, &allocator);
+            blitter->blitSpans(spans, SK_ARRAY_COUNT(spans));
+
+            SkTBlitterAllocator refAllocator;
+            REPORTER_ASSERT(reporter, reference.peekPixels(&pm));
+            blitter = SkBlitter::Choose(pm, SkMatrix::I(), paint, &refAllocator);
+            blitter->SkBlitter::blitSpans(spans, SK_ARRAY_COUNT(spans));
+
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(batched.getPixels(), reference.getPixels(),
+                                        batched.getSize()));
+        }
+    }
+}
+
+// Forwards everything, but sends batched spans through blitH() one at a time, as analytic AA
+// did before it batched them.  It counts any span that blitH() couldn't draw exactly.
+struct UnbatchedBlitter : public SkBlitter {
+    explicit UnbatchedBlitter(SkBlitter* blitter) : fBlitter(blitter) {}
+
+    void blitSpans(const Span spans[], int count) override {
+        for (int i = 0; i < count; i++) {
+            fBlitter->blitH(spans[i].fX, spans[i].fY, spans[i].fWidth);
+            fPartialSpans += spans[i].fAlpha != 0xFF;
+        }
+    }
+
+    void blitH(int x, int y, int width) override { fBlitter->blitH(x, y, width); }
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        fBlitter->blitAntiH(x, y, antialias, runs);
+    }
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        fBlitter->blitV(x, y, height, alpha);
+    }
+    void blitRect(int x, int y, int width, int height) override {
+        fBlitter->blitRect(x, y, width, height);
+    }
+    void blitAntiRect(int x, int y, int width, int height,
+                      SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+        fBlitter->blitAntiRect(x, y, width, height, leftAlpha, rightAlpha);
+    }
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        fBlitter->blitAntiH2(x, y, a0, a1);
+    }
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        fBlitter->blitAntiV2(x, y, a0, a1);
+    }
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        fBlitter->blitMask(mask, clip);
+    }
+
+    SkBlitter* fBlitter;
+    int        fPartialSpans = 0;
+};
+
+// Batching analytic AA's spans must not change a single pixel.
+DEF_TEST(FillPathAAABatching, reporter) {
+    const int kW = 200, kH = 150;
+
+    // Steep and shallow edges, so rows get one, two and many partially covered pixels.
+    SkPath oval, wedge;
+    oval.addOval(SkRect::MakeLTRB(10.3f, 7.6f, 187.2f, 141.9f));
+    wedge.moveTo(3.7f, 2.2f);
+    wedge.lineTo(196.1f, 61.4f);
+    wedge.lineTo(41.6f, 147.3f);
+    wedge.close();
+    SkRasterClip clip(SkIRect::MakeWH(kW, kH));
+
+    const bool useAnalyticAA = gSkUseAnalyticAA.load();
+    gSkUseAnalyticAA = true;
+    for (const SkPath& path : { oval, wedge }) {
+        for (SkColorType ct : { kN32_SkColorType, kAlpha_8_SkColorType, kRGBA_F16_SkColorType }) {
+            for (int variant = 0; variant < 4; variant++) {
+                SkImageInfo info = SkImageInfo::Make(kW, kH, ct, kPremul_SkAlphaType);
+                SkBitmap batched, unbatched;
+                batched.allocPixels(info);
+                unbatched.allocPixels(info);
+                // A noisy background, so blends that round differently show up.
+                SkRandom rand;
+                for (int y = 0; y < kH; y++) {
+                    for (int x = 0; x < kW; x++) {
+                        batched.erase(rand.nextU() | 0x80000000, SkIRect::MakeXYWH(x, y, 1, 1));
+                    }
+                }
+                memcpy(unbatched.getPixels(), batched.getPixels(), batched.getSize());
+
+                // Opaque and translucent colors, a gradient, and a blend mode other than src-over.
+                SkPaint paint;
+                paint.setColor(variant == 1 ? 0x80336699 : 0xFF336699);
+                if (variant == 2) {
+                    const SkPoint pts[] = { { 0, 0 }, { kW, kH } };
+                    const SkColor colors[] = { 0xFF00FF00, 0x800000FF };
+                    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                                 SkShader::kClamp_TileMode));
+                }
+                if (variant == 3) {
+                    paint.setBlendMode(SkBlendMode::kMultiply);
+                }
+
+                SkPixmap pm;
+                SkTBlitterAllocator allocator;
+                REPORTER_ASSERT(reporter, batched.peekPixels(&pm));
+                SkScan::AAAFillPath(path, clip,
+                                    SkBlitter::Choose(pm, SkMatrix::I(), paint, &allocator));
+
+                SkTBlitterAllocator refAllocator;
+                REPORTER_ASSERT(reporter, unbatched.peekPixels(&pm));
+                UnbatchedBlitter blitter(SkBlitter::Choose(pm, SkMatrix::I(), paint,
+                                                           &refAllocator));
+                SkScan::AAAFillPath(path, clip, &blitter);
+                REPORTER_ASSERT(reporter, 0 == blitter.fPartialSpans);
+
+                REPORTER_ASSERT(reporter,
+                                0 == memcmp(batched.getPixels(), unbatched.getPixels(),
+                                            batched.getSize()));
+            }
+        }
+    }
+    gSkUseAnalyticAA = useAnalyticAA;
+}
+
+// Scan converting a path in horizontal bands, concurrently, or from edges cached by an earlier
+// draw must match a single serial pass that builds its edges from scratch.
+DEF_TEST(FillPathBands, reporter) {
+    const int kW = 200, kH = 300;
+
+    SkRandom rand;
+    SkPath complex;
+    complex.moveTo(rand.nextRangeF(0, kW), rand.nextRangeF(0, kH));
+    for (int i = 0; i < 300; i++) {
+        SkPoint p[3];
+        for (SkPoint& pt : p) {
+            pt.set(rand.nextRangeF(0, kW), rand.nextRangeF(0, kH));
+        }
+        switch (i % 3) {
+            case 0: complex.lineTo(p[0]);             break;
+            case 1: complex.quadTo(p[0], p[1]);       break;
+            case 2: complex.cubicTo(p[0], p[1], p[2]); break;
+        }
+    }
+    REPORTER_ASSERT(reporter, SkScan::CanFillPathInBands(complex));
+
+    SkPath convex;
+    for (int i = 0; i < 64; i++) {
+        SkScalar angle = i * SK_ScalarPI / 32;
+        SkPoint pt = SkPoint::Make(kW / 2 + kW / 3 * SkScalarCos(angle),
+                                   kH / 2 + kW / 3 * SkScalarSin(angle));
+        i ? convex.lineTo(pt) : convex.moveTo(pt);
+    }
+    convex.close();
+
+    SkRasterClip inside(SkIRect::MakeWH(kW, kH)),
+                 crop(SkIRect::MakeLTRB(10, 17, kW - 30, kH - 41)),
+                 aa(SkIRect::MakeWH(kW, kH));
+    SkPath circle;
+    circle.addCircle(kW / 2, kH / 2, kH / 3);
+    aa.op(circle, SkMatrix::I(), SkIRect::MakeWH(kW, kH), SkRegion::kIntersect_Op, true);
+    REPORTER_ASSERT(reporter, !aa.isBW());
+
+    // Uneven bands, so some edges start, end and turn exactly on band boundaries.
+    const int kRows = 7;
+    const struct {
+        const SkPath*       path;
+        const SkRasterClip* clip;
+        bool                antiAlias;
+        bool                analytic;
+        int                 rowsPerBand;    // 0 draws in one pass
+        bool                cacheEdges;
+    } kCases[] = {
+        { &complex, &inside, false, false, kRows, false },
+        { &complex, &crop,   false, false, kRows, false },
+        { &complex, &aa,     false, false, kRows, false },
+        { &complex, &inside, true,  false, kRows, false },
+        { &complex, &crop,   true,  false, kRows, false },
+        { &complex, &aa,     true,  false, kRows, false },
+        { &complex, &inside, false, false, kRows, true  },
+        { &complex, &inside, true,  false, kRows, true  },
+        { &complex, &crop,   false, false, 0,     true  },
+        { &complex, &crop,   true,  false, 0,     true  },
+        { &complex, &crop,   true,  true,  0,     true  },
+        { &convex,  &crop,   false, false, 0,     true  },
+        { &convex,  &crop,   true,  false, 0,     true  },
+        { &convex,  &crop,   true,  true,  0,     true  },
+    };
+
+    const bool useAnalyticAA = gSkUseAnalyticAA.load();
+    for (const auto& c : kCases) {
+        gSkUseAnalyticAA = c.analytic;
+
+        SkDevPathSource source;
+        source.fGenID = c.path->getGenerationID();
+        source.fMatrix.reset();
+        const SkDevPathSource* sourcePtr = c.cacheEdges ? &source : nullptr;
+
+        SkPaint paint;
+        paint.setColor(0x80336699);
+
+        auto fill = [&](const SkPixmap& pm, int top, int bottom, const SkDevPathSource* src) {
+            SkTBlitterAllocator allocator;
+            SkBlitter* blitter = SkBlitter::Choose(pm, SkMatrix::I(), paint, &allocator);
+            if (c.antiAlias) {
+                if (bottom - top < kH) {
+                    SkScan::AntiFillPathBand(*c.path, *c.clip, top, bottom, blitter, src);
+                } else {
+                    SkScan::AntiFillPath(*c.path, *c.clip, blitter, src);
+                }
+            } else {
+                if (bottom - top < kH) {
+                    SkScan::FillPathBand(*c.path, *c.clip, top, bottom, blitter, src);
+                } else {
+                    SkScan::FillPath(*c.path, *c.clip, blitter, src);
+                }
+            }
+        };
+
+        SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+        SkBitmap expected;
+        expected.allocPixels(info);
+        expected.eraseColor(SK_ColorWHITE);
+        SkPixmap pm;
+        REPORTER_ASSERT(reporter, expected.peekPixels(&pm));
+        fill(pm, 0, kH, nullptr);
+
+        // Draw twice, so a cached case sees both a miss and a hit.
+        const int hits = SkGraphics::GetEdgeCacheHitCount();
+        for (int pass = 0; pass < 2; pass++) {
+            SkBitmap actual;
+            actual.allocPixels(info);
+            actual.eraseColor(SK_ColorWHITE);
+            REPORTER_ASSERT(reporter, actual.peekPixels(&pm));
+            if (c.rowsPerBand) {
+                SkTaskGroup().batch(kH / c.rowsPerBand + 1, [&](int i) {
+                    fill(pm, i * c.rowsPerBand, (i + 1) * c.rowsPerBand, sourcePtr);
+                });
+            } else {
+                fill(pm, 0, kH, sourcePtr);
+            }
+
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                        expected.getSize()));
+        }
+        REPORTER_ASSERT(reporter, !c.cacheEdges || SkGraphics::GetEdgeCacheHitCount() > hits);
+    }
+    gSkUseAnalyticAA = useAnalyticAA;
+
+    // SkDraw only hands the cache paths that can be drawn again unchanged.
+    SkBitmap bm;
+    bm.allocN32Pixels(kW, kH);
+    SkCanvas canvas(bm);
+    SkPath uncached(complex);
+    uncached.setIsVolatile(true);
+    for (const SkPath* path : { &uncached, &complex }) {
+        const int hits = SkGraphics::GetEdgeCacheHitCount();
+        canvas.drawPath(*path, SkPaint());
+        canvas.drawPath(*path, SkPaint());
+        REPORTER_ASSERT(reporter,
+                        (SkGraphics::GetEdgeCacheHitCount() > hits) == (path == &complex));
+    }
+}
@@ -6,7 +6,10 @@
  */
 
 #include "SkCachedData.h"
+#include "SkCanvas.h"
 #include "SkMaskCache.h"
+#include "SkPaint.h"
+#include "SkPath.h"
 #include "SkResourceCache.h"
 #include "Test.h"
 
@@ -104,3 +107,114 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkPath path;
+    path.addCircle(50, 50, 40);
+    SkMatrix matrix = SkMatrix::MakeScale(2, 3);
+    SkPaint paint;
+    SkMask mask;
+
+    SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, paint, &mask, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(0, 0, 100, 100);
+    mask.fRowBytes = 100;
+    mask.fFormat = SkMask::kA8_Format;
+    SkMaskCache::Add(path, matrix, paint, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // A stroke, another matrix, or an edited path must not find the fill's mask.
+    SkPaint stroke;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(4);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, matrix, stroke, &mask, &cache));
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(path, SkMatrix::I(), paint, &mask, &cache));
+    SkPath edited(path);
+    edited.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(edited, matrix, paint, &mask, &cache));
+
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(path, matrix, paint, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, mask.fBounds.top() == 0 && mask.fBounds.bottom() == 100);
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
+
+// Drawing through a cached mask should look the same as drawing the path directly, wherever the
+// path is translated to.
+DEF_TEST(PathMaskCacheDraw, reporter) {
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(90, 0, 0, 90, 70, 60);
+    path.quadTo(20, 80, 10, 10);
+
+    SkPaint fill, stroke;
+    fill.setAntiAlias(true);
+    fill.setColor(0xFF336699);
+    stroke = fill;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(5);
+    stroke.setStrokeJoin(SkPaint::kRound_Join);
+
+    auto draw = [&](SkBitmap* bm, const SkPaint& paint, SkScalar dx, SkScalar dy) {
+        bm->allocN32Pixels(200, 150);
+        SkCanvas canvas(*bm);
+        canvas.clear(SK_ColorWHITE);
+        canvas.clipRect(SkRect::MakeLTRB(3, 7, 190, 145));
+        canvas.translate(dx, dy);
+        canvas.drawPath(path, paint);
+    };
+
+    const bool usePathMaskCache = gSkUsePathMaskCache.load();
+    for (const SkPaint* paint : { &fill, &stroke }) {
+        // Quarter pixel offsets, so the masks are made at exactly the offsets asked for, and
+        // well inside the clip, since clipping a path's curves changes its coverage slightly.
+        for (SkPoint offset : { SkPoint{10.25f, 20.5f}, SkPoint{50.75f, 30}, SkPoint{80, 12.25f} }) {
+            SkBitmap direct, cached, cachedAgain;
+            gSkUsePathMaskCache = false;
+            draw(&direct, *paint, offset.fX, offset.fY);
+            gSkUsePathMaskCache = true;
+            draw(&cached, *paint, offset.fX, offset.fY);
+            draw(&cachedAgain, *paint, offset.fX, offset.fY);
+
+            SkMask mask;
+            SkMatrix matrix = SkMatrix::MakeTrans(offset.fX - SkScalarFloorToScalar(offset.fX),
+                                                  offset.fY - SkScalarFloorToScalar(offset.fY));
+            SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, *paint, &mask);
+            REPORTER_ASSERT(reporter, data);
+            if (data) {
+                data->unref();
+            }
+
+            for (int y = 0; y < direct.height(); y++) {
+                for (int x = 0; x < direct.width(); x++) {
+                    SkPMColor d = *direct.getAddr32(x, y),
+                              c = *cached.getAddr32(x, y);
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        int delta = SkTAbs((int)((d >> shift) & 0xFF) -
+                                           (int)((c >> shift) & 0xFF));
+                        REPORTER_ASSERT(reporter, delta <= 1);
+                    }
+                    REPORTER_ASSERT(reporter, c == *cachedAgain.getAddr32(x, y));
+                }
+            }
+        }
+    }
+    gSkUsePathMaskCache = usePathMaskCache;
+}
@@ -13,6 +13,7 @@
 #include "SkColorPriv.h"
 #include "SkDashPathEffect.h"
 #include "SkData.h"
+#include "SkImageDeserializer.h"
 #include "SkImageGenerator.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
@@ -34,6 +35,8 @@
 
 #include "Test.h"
 
+#include <atomic>
+
 #include "SkLumaColorFilter.h"
 #include "SkColorFilterImageFilter.h"
 
@@ -1097,6 +1100,431 @@ DEF_TEST(Picture_preserveCullRect, r) {
     REPORTER_ASSERT(r, deserializedPicture->cullRect().bottom() == 4);
 }
 
+static void draw_to_bitmap(SkPicture* picture, SkBitmap* bm) {
+    bm->allocN32Pixels(100, 100);
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bm);
+    canvas.drawPicture(picture);
+}
+
+DEF_TEST(Picture_InPlace, r) {
+    SkPictureRecorder nestedRecorder;
+    SkCanvas* nested = nestedRecorder.beginRecording(SkRect::MakeWH(50, 50));
+    nested->drawCircle(25, 25, 20, SkPaint());
+    sk_sp<SkPicture> nestedPicture(nestedRecorder.finishRecordingAsPicture());
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image(SkImage::MakeFromBitmap(bitmap));
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    SkPath path;
+    path.moveTo(10, 10);
+    path.quadTo(90, 10, 50, 90);
+    path.close();
+    canvas->drawPath(path, paint);
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(20, 20, 80, 80));
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->drawText("in place", 8, 10, 50, paint);
+    canvas->drawImage(image, 30, 30);
+    canvas->restore();
+    canvas->restore();
+    canvas->drawPicture(nestedPicture);
+    sk_sp<SkData> data(recorder.finishRecordingAsPicture()->serialize());
+
+    sk_sp<SkPicture> copied(SkPicture::MakeFromData(data.get()));
+    sk_sp<SkPicture> inPlace(SkPicture::MakeFromDataInPlace(data));
+    REPORTER_ASSERT(r, copied && inPlace);
+    REPORTER_ASSERT(r, inPlace->cullRect() == copied->cullRect());
+    REPORTER_ASSERT(r, inPlace->approximateOpCount() > 0);
+    // The in-place picture plays back out of data, so it must keep it alive.
+    REPORTER_ASSERT(r, !data->unique());
+
+    SkBitmap expected, actual;
+    draw_to_bitmap(copied.get(), &expected);
+    draw_to_bitmap(inPlace.get(), &actual);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+
+    inPlace = nullptr;
+    REPORTER_ASSERT(r, data->unique());
+}
+
+namespace {
+// Skia may call ours from several threads at once only if we say that's thread-safe.
+struct CountingImageDeserializer : public SkImageDeserializer {
+    explicit CountingImageDeserializer(bool threadSafe = false) : fThreadSafe(threadSafe) {}
+
+    sk_sp<SkImage> makeFromData(SkData* data, const SkIRect* subset) override {
+        if (fBusy.exchange(true)) {
+            fOverlapped = true;
+        }
+        fCount++;
+        sk_sp<SkImage> image = this->SkImageDeserializer::makeFromData(data, subset);
+        fBusy = false;
+        return image;
+    }
+    bool isThreadSafe() const override { return fThreadSafe; }
+
+    const bool        fThreadSafe;
+    std::atomic<int>  fCount{0};
+    std::atomic<bool> fOverlapped{false};
+    std::atomic<bool> fBusy{false};
+};
+
+struct CountingPixelSerializer : public SkPixelSerializer {
+    explicit CountingPixelSerializer(bool threadSafe = false) : fThreadSafe(threadSafe) {}
+
+    bool onUseEncodedData(const void*, size_t) override { return false; }
+    SkData* onEncode(const SkPixmap& pixmap) override {
+        if (fBusy.exchange(true)) {
+            fOverlapped = true;
+        }
+        fCount++;
+        SkData* data = SkImageEncoder::EncodeData(pixmap, SkImageEncoder::kPNG_Type, 100);
+        fBusy = false;
+        return data;
+    }
+    bool isThreadSafe() const override { return fThreadSafe; }
+
+    const bool        fThreadSafe;
+    std::atomic<int>  fCount{0};
+    std::atomic<bool> fOverlapped{false};
+    std::atomic<bool> fBusy{false};
+};
+}  // namespace
+
+DEF_TEST(Picture_LazySubPictures, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> image(SkImage::MakeFromBitmap(bitmap));
+
+    // Enough ops that drawPicture() won't just unroll it.
+    SkPictureRecorder nestedRecorder;
+    SkCanvas* nested = nestedRecorder.beginRecording(SkRect::MakeWH(20, 20));
+    nested->drawRect(SkRect::MakeWH(20, 20), SkPaint());
+    nested->drawImage(image, 4, 4);
+    sk_sp<SkPicture> nestedPicture(nestedRecorder.finishRecordingAsPicture());
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(200, 200));
+    canvas->drawRect(SkRect::MakeLTRB(10, 10, 50, 50), SkPaint());
+    canvas->translate(150, 150);
+    canvas->drawPicture(nestedPicture);
+    sk_sp<SkData> data(recorder.finishRecordingAsPicture()->serialize());
+
+    sk_sp<SkPicture> picture(SkPicture::MakeFromDataInPlace(data));
+    REPORTER_ASSERT(r, picture);
+    // Answered from what precedes the sub-picture, without loading it.
+    REPORTER_ASSERT(r, picture->willPlayBackBitmaps());
+
+    // The sub-picture lies outside this viewport, so it should never be loaded.
+    SkBitmap small;
+    small.allocN32Pixels(100, 100);
+    SkCanvas smallCanvas(small);
+    smallCanvas.drawPicture(picture);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(200, 200);
+    expected.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(expected).drawPicture(SkPicture::MakeFromData(data.get()));
+    actual.allocN32Pixels(200, 200);
+    actual.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(actual).drawPicture(picture);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+
+    // A caller's deserializer need not outlive the picture, so it's used up front.
+    {
+        CountingImageDeserializer deserializer;
+        picture = SkPicture::MakeFromDataInPlace(data, &deserializer);
+        REPORTER_ASSERT(r, picture);
+        REPORTER_ASSERT(r, deserializer.fCount > 0);
+    }
+    actual.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(actual).drawPicture(picture);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+static sk_sp<SkPicture> record_images(int count, SkColor color) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    for (int i = 0; i < count; i++) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(10, 10);
+        bitmap.eraseColor(SkColorSetA(color, 0xFF - i));
+        canvas->drawImage(SkImage::MakeFromBitmap(bitmap), SkIntToScalar(10 * i), 0);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+DEF_TEST(Picture_SerializeImagesInParallel, r) {
+    const int kImages = 8;
+    sk_sp<SkPicture> nested(record_images(kImages, SK_ColorBLUE));
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    canvas->drawPicture(record_images(kImages, SK_ColorRED));
+    canvas->translate(0, 20);
+    canvas->drawPicture(nested);
+    canvas->translate(0, 20);
+    canvas->drawPicture(nested);
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+    // However the work is split up, the bytes must come out the same every time.
+    sk_sp<SkData> data(picture->serialize());
+    REPORTER_ASSERT(r, data->equals(picture->serialize().get()));
+
+    CountingImageDeserializer deserializer;
+    SkMemoryStream stream(data);
+    sk_sp<SkPicture> copy(SkPicture::MakeFromStream(&stream, &deserializer));
+    REPORTER_ASSERT(r, copy);
+    // The nested picture is only serialized once.
+    REPORTER_ASSERT(r, 2 * kImages == deserializer.fCount);
+    REPORTER_ASSERT(r, !deserializer.fOverlapped);
+    REPORTER_ASSERT(r, data->equals(copy->serialize().get()));
+
+    sk_sp<CountingPixelSerializer> serializer(new CountingPixelSerializer);
+    sk_sp<SkData> serialized(picture->serialize(serializer.get()));
+    REPORTER_ASSERT(r, serialized);
+    REPORTER_ASSERT(r, 2 * kImages == serializer->fCount);
+    REPORTER_ASSERT(r, !serializer->fOverlapped);
+
+    SkBitmap expected, actual;
+    draw_to_bitmap(picture.get(), &expected);
+    draw_to_bitmap(copy.get(), &actual);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+
+    // Thread-safe ones may be called in parallel, to the same effect.
+    sk_sp<CountingPixelSerializer> parallelSerializer(new CountingPixelSerializer(true));
+    REPORTER_ASSERT(r, serialized->equals(picture->serialize(parallelSerializer.get()).get()));
+    REPORTER_ASSERT(r, 2 * kImages == parallelSerializer->fCount);
+
+    CountingImageDeserializer parallelDeserializer(true);
+    SkMemoryStream parallelStream(data);
+    copy = SkPicture::MakeFromStream(&parallelStream, &parallelDeserializer);
+    REPORTER_ASSERT(r, copy);
+    REPORTER_ASSERT(r, 2 * kImages == parallelDeserializer.fCount);
+    draw_to_bitmap(copy.get(), &actual);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+namespace {
+class RectCountingCanvas : public SkCanvas {
+public:
+    RectCountingCanvas(const SkBitmap& bitmap) : INHERITED(bitmap), fRectCount(0) {}
+
+    void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+        fRectCount++;
+        this->INHERITED::onDrawRect(rect, paint);
+    }
+
+    int fRectCount;
+
+private:
+    typedef SkCanvas INHERITED;
+};
+}  // namespace
+
+static sk_sp<SkData> record_rect_grid(SkBBHFactory* factory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(200, 200), factory);
+    SkPaint paint;
+    for (int y = 0; y < 10; y++) {
+        for (int x = 0; x < 10; x++) {
+            paint.setColor(SkColorSetARGB(0xFF, x * 25, y * 25, 0x80));
+            if ((x + y) & 1) {
+                canvas->save();
+                canvas->translate(SkIntToScalar(x * 20), SkIntToScalar(y * 20));
+                canvas->clipRect(SkRect::MakeWH(15, 15));
+                canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+                canvas->restore();
+            } else {
+                canvas->drawRect(SkRect::MakeXYWH(x * 20, y * 20, 20, 20), paint);
+            }
+        }
+    }
+    return recorder.finishRecordingAsPicture()->serialize();
+}
+
+DEF_TEST(Picture_SerializeBBH, r) {
+    const SkRect clip = SkRect::MakeLTRB(45, 45, 75, 75);
+    SkRTreeFactory factory;
+    int rectCounts[2];
+    for (SkBBHFactory* bbhFactory : { (SkBBHFactory*)nullptr, (SkBBHFactory*)&factory }) {
+        sk_sp<SkData> data(record_rect_grid(bbhFactory));
+        sk_sp<SkPicture> copied(SkPicture::MakeFromData(data.get()));
+        sk_sp<SkPicture> inPlace(SkPicture::MakeFromDataInPlace(data));
+        REPORTER_ASSERT(r, copied && inPlace);
+
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(200, 200);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        actual.allocN32Pixels(200, 200);
+        actual.eraseColor(SK_ColorTRANSPARENT);
+
+        SkCanvas expectedCanvas(expected);
+        expectedCanvas.clipRect(clip);
+        copied->playback(&expectedCanvas);
+
+        RectCountingCanvas actualCanvas(actual);
+        actualCanvas.clipRect(clip);
+        inPlace->playback(&actualCanvas);
+
+        rectCounts[bbhFactory ? 1 : 0] = actualCanvas.fRectCount;
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSize()));
+    }
+    // With a BBH, rects that miss the clip shouldn't even be drawn.
+    REPORTER_ASSERT(r, rectCounts[1] > 0 && rectCounts[1] < rectCounts[0]);
+}
+
+static sk_sp<SkPicture> record_occluded_scene(uint32_t recordFlags) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100), nullptr, recordFlags);
+
+    SkPaint translucent, aa, opaque;
+    translucent.setColor(0x80FF0000);
+    aa.setAntiAlias(true);
+    aa.setColor(SK_ColorBLUE);
+    opaque.setColor(SK_ColorGREEN);
+
+    // Hidden by the opaque rect below.
+    canvas->drawRect(SkRect::MakeXYWH(10.5f, 10.5f, 30, 30), translucent);
+    canvas->drawRect(SkRect::MakeXYWH(20, 20, 40, 40), aa);
+    canvas->save();
+        canvas->translate(30, 30);
+        canvas->clipRect(SkRect::MakeWH(30, 30));
+        canvas->drawRect(SkRect::MakeWH(50, 50), translucent);
+    canvas->restore();
+    // Sticks out past the opaque rect's edge.
+    canvas->drawRect(SkRect::MakeXYWH(60, 60, 30, 30), aa);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 70.5f, 70.5f), opaque);
+
+    // An antialiased clip doesn't hide anything.
+    canvas->save();
+        canvas->clipRect(SkRect::MakeXYWH(0.5f, 80.5f, 19, 19), SkCanvas::kIntersect_Op, true);
+        canvas->drawRect(SkRect::MakeXYWH(5, 85, 5, 5), translucent);
+        canvas->drawPaint(opaque);
+    canvas->restore();
+    return recorder.finishRecordingAsPicture();
+}
+
+DEF_TEST(Picture_OcclusionCulling, r) {
+    sk_sp<SkPicture> plain  = record_occluded_scene(0),
+                     culled = record_occluded_scene(SkPictureRecorder::kOcclusionCulling_RecordFlag);
+
+    const SkMatrix matrices[] = {
+        SkMatrix::I(),
+        SkMatrix::MakeTrans(0.5f, 0.25f),
+        SkMatrix::MakeScale(2, 1.5f),
+        SkMatrix::MakeScale(0.5f, 0.5f),
+    };
+    for (const SkMatrix& matrix : matrices) {
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(200, 200);
+        actual.allocN32Pixels(200, 200);
+        expected.eraseColor(SK_ColorWHITE);
+        actual.eraseColor(SK_ColorWHITE);
+
+        RectCountingCanvas expectedCanvas(expected), actualCanvas(actual);
+        expectedCanvas.concat(matrix);
+        actualCanvas.concat(matrix);
+        plain->playback(&expectedCanvas);
+        culled->playbackSkippingOccludedOps(&actualCanvas);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSize()));
+
+        // Culling is only safe when playback doesn't scale down.
+        const int skipped = matrix.getMinScale() < 1 ? 0 : 3;
+        REPORTER_ASSERT(r, expectedCanvas.fRectCount - skipped == actualCanvas.fRectCount);
+
+        // A canvas might rewrite paints, so plain playback must not skip anything.
+        RectCountingCanvas plainCanvas(actual);
+        plainCanvas.drawPicture(culled, &matrix, nullptr);
+        REPORTER_ASSERT(r, expectedCanvas.fRectCount == plainCanvas.fRectCount);
+    }
+}
+
+static sk_sp<SkPicture> record_frame(SkPictureRecorder* recorder, SkColor middleColor,
+                                     SkScalar middleX, SkBBHFactory* factory) {
+    SkCanvas* canvas = recorder->beginRecording(SkRect::MakeWH(200, 200), factory,
+                                                SkPictureRecorder::kIncremental_RecordFlag);
+    SkPaint paint;
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+    paint.setColor(middleColor);
+    canvas->drawRect(SkRect::MakeXYWH(middleX, 50, 20, 20), paint);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(150, 150, 20, 20), paint);
+    return recorder->finishRecordingAsPicture();
+}
+
+DEF_TEST(Picture_IncrementalRecording, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+
+    // With nothing to compare against, everything is damaged.
+    sk_sp<SkPicture> first = record_frame(&recorder, SK_ColorRED, 50, &factory);
+    REPORTER_ASSERT(r, recorder.getDamageRect() == SkRect::MakeWH(200, 200));
+
+    // Recording the same thing again damages nothing, and shares the first recording.
+    sk_sp<SkPicture> same = record_frame(&recorder, SK_ColorRED, 50, &factory);
+    REPORTER_ASSERT(r, recorder.getDamageRect().isEmpty());
+    REPORTER_ASSERT(r, static_cast<const SkBigPicture*>(first.get())->record() ==
+                       static_cast<const SkBigPicture*>(same.get())->record());
+
+    // A new color damages only that rect.
+    sk_sp<SkPicture> recolored = record_frame(&recorder, SK_ColorGREEN, 50, &factory);
+    REPORTER_ASSERT(r, recorder.getDamageRect() == SkRect::MakeXYWH(50, 50, 20, 20));
+    REPORTER_ASSERT(r, static_cast<const SkBigPicture*>(first.get())->bbh() ==
+                       static_cast<const SkBigPicture*>(recolored.get())->bbh());
+
+    // Moving it damages where it was and where it is now.
+    sk_sp<SkPicture> moved = record_frame(&recorder, SK_ColorGREEN, 90, &factory);
+    REPORTER_ASSERT(r, recorder.getDamageRect() == SkRect::MakeXYWH(50, 50, 60, 20));
+
+    // Each picture still draws what it recorded.
+    SkBitmap bm;
+    bm.allocN32Pixels(200, 200);
+    SkCanvas canvas(bm);
+    canvas.drawPicture(recolored);
+    REPORTER_ASSERT(r, bm.getColor(60, 60) == SK_ColorGREEN);
+    canvas.drawPicture(first);
+    REPORTER_ASSERT(r, bm.getColor(60, 60) == SK_ColorRED);
+}
+
+// An empty frame finished as null must not leave the next frame appending to the one before.
+DEF_TEST(Picture_IncrementalRecordingAfterNull, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+
+    recorder.beginRecording(SkRect::MakeWH(200, 200), &factory,
+                            SkPictureRecorder::kIncremental_RecordFlag);
+    REPORTER_ASSERT(r, !recorder.finishRecordingAsPicture(
+                                SkPictureRecorder::kReturnNullForEmpty_FinishFlag));
+
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(200, 200), &factory,
+                                               SkPictureRecorder::kIncremental_RecordFlag);
+    for (int i = 0; i < 200; i++) {
+        canvas->drawRect(SkRect::MakeXYWH(i % 20 * 10, i / 20 * 10, 5, 5), SkPaint());
+    }
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, picture);
+    REPORTER_ASSERT(r, picture->approximateOpCount() >= 200);
+    // Everything is new since the empty frame.
+    REPORTER_ASSERT(r, recorder.getDamageRect() == SkRect::MakeWH(195, 95));
+}
+
 #if SK_SUPPORT_GPU
 
 DEF_TEST(PictureGpuAnalyzer, r) {
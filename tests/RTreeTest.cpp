@@ -7,6 +7,7 @@
 
 #include "SkRTree.h"
 #include "SkRandom.h"
+#include "SkStream.h"
 #include "Test.h"
 
 static const int NUM_RECTS = 200;
@@ -89,3 +90,103 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_Serialize, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int count : { 0, 1, 7, NUM_RECTS }) {
+        for (int j = 0; j < count; j++) {
+            rects[j] = random_rect(rand);
+        }
+        SkRTree rtree;
+        rtree.insert(rects.get(), count);
+
+        SkDynamicMemoryWStream wstream;
+        rtree.writeToStream(&wstream);
+        sk_sp<SkData> data(wstream.detachAsData());
+
+        SkMemoryStream stream(data);
+        SkAutoTUnref<SkRTree> copy(SkRTree::CreateFromStream(&stream));
+        REPORTER_ASSERT(reporter, copy);
+        REPORTER_ASSERT(reporter, stream.isAtEnd());
+        REPORTER_ASSERT(reporter, rtree.getCount() == copy->getCount());
+        REPORTER_ASSERT(reporter, rtree.getDepth() == copy->getDepth());
+        REPORTER_ASSERT(reporter, rtree.getRootBound() == copy->getRootBound());
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            SkTDArray<int> expected, found;
+            SkRect query = random_rect(rand);
+            rtree.search(query, &expected);
+            copy->search(query, &found);
+            REPORTER_ASSERT(reporter, expected == found);
+        }
+
+        // Truncated trees should be rejected.
+        if (data->size() > 8) {
+            SkMemoryStream truncated(data->data(), data->size() - 4);
+            SkAutoTUnref<SkRTree> bad(SkRTree::CreateFromStream(&truncated));
+            REPORTER_ASSERT(reporter, !bad);
+        }
+    }
+}
+
+// Writes a serialized tree of two ops that's a chain of nodes, each node's child the next node,
+// and the last node (at level 0) holding both ops.  The root claims numChildren children.
+static sk_sp<SkData> write_chain(int nodes, int numChildren) {
+    const SkRect bounds = SkRect::MakeWH(10, 10);
+    SkDynamicMemoryWStream wstream;
+    wstream.write32(2);                  // count
+    wstream.write32(SkToU32(nodes));
+    wstream.write32(0);                  // root
+    wstream.write(&bounds, sizeof(bounds));
+    for (int i = 0; i < nodes; i++) {
+        const int level    = nodes - 1 - i,
+                  children = i == 0 ? numChildren : level > 0 ? 1 : 2;
+        wstream.write16(SkToU16(children));
+        wstream.write16(SkToU16(level));
+        for (int j = 0; j < children; j++) {
+            wstream.write32(SkToU32(level > 0 ? i + 1 : j));
+            wstream.write(&bounds, sizeof(bounds));
+        }
+    }
+    return sk_sp<SkData>(wstream.detachAsData());
+}
+
+DEF_TEST(RTree_SerializeRejectsBadShapes, reporter) {
+    // A tree of two ops is at most two levels deep.
+    for (int nodes : { 1, 2, 3, 1000 }) {
+        sk_sp<SkData> data(write_chain(nodes, nodes > 1 ? 1 : 2));
+        SkMemoryStream stream(data);
+        SkAutoTUnref<SkRTree> tree(SkRTree::CreateFromStream(&stream));
+        REPORTER_ASSERT(reporter, SkToBool(tree) == (nodes <= 2));
+    }
+
+    // Every node must have a child.
+    sk_sp<SkData> data(write_chain(2, 0));
+    SkMemoryStream stream(data);
+    SkAutoTUnref<SkRTree> tree(SkRTree::CreateFromStream(&stream));
+    REPORTER_ASSERT(reporter, !tree);
+}
+
+DEF_TEST(RTree_BatchSearch, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int count : { 0, 1, NUM_RECTS }) {
+        for (int j = 0; j < count; j++) {
+            rects[j] = random_rect(rand);
+        }
+        SkRTree rtree;
+        rtree.insert(rects.get(), count);
+
+        SkRect queries[NUM_QUERIES];
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            queries[i] = random_rect(rand);
+        }
+        SkTDArray<int> found[NUM_QUERIES];
+        rtree.batchSearch(queries, NUM_QUERIES, found);
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            SkTDArray<int> expected;
+            rtree.search(queries[i], &expected);
+            REPORTER_ASSERT(reporter, expected == found[i]);
+        }
+    }
+}
@@ -9,7 +9,9 @@
 #include "RecordTestUtils.h"
 
 #include "SkColorFilter.h"
+#include "SkImage.h"
 #include "SkRecord.h"
+#include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
@@ -186,7 +188,7 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != nullptr);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
 
     // saveLayer w/ backdrop should NOT go away
     sk_sp<SkImageFilter> filter(SkBlurImageFilter::Make(3, 3, nullptr));
@@ -412,3 +414,234 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_CollapseMatrices, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.translate(10, 20);
+    recorder.translate(30, 40);
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());
+    recorder.translate(10, 20);
+    recorder.scale(2, 3);
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());
+
+    SkRecordCollapseMatrices(&record);
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    const SkRecords::Translate* translate = assert_type<SkRecords::Translate>(r, record, 1);
+    REPORTER_ASSERT(r, 40 == translate->dx && 60 == translate->dy);
+    assert_type<SkRecords::NoOp>(r, record, 3);
+    const SkRecords::Concat* concat = assert_type<SkRecords::Concat>(r, record, 4);
+    SkMatrix expected;
+    expected.setTranslate(10, 20);
+    expected.preScale(2, 3);
+    REPORTER_ASSERT(r, expected == concat->matrix);
+}
+
+DEF_TEST(RecordOpts_RedundantClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(200, 200));
+        recorder.clipRect(SkRect::MakeWH(100, 100));
+        recorder.clipRect(SkRect::MakeXYWH(50, 50, 100, 100));  // Not nested, so kept.
+        recorder.drawRect(SkRect::MakeWH(300, 300), SkPaint());
+        recorder.clipRect(SkRect::MakeWH(10, 10));
+        recorder.translate(10, 10);
+    recorder.restore();
+
+    SkRecordNoopRedundantClips(&record);
+
+    assert_type<SkRecords::Save>    (r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 1);
+    assert_type<SkRecords::ClipRect>(r, record, 2);
+    assert_type<SkRecords::ClipRect>(r, record, 3);
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::NoOp>    (r, record, 5);
+    assert_type<SkRecords::NoOp>    (r, record, 6);
+    assert_type<SkRecords::Restore> (r, record, 7);
+}
+
+DEF_TEST(RecordOpts_OccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent, aa;
+    translucent.setAlpha(0x80);
+    aa.setAntiAlias(true);
+
+    recorder.drawRect(SkRect::MakeWH(50, 50), aa);               // Covered, but antialiased.
+    recorder.drawOval(SkRect::MakeWH(50, 50), translucent);      // Covered.
+    recorder.drawRect(SkRect::MakeWH(150, 150), translucent);    // Not covered.
+    recorder.drawRect(SkRect::MakeWH(100, 100), opaque);         // Occluder.
+    recorder.drawRect(SkRect::MakeWH(10, 10), opaque);
+    recorder.clipRect(SkRect::MakeWH(500, 500));
+    recorder.drawRect(SkRect::MakeWH(100, 100), opaque);         // Can't see past the clip.
+    recorder.drawRect(SkRect::MakeWH(10, 10), opaque);
+    recorder.drawPaint(translucent);                             // Not an occluder.
+    recorder.drawPaint(opaque);                                  // Covers everything.
+
+    SkRecordNoopOccludedDraws(&record);
+
+    assert_type<SkRecords::DrawRect> (r, record, 0);
+    assert_type<SkRecords::NoOp>     (r, record, 1);
+    assert_type<SkRecords::DrawRect> (r, record, 2);
+    assert_type<SkRecords::DrawRect> (r, record, 3);
+    assert_type<SkRecords::DrawRect> (r, record, 4);
+    assert_type<SkRecords::ClipRect> (r, record, 5);
+    for (int i = 6; i < 9; i++) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::DrawPaint>(r, record, 9);
+}
+
+DEF_TEST(RecordOpts_OccludedByImageRect, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(40, 40, true/*opaque*/);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkPaint translucent;
+    translucent.setAlpha(0x80);
+
+    // A src reaching past the image leaves part of dst undrawn, so it hides nothing.
+    for (SkScalar srcSize : { 20, 80 }) {
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(SkRect::MakeWH(50, 50), translucent);
+        recorder.drawImageRect(image, SkRect::MakeWH(srcSize, srcSize),
+                               SkRect::MakeWH(100, 100), nullptr);
+
+        SkRecordNoopOccludedDraws(&record);
+
+        if (srcSize < 40) {
+            assert_type<SkRecords::NoOp>(r, record, 0);
+        } else {
+            assert_type<SkRecords::DrawRect>(r, record, 0);
+        }
+    }
+}
+
+DEF_TEST(RecordOpts_MergeDrawRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint translucent;
+    translucent.setAlpha(0x80);
+
+    recorder.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), translucent);
+    recorder.drawRect(SkRect::MakeXYWH(10, 0, 10, 10), translucent);
+    recorder.drawRect(SkRect::MakeXYWH(30, 0, 10, 10), translucent);
+    recorder.drawRect(SkRect::MakeXYWH(30, 0, 10, 10), SkPaint());  // Different paint.
+    recorder.drawRect(SkRect::MakeXYWH(35, 0, 10, 10), SkPaint());  // Overlaps, but opaque.
+    recorder.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), translucent);
+    recorder.drawRect(SkRect::MakeXYWH( 5, 0, 10, 10), translucent);  // Would blend twice.
+
+    SkRecordMergeDrawRects(&record);
+
+    const SkRecords::DrawRegion* region = assert_type<SkRecords::DrawRegion>(r, record, 0);
+    REPORTER_ASSERT(r, region->region.isComplex());
+    REPORTER_ASSERT(r, region->region.getBounds() == SkIRect::MakeWH(40, 10));
+    assert_type<SkRecords::NoOp>      (r, record, 1);
+    assert_type<SkRecords::NoOp>      (r, record, 2);
+    region = assert_type<SkRecords::DrawRegion>(r, record, 3);
+    REPORTER_ASSERT(r, region->region.isRect());
+    assert_type<SkRecords::NoOp>      (r, record, 4);
+    assert_type<SkRecords::DrawRect>  (r, record, 5);
+    assert_type<SkRecords::DrawRect>  (r, record, 6);
+}
+
+DEF_TEST(RecordOpts_MergeDrawImageRects, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(40, 40);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    // Four tiles of the image, drawn at twice its size.
+    for (int y = 0; y < 40; y += 20) {
+        for (int x = 0; x < 40; x += 20) {
+            recorder.drawImageRect(image, SkRect::MakeXYWH(x, y, 20, 20),
+                                   SkRect::MakeXYWH(100 + 2*x, 2*y, 40, 40), nullptr);
+        }
+    }
+
+    SkRecordMergeDrawImageRects(&record);
+
+    // Rows merge, but the next row doesn't abut the whole of the previous one until it's merged.
+    const SkRecords::DrawImageRect* draw = assert_type<SkRecords::DrawImageRect>(r, record, 0);
+    REPORTER_ASSERT(r, *draw->src == SkRect::MakeWH(40, 20));
+    REPORTER_ASSERT(r, draw->dst == SkRect::MakeXYWH(100, 0, 80, 40));
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    draw = assert_type<SkRecords::DrawImageRect>(r, record, 2);
+    REPORTER_ASSERT(r, *draw->src == SkRect::MakeXYWH(0, 20, 40, 20));
+    assert_type<SkRecords::NoOp>(r, record, 3);
+}
+
+static void draw_optimizable_scene(SkCanvas* canvas, SkImage* image) {
+    SkPaint translucent, aa;
+    translucent.setColor(0x8000FF00);
+    aa.setAntiAlias(true);
+
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 30, 30), aa);
+    canvas->drawOval(SkRect::MakeXYWH(20, 20, 30, 30), translucent);
+    canvas->drawRect(SkRect::MakeXYWH(15, 15, 50, 50), SkPaint());
+    canvas->save();
+        canvas->translate(5, 5);
+        canvas->translate(10, 0);
+        canvas->scale(0.5f, 0.5f);
+        canvas->clipRect(SkRect::MakeWH(150, 150));
+        canvas->clipRect(SkRect::MakeWH(120, 120));
+        for (int i = 0; i < 8; i++) {
+            canvas->drawRect(SkRect::MakeXYWH(i * 12, 0, 10, 10 + i), translucent);
+        }
+        for (int x = 0; x < 40; x += 10) {
+            canvas->drawImageRect(image, SkRect::MakeXYWH(x, 0, 10, 40),
+                                  SkRect::MakeXYWH(3*x, 50, 30, 120), nullptr);
+        }
+        canvas->clipRect(SkRect::MakeWH(10, 10));
+    canvas->restore();
+    canvas->drawCircle(80, 80, 15, aa);
+}
+
+DEF_TEST(RecordOpts_Optimize2DrawsTheSame, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(40, 40);
+    for (int y = 0; y < 40; y++) {
+        for (int x = 0; x < 40; x++) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(SkColorSetRGB(x * 6, y * 6, 0));
+        }
+    }
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+    SkRecord record, optimized;
+    SkRecorder recorder(&record, 100, 100), optimizedRecorder(&optimized, 100, 100);
+    draw_optimizable_scene(&recorder, image.get());
+    draw_optimizable_scene(&optimizedRecorder, image.get());
+
+    SkRecordOptStats stats;
+    SkRecordOptimize2(&optimized, &stats);
+    REPORTER_ASSERT(r, stats.fOpsBefore == record.count());
+    REPORTER_ASSERT(r, stats.fOpsAfter == optimized.count());
+    int removed = 0;
+    for (const SkRecordOptStats::Pass& pass : stats.fPasses) {
+        removed += pass.fOpsRemoved;
+    }
+    REPORTER_ASSERT(r, removed == stats.fOpsBefore - stats.fOpsAfter);
+    REPORTER_ASSERT(r, removed > 10);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 100);
+    actual.allocN32Pixels(100, 100);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected), actualCanvas(actual);
+    SkRecordDraw(record, &expectedCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    SkRecordDraw(optimized, &actualCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSafeSize()));
+}
@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkImageInfo.h"
 #include "SkRecord.h"
+#include "SkRecorder.h"
 #include "SkRecords.h"
 #include "SkShader.h"
 #include "Test.h"
@@ -61,7 +62,7 @@ DEF_TEST(Record, r) {
     // Add a simple DrawRect command.
     SkRect rect = SkRect::MakeWH(10, 10);
     SkPaint paint;
-    APPEND(record, SkRecords::DrawRect, paint, rect);
+    APPEND(record, SkRecords::DrawRect, record.internPaint(paint), rect);
 
     // Its area should be 100.
     AreaSummer summer;
@@ -116,3 +117,74 @@ DEF_TEST(Record_Alignment, r) {
         REPORTER_ASSERT(r, is_aligned(record.alloc<uint64_t>()));
     }
 }
+
+DEF_TEST(Record_InternsPaintsAndPaths, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1080);
+
+    SkPaint red, alsoRed, blue;
+    red.setColor(SK_ColorRED);
+    alsoRed.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    // Two equal small paths, built separately.
+    SkPath tri, alsoTri;
+    for (SkPath* path : { &tri, &alsoTri }) {
+        path->moveTo(0, 0);
+        path->lineTo(10, 0);
+        path->lineTo(0, 10);
+        path->close();
+    }
+    REPORTER_ASSERT(r, tri.getGenerationID() != alsoTri.getGenerationID());
+
+    recorder.drawRect(SkRect::MakeWH(10, 10), red);
+    recorder.drawRect(SkRect::MakeWH(20, 20), alsoRed);
+    recorder.drawRect(SkRect::MakeWH(30, 30), blue);
+    recorder.drawPath(tri, red);
+    recorder.drawPath(alsoTri, blue);
+
+    const SkPaint* paint0 = assert_type<SkRecords::DrawRect>(r, record, 0)->paint,
+                 * paint1 = assert_type<SkRecords::DrawRect>(r, record, 1)->paint,
+                 * paint2 = assert_type<SkRecords::DrawRect>(r, record, 2)->paint;
+    REPORTER_ASSERT(r, paint0 == paint1);
+    REPORTER_ASSERT(r, paint0 != paint2);
+    REPORTER_ASSERT(r, paint0->getColor() == SK_ColorRED);
+    REPORTER_ASSERT(r, paint2->getColor() == SK_ColorBLUE);
+
+    auto path3 = assert_type<SkRecords::DrawPath>(r, record, 3),
+         path4 = assert_type<SkRecords::DrawPath>(r, record, 4);
+    REPORTER_ASSERT(r, path3->paint == paint0);
+    REPORTER_ASSERT(r, path4->paint == paint2);
+    REPORTER_ASSERT(r, path3->path == tri);
+    REPORTER_ASSERT(r, path3->path.getGenerationID() == path4->path.getGenerationID());
+}
+
+DEF_TEST(Record_InternKeepsPathVolatility, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1080);
+
+    // Equal geometry, but only the non-volatile paths may share a copy.
+    SkPath tri;
+    tri.moveTo(0, 0);
+    tri.lineTo(10, 0);
+    tri.lineTo(0, 10);
+    tri.close();
+    SkPath volatileTri(tri);
+    volatileTri.setIsVolatile(true);
+    REPORTER_ASSERT(r, tri == volatileTri);
+
+    recorder.drawPath(volatileTri, SkPaint());
+    recorder.drawPath(tri, SkPaint());
+    recorder.drawPath(volatileTri, SkPaint());
+    recorder.drawPath(tri, SkPaint());
+
+    const SkPath& path0 = assert_type<SkRecords::DrawPath>(r, record, 0)->path,
+                & path1 = assert_type<SkRecords::DrawPath>(r, record, 1)->path,
+                & path2 = assert_type<SkRecords::DrawPath>(r, record, 2)->path,
+                & path3 = assert_type<SkRecords::DrawPath>(r, record, 3)->path;
+    REPORTER_ASSERT(r,  path0.isVolatile());
+    REPORTER_ASSERT(r, !path1.isVolatile());
+    REPORTER_ASSERT(r,  path2.isVolatile());
+    REPORTER_ASSERT(r, !path3.isVolatile());
+    REPORTER_ASSERT(r, path1.getGenerationID() == path3.getGenerationID());
+}
@@ -6,7 +6,11 @@
  */
 
 #include "Test.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkGradientShader.h"
 #include "SkHalf.h"
+#include "SkPM4f.h"
 #include "SkRasterPipeline.h"
 
 DEF_TEST(SkRasterPipeline, r) {
@@ -47,3 +51,181 @@ DEF_TEST(SkRasterPipeline_nonsense, r) {
     p.append(SkRasterPipeline::srcover);
     p.compile()(0, 20);
 }
+
+DEF_TEST(SkRasterPipeline_fused, r) {
+    // Pipelines we fuse into a single loop must draw exactly what their unfused forms draw,
+    // including in the tail.  This pipeline is what SkRasterPipelineBlitter uses for blitAntiH().
+    const int N = 11;
+    uint32_t fused[N], unfused[N];
+    for (int i = 0; i < N; i++) {
+        fused[i] = unfused[i] = 0x01010101 * (i * 23);
+    }
+
+    SkPM4f color = SkPM4f::From4f(Sk4f(0.25f, 0.5f, 0.0f, 0.75f));
+    float coverage = 0.6f;
+    void* dst_ctx;
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline::constant_color, &color);
+    p.append(SkRasterPipeline::load_d_srgb, &dst_ctx);
+    p.append(SkRasterPipeline::srcover);
+    p.append(SkRasterPipeline::lerp_constant_float, &coverage);
+    p.append(SkRasterPipeline::store_srgb, &dst_ctx);
+
+    dst_ctx = fused;
+    p.compile()(0, N);
+    dst_ctx = unfused;
+    p.compileUnfused()(0, N);
+
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, fused[i] == unfused[i]);
+    }
+}
+
+DEF_TEST(SkRasterPipeline_tail, r) {
+    // Copy n sRGB pixels for every n that exercises a tail, making sure
+    // we read and write exactly the pixels we're asked to, no more.
+    uint32_t src[16], dst[16];
+    for (int i = 0; i < 16; i++) {
+        src[i] = 0x01010101 * (i+1);
+    }
+
+    void* load_ctx  = src;
+    void* store_ctx = dst;
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline::load_s_srgb, &load_ctx);
+    p.append(SkRasterPipeline::store_srgb,  &store_ctx);
+    auto fn = p.compile();
+
+    for (int n = 0; n <= 16; n++) {
+        for (int i = 0; i < 16; i++) {
+            dst[i] = 0xdeadbeef;
+        }
+        fn(0, n);
+        for (int i = 0; i < 16; i++) {
+            REPORTER_ASSERT(r, dst[i] == (i < n ? src[i] : 0xdeadbeef));
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_lowp, r) {
+    // A legacy 8888 srcover pipeline runs in low precision.  It should still be within 1 of
+    // the exact answer in every channel, including in the tail.
+    const int N = 11;
+    uint32_t src[N], dst[N];
+    uint8_t mask[N];
+    for (int i = 0; i < N; i++) {
+        uint8_t a = (uint8_t)(i * 25),
+                c = (uint8_t)(i * 20);
+        src[i]  = SkPackARGB32(a, c, c/2, c/4);
+        dst[i]  = SkPackARGB32(0xff, 0x40, 0x80, 0xc0);
+        mask[i] = (uint8_t)(255 - i*23);
+    }
+    const uint32_t orig[N] = { dst[0], dst[1], dst[2], dst[3], dst[4], dst[5],
+                               dst[6], dst[7], dst[8], dst[9], dst[10] };
+
+    void* src_ctx  = src;
+    void* dst_ctx  = dst;
+    void* mask_ctx = mask;
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline::load_s_8888, &src_ctx);
+    p.append(SkRasterPipeline::load_d_8888, &dst_ctx);
+    p.append(SkRasterPipeline::srcover);
+    p.append(SkRasterPipeline::lerp_u8, &mask_ctx);
+    p.append(SkRasterPipeline::store_8888, &dst_ctx);
+    p.compile()(0, N);
+
+    for (int i = 0; i < N; i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            float s = (src [i] >> shift) & 0xff,
+                  d = (orig[i] >> shift) & 0xff,
+                  a = SkGetPackedA32(src[i]),
+                  c = mask[i] * (1/255.0f);
+            float over = s + d * (1 - a * (1/255.0f)),
+                  want = over * c + d * (1 - c);
+            int got = (dst[i] >> shift) & 0xff;
+            REPORTER_ASSERT(r, SkTAbs(got - want) <= 1.0f);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_gradient, r) {
+    // A two-interval gradient over x in [0,10), with a hard stop at t = 0.5:
+    // (t,0,0,1) below it and (0,t,0,1) above.
+    const int N = 10;
+    uint64_t dst[N];
+
+    const float ts[] = { 0.0f, 0.5f },
+                fs[] = { 1,0,0,0,  0,1,0,0 },
+                bs[] = { 0,0,0,1,  0,0,0,1 };
+    SkRasterPipeline::GradientCtx gradient = { 2, ts, fs, bs };
+
+    int y = 0;
+    const float matrix[] = { 0.1f,0, 0,1, 0,0 },  // SkMatrix::asAffine() order.
+                one = 1.0f;
+    void* dst_ctx = dst;
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline::seed_shader, &y);
+    p.append(SkRasterPipeline::matrix_2x3, matrix);
+    p.append(SkRasterPipeline::clamp_x, &one);
+    p.append(SkRasterPipeline::gradient, &gradient);
+    p.append(SkRasterPipeline::store_f16, &dst_ctx);
+    p.compile()(0, N);
+
+    for (int i = 0; i < N; i++) {
+        float t = (i + 0.5f) / N,
+              R = SkHalfToFloat((dst[i] >>  0) & 0xffff),
+              G = SkHalfToFloat((dst[i] >> 16) & 0xffff),
+              A = SkHalfToFloat((dst[i] >> 48) & 0xffff);
+        REPORTER_ASSERT(r, SkTAbs(R - (t < 0.5f ? t : 0)) < 0.002f);
+        REPORTER_ASSERT(r, SkTAbs(G - (t < 0.5f ? 0 : t)) < 0.002f);
+        REPORTER_ASSERT(r, A == 1.0f);
+    }
+}
+
+DEF_TEST(SkRasterPipeline_shaders, r) {
+    // F16 destinations always draw through SkRasterPipelineBlitter, shaders included.
+    const int N = 10;
+    SkBitmap dst;
+    dst.allocPixels(SkImageInfo::Make(N, 1, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    SkCanvas canvas(dst);
+    canvas.clear(SK_ColorTRANSPARENT);
+
+    const SkPoint pts[] = { {0, 0}, {N, 0} };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    canvas.drawPaint(paint);
+
+    SkPixmap pm;
+    SkAssertResult(dst.peekPixels(&pm));
+    for (int i = 0; i < N; i++) {
+        uint64_t px = *pm.addr64(i, 0);
+        float t = (i + 0.5f) / N;
+        REPORTER_ASSERT(r, SkTAbs(SkHalfToFloat((px >>  0) & 0xffff) - (1 - t)) < 0.002f);
+        REPORTER_ASSERT(r, SkTAbs(SkHalfToFloat((px >> 32) & 0xffff) - (    t)) < 0.002f);
+        REPORTER_ASSERT(r, SkHalfToFloat((px >> 48) & 0xffff) == 1.0f);
+    }
+
+    // Unfiltered, untransformed images copy their pixels exactly, tiling included.
+    SkBitmap src, dst565;
+    src.allocPixels(SkImageInfo::Make(4, 1, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    dst565.allocPixels(SkImageInfo::Make(N, 1, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    for (int i = 0; i < 4; i++) {
+        *src.getAddr16(i, 0) = (uint16_t)(0x1234 * (i+1));
+    }
+    src.setImmutable();
+
+    paint.setShader(SkShader::MakeBitmapShader(src, SkShader::kRepeat_TileMode,
+                                                    SkShader::kRepeat_TileMode));
+    SkCanvas canvas565(dst565);
+    canvas565.drawPaint(paint);
+
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, *dst565.getAddr16(i, 0) == *src.getAddr16(i % 4, 0));
+    }
+}
@@ -1018,3 +1018,111 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceCreationWithColorSpace_Gpu, reporter,
     }
 }
 #endif
+
+// Everything here rasterizes identically no matter how the device is tiled.
+static void draw_threaded_test_scene(SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    canvas->clear(SK_ColorWHITE);
+
+    // Shapes that straddle many tiles.
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 500, 300), paint);
+    paint.setColor(0x8000FF00);
+    canvas->drawRect(SkRect::MakeXYWH(100.5f, 50.25f, 600, 400), paint);
+
+    // A clip and a matrix.
+    canvas->save();
+        canvas->clipRect(SkRect::MakeXYWH(240, 240, 300, 200));
+        canvas->translate(30, 40);
+        canvas->scale(2, 2);
+        paint.setColor(0xC0FF00FF);
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 150, 150), paint);
+    canvas->restore();
+
+    // A bitmap we change right after drawing it.
+    SkBitmap bm;
+    bm.allocN32Pixels(50, 50);
+    bm.eraseColor(SK_ColorCYAN);
+    canvas->drawBitmap(bm, 300, 20);
+    bm.eraseColor(SK_ColorYELLOW);
+
+    // A layer.  Its contents are drawn immediately; only its composite is deferred.
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    canvas->saveLayer(nullptr, &layerPaint);
+        paint.setColor(SK_ColorBLACK);
+        canvas->drawCircle(400, 400, 120, paint);
+    canvas->restore();
+
+    paint.setColor(SK_ColorBLACK);
+    paint.setTextSize(40);
+    canvas->drawText("threaded", 8, 30, 550, paint);
+}
+
+static void draw_threaded_test_paths(SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    canvas->clear(SK_ColorWHITE);
+    paint.setColor(0x8000FF00);
+    canvas->drawOval(SkRect::MakeXYWH(100, 50, 600, 400), paint);
+
+    canvas->rotate(15);
+    SkPath path;
+    path.moveTo(0, 0);
+    path.cubicTo(600, 100, 100, 500, 700, 600);
+    path.close();
+    paint.setColor(0xC0FF00FF);
+    canvas->drawPath(path, paint);
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawCircle(350, 300, 200, paint);
+}
+
+static void read_threaded_and_raster(void (*draw)(SkCanvas*), SkBitmap* expected,
+                                     SkBitmap* actual) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(700, 600);
+
+    auto raster   = SkSurface::MakeRaster(info);
+    auto threaded = SkSurface::MakeRasterThreaded(info);
+    draw(raster->getCanvas());
+    draw(threaded->getCanvas());
+
+    expected->allocPixels(info);
+    actual->allocPixels(info);
+    SkAssertResult(raster->readPixels(info, expected->getPixels(), expected->rowBytes(), 0, 0));
+    SkAssertResult(threaded->readPixels(info, actual->getPixels(), actual->rowBytes(), 0, 0));
+}
+
+DEF_TEST(SurfaceThreaded_MatchesRaster, reporter) {
+    SkBitmap expected, actual;
+    read_threaded_and_raster(draw_threaded_test_scene, &expected, &actual);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSafeSize()));
+
+    // Anti-aliased paths crossing tile boundaries must not show the seams.
+    read_threaded_and_raster(draw_threaded_test_paths, &expected, &actual);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSafeSize()));
+}
+
+DEF_TEST(SurfaceThreaded_Snapshot, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(700, 600);
+    auto threaded = SkSurface::MakeRasterThreaded(info);
+    REPORTER_ASSERT(reporter, threaded);
+
+    // Drawing after a snapshot must not affect the snapshot.
+    threaded->getCanvas()->clear(SK_ColorRED);
+    sk_sp<SkImage> before = threaded->makeImageSnapshot();
+    threaded->getCanvas()->clear(SK_ColorGREEN);
+    SkPixmap pm;
+    REPORTER_ASSERT(reporter, before->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, *pm.addr32(0, 0) == SkPreMultiplyColor(SK_ColorRED));
+    sk_sp<SkImage> after = threaded->makeImageSnapshot();
+    REPORTER_ASSERT(reporter, after->peekPixels(&pm));
+    REPORTER_ASSERT(reporter, *pm.addr32(0, 0) == SkPreMultiplyColor(SK_ColorGREEN));
+}
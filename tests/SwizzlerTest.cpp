@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkCodecPriv.h"
+#include "SkMasks.h"
+#include "SkRandom.h"
 #include "SkSwizzle.h"
 #include "SkSwizzler.h"
 #include "Test.h"
@@ -159,6 +162,82 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+DEF_TEST(SwizzleOpts_index, r) {
+    SkRandom rand;
+    uint32_t table[256];
+    for (int i = 0; i < 256; i++) {
+        table[i] = rand.nextU();
+    }
+
+    // An odd count makes sure the tail is handled.
+    uint8_t src[1023];
+    for (uint8_t& index : src) {
+        index = rand.nextU() & 0xFF;
+    }
+
+    uint32_t dst[SK_ARRAY_COUNT(src)];
+    SkOpts::index_to_8888(dst, src, SK_ARRAY_COUNT(src), table);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(src); i++) {
+        REPORTER_ASSERT(r, dst[i] == table[src[i]]);
+    }
+}
+
+// The SkOpts masked swizzles must match SkMasks, which SkMaskSwizzler uses when sampling.
+template <typename Pixel>
+static void test_masked_swizzles(skiatest::Reporter* r, const SkMasks::InputMasks& inputMasks,
+                                 SkOpts::Swizzle_masked opaque, SkOpts::Swizzle_masked unpremul,
+                                 SkOpts::Swizzle_masked premul) {
+    SkAutoTDelete<SkMasks> masks(SkMasks::CreateMasks(inputMasks, 8 * sizeof(Pixel)));
+    REPORTER_ASSERT(r, masks);
+    const uint32_t rgba[4] = { masks->getRedMask(), masks->getGreenMask(),
+                               masks->getBlueMask(), masks->getAlphaMask() };
+
+    SkRandom rand;
+    Pixel src[1023];
+    for (Pixel& p : src) {
+        p = (Pixel) rand.nextU();
+    }
+    const int count = SK_ARRAY_COUNT(src);
+
+    uint32_t dstOpaque[count], dstUnpremul[count], dstPremul[count];
+    opaque  (dstOpaque,   src, count, rgba);
+    unpremul(dstUnpremul, src, count, rgba);
+    premul  (dstPremul,   src, count, rgba);
+    for (int i = 0; i < count; i++) {
+        const uint8_t red   = masks->getRed(src[i]),
+                      green = masks->getGreen(src[i]),
+                      blue  = masks->getBlue(src[i]),
+                      alpha = masks->getAlpha(src[i]);
+        REPORTER_ASSERT(r, dstOpaque[i]   == SkPackARGB_as_RGBA(0xFF, red, green, blue));
+        REPORTER_ASSERT(r, dstUnpremul[i] == SkPackARGB_as_RGBA(alpha, red, green, blue));
+        REPORTER_ASSERT(r, dstPremul[i]   == premultiply_argb_as_rgba(alpha, red, green, blue));
+    }
+}
+
+DEF_TEST(SwizzleOpts_masked, r) {
+    const SkMasks::InputMasks masks16[] = {
+        { 0xF800, 0x07E0, 0x001F, 0x0000 },  // 565
+        { 0x7C00, 0x03E0, 0x001F, 0x8000 },  // 1555
+        { 0x0F00, 0x00F0, 0x000F, 0xF000 },  // 4444
+        { 0x000F, 0x00F0, 0x0F00, 0x0000 },  // 444, in the other order
+    };
+    for (const auto& m : masks16) {
+        test_masked_swizzles<uint16_t>(r, m, SkOpts::mask16_to_RGB1, SkOpts::mask16_to_RGBA,
+                                       SkOpts::mask16_to_rgbA);
+    }
+
+    const SkMasks::InputMasks masks32[] = {
+        { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 },  // 8888
+        { 0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF },  // alpha at the bottom
+        { 0x3FF00000, 0x000FFC00, 0x000003FF, 0xC0000000 },  // 2:10:10:10, truncated to 8 bits
+        { 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000 },
+    };
+    for (const auto& m : masks32) {
+        test_masked_swizzles<uint32_t>(r, m, SkOpts::mask32_to_RGB1, SkOpts::mask32_to_RGBA,
+                                       SkOpts::mask32_to_rgbA);
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "Test.h"
+
+DEF_TEST(SkTaskGroup_Batch, r) {
+    const int N = 10000;
+    SkTDArray<int> ran;
+    ran.setCount(N);
+    sk_bzero(ran.begin(), N * sizeof(int));
+
+    SkTaskGroup tg;
+    tg.batch(N, [&](int i) { ran[i]++; });
+    tg.wait();
+
+    // Every index should have run exactly once.
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, ran[i] == 1);
+    }
+
+    // The SkTaskGroup should be reusable after wait().
+    tg.batch(N, [&](int i) { ran[i]++; });
+    tg.wait();
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, ran[i] == 2);
+    }
+}
+
+DEF_TEST(SkTaskGroup_Add, r) {
+    SkAtomic<int> count(0);
+    {
+        SkTaskGroup tg;
+        for (int i = 0; i < 5000; i++) {
+            tg.add([&] { count.fetch_add(1); });
+        }
+    }   // ~SkTaskGroup() waits.
+    REPORTER_ASSERT(r, count.load() == 5000);
+}
+
+DEF_TEST(SkTaskGroup_Nested, r) {
+    // Tasks that add tasks and wait on them must not deadlock, even with many more tasks
+    // waiting than there are threads in the pool.
+    SkAtomic<int> count(0);
+    SkTaskGroup outer;
+    outer.batch(64, [&](int) {
+        SkTaskGroup middle;
+        middle.batch(16, [&](int) {
+            SkTaskGroup inner;
+            for (int i = 0; i < 4; i++) {
+                inner.add([&] { count.fetch_add(1); });
+            }
+            inner.wait();
+        });
+        middle.wait();
+    });
+    outer.wait();
+    REPORTER_ASSERT(r, count.load() == 64*16*4);
+}
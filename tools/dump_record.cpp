@@ -73,7 +73,12 @@ int tool_main(int argc, char** argv) {
             SkRecordOptimize(&record);
         }
         if (FLAGS_optimize2) {
-            SkRecordOptimize2(&record);
+            SkRecordOptStats stats;
+            SkRecordOptimize2(&record, &stats);
+            printf("%d ops -> %d ops\n", stats.fOpsBefore, stats.fOpsAfter);
+            for (const SkRecordOptStats::Pass& pass : stats.fPasses) {
+                printf("  %-28s %d\n", pass.fName, pass.fOpsRemoved);
+            }
         }
 
         dump(FLAGS_skps[i], w, h, record);
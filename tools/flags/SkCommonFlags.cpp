@@ -66,6 +66,8 @@ DEFINE_string(properties, "",
 DEFINE_bool2(pre_log, p, false, "Log before running each test. May be incomprehensible when threading");
 
 DEFINE_bool(analyticAA, false, "Analytic Anati-Alias");
+DEFINE_bool(parallelScan, false, "Scan convert large filled paths in parallel horizontal bands.");
+DEFINE_bool(pathMaskCache, false, "Draw small anti-aliased paths through cached coverage masks.");
 
 bool CollectImages(SkCommandLineFlags::StringArray images, SkTArray<SkString>* output) {
     SkASSERT(output);
@@ -33,6 +33,8 @@ DECLARE_bool(veryVerbose);
 DECLARE_string(writePath);
 DECLARE_bool(pre_log);
 DECLARE_bool(analyticAA);
+DECLARE_bool(parallelScan);
+DECLARE_bool(pathMaskCache);
 
 DECLARE_string(key);
 DECLARE_string(properties);
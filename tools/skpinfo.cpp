@@ -8,6 +8,7 @@
 #include "SkCommandLineFlags.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
+#include "SkReadBuffer.h"
 #include "SkStream.h"
 #include "SkFontDescriptor.h"
 
@@ -87,7 +88,8 @@ int tool_main(int argc, char** argv) {
         SkDebugf("\n");
     }
 
-    if (!stream.readBool()) {
+    const bool aligned = info.getVersion() >= SkReadBuffer::kAlignedPictureSections_Version;
+    if (!(aligned ? stream.readU32() : stream.readBool())) {
         // If we read true there's a picture playback object flattened
         // in the file; if false, there isn't a playback, so we're done
         // reading the file.
@@ -122,6 +124,11 @@ int tool_main(int argc, char** argv) {
                 SkDebugf("SK_PICT_READER_TAG %d\n", chunkSize);
             }
             break;
+        case SK_PICT_BBH_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_BBH_TAG %d\n", chunkSize);
+            }
+            break;
         case SK_PICT_FACTORY_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_FACTORY_TAG %d\n", chunkSize);
@@ -132,6 +139,12 @@ int tool_main(int argc, char** argv) {
                 SkDebugf("SK_PICT_TYPEFACE_TAG %d\n", chunkSize);
             }
 
+            if (aligned) {
+                // The typefaces' size in bytes follows their count.
+                chunkSize = stream.readU32();
+                break;
+            }
+
             const int count = SkToInt(chunkSize);
             for (int i = 0; i < count; i++) {
                 SkFontDescriptor desc;
@@ -147,13 +160,38 @@ int tool_main(int argc, char** argv) {
             chunkSize = 0;
             break;
         }
-        case SK_PICT_PICTURE_TAG:
+        case SK_PICT_PICTURE_TAG: {
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_PICTURE_TAG %d\n", chunkSize);
-                SkDebugf("Exiting early due to format limitations\n");
             }
-            return kSuccess;       // TODO: need to store size in bytes
+            if (info.getVersion() < SkReadBuffer::kLazySubPictures_Version) {
+                if (FLAGS_tags && !FLAGS_quiet) {
+                    SkDebugf("Exiting early due to format limitations\n");
+                }
+                return kSuccess;
+            }
+
+            // Each sub-picture's size in bytes, op count, slow path count and whether it has
+            // bitmaps precede it.
+            const int count = SkToInt(chunkSize);
+            for (int i = 0; i < count; i++) {
+                const uint32_t length = stream.readU32();
+                const uint32_t opCount = stream.readU32();
+                (void)stream.readU32();     // slow paths
+                (void)stream.readU32();     // has bitmaps
+                if (FLAGS_tags && !FLAGS_quiet) {
+                    SkDebugf("    sub-picture %d: %d bytes, %d ops\n", i, length, opCount);
+                }
+                if (!stream.move(length)) {
+                    if (!FLAGS_quiet) {
+                        SkDebugf("seek error\n");
+                    }
+                    return kTruncatedFile;
+                }
+            }
+            chunkSize = 0;
             break;
+        }
         case SK_PICT_BUFFER_SIZE_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_BUFFER_SIZE_TAG %d\n", chunkSize);